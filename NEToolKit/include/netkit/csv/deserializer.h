@@ -13,6 +13,9 @@ class deserializer {
 	template<typename T>
 	void get_next(T& var);
 
+	// reads a field of exactly length characters, separators and whitespaces included.
+	void get_next(std::string& var, size_t length);
+
 	void skip_line();
 	void close();
 
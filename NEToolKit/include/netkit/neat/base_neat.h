@@ -2,17 +2,32 @@
 
 #include <optional>
 #include <random>
+#include <memory>
 
 #include "netkit/csv/serializer.h"
 #include "netkit/csv/deserializer.h"
+#include "netkit/profiling/epoch_timings.h"
+#include "netkit/profiling/memory_report.h"
+#include "netkit/profiling/metrics_exporter.h"
+#include "netkit/utils/ring_buffer.h"
 #include "parameters.h"
 #include "innovation_pool.h"
 #include "species.h"
 #include "organism.h"
+#include "generation_stats.h"
+#include "epoch_observer.h"
 
 namespace netkit {
 class base_population; // forward declaration
 
+// a switch of the phased search (see parameters::phased_search).
+struct search_phase_transition {
+	uint64_t epoch;
+	search_phase_t phase; // the new one
+	double mean_genome_size; // genes
+	double best_fitness; // of the population
+};
+
 class base_neat {
   public:
 	explicit base_neat(const parameters& params);
@@ -30,12 +45,15 @@ class base_neat {
 	void epoch();
 
 	std::vector<species>& get_all_species() { return m_all_species; }
+	const std::vector<species>& get_all_species() const { return m_all_species; }
 
 	std::optional<species*> find_appropriate_species_for(const genome& geno);
 
 	const genome& get_current_best_genome() const;
 
 	std::optional<genome> get_best_genome_ever() const;
+	bool has_best_genome_ever() const { return m_best_genome_ever != nullptr; }
+	double get_best_fitness_ever() const { return m_best_genome_ever != nullptr ? m_best_genome_ever->get_raw_fitness() : 0; }
 
 	const std::vector<genome>& get_best_genomes_library() { return m_best_genomes_library; }
 
@@ -50,6 +68,43 @@ class base_neat {
 	// Call once per generation when population is rated.
 	void update_best_genome_ever();
 
+	// durations of the phases of the last epoch. Only filled if params.record_epoch_timings is set.
+	const epoch_timings& get_last_epoch_timings() const { return m_last_epoch_timings; }
+
+	// the timings being recorded, nullptr if the instrumentation is disabled or outside of an epoch.
+	epoch_timings* current_timings() { return m_recording_timings ? &m_last_epoch_timings : nullptr; }
+
+	// memory footprint of the whole instance (iterates over every genome).
+	virtual neat_memory_report memory_usage() const;
+
+	// snapshot taken at the end of the last epoch. Only filled if params.record_memory_usage is set.
+	const neat_memory_report& get_last_memory_usage() const { return m_last_memory_usage; }
+
+	// one row per epoch (rtNEAT: per replacement). Only filled if params.record_generation_stats is set.
+	// See write_generation_stats_csv and write_generation_stats_binary to export it.
+	const ring_buffer<generation_stats>& get_stats_history() const { return m_stats_history; }
+
+	// the current phase of the phased search and its transitions so far (see parameters::phased_search).
+	// The phase is serialized: a deserialized instance resumes it, pruning probabilities included.
+	search_phase_t get_search_phase() const { return m_search_phase; }
+	const std::vector<search_phase_transition>& get_search_phase_log() const { return m_search_phase_log; }
+
+	// the observers are not owned and must outlive their registration.
+	// /!\ needs NETKIT_WITH_OBSERVERS (see observers_enabled), otherwise adding an observer throws.
+	void add_observer(epoch_observer* observer);
+	void remove_observer(epoch_observer* observer);
+
+	// publish the metrics at the end of every epoch. The exporter is not owned (nullptr to detach).
+	void set_metrics_exporter(metrics_exporter* exporter) { m_metrics_exporter = exporter; }
+
+	// used by NETKIT_NOTIFY.
+	template<typename callback_t, typename... args_t>
+	void notify_observers(callback_t callback, const args_t& ... args) const {
+		for (epoch_observer* observer : m_observers) {
+			(observer->*callback)(*this, args...);
+		}
+	}
+
   protected:
 	void helper_speciate_all_population();
 
@@ -58,6 +113,16 @@ class base_neat {
 	// update only if applicable.
 	void helper_update_best_genomes_library_with(const genome& geno);
 
+	// sum up the stats of the species into the stats row of the epoch. Call it right after their update_stats.
+	void helper_record_generation_stats();
+
+	// replace the fitness of every genome of the population by its NSGA-II rank score.
+	void helper_rank_by_objectives();
+
+	// switch the phase of the phased search if needed, from the rated population.
+	void helper_update_search_phase();
+	void helper_switch_search_phase(search_phase_t phase, double mean_genome_size, double best_fitness);
+
 	void helper_serialize_base_neat(serializer& ser) const;
 
 	void helper_deserialize_base_neat(deserializer& des);
@@ -71,6 +136,10 @@ class base_neat {
   public:
 	parameters params;
 	innovation_pool innov_pool;
+
+	// version of the serialized instances. The instances written without a version (the original layout, without the
+	// phased search state) can still be read and complexify.
+	static const unsigned int SERIALIZATION_VERSION;
 	std::minstd_rand0 rand_engine;
 
   protected:
@@ -79,5 +148,29 @@ class base_neat {
 	species_id_t m_next_species_id;
 	genome* m_best_genome_ever;
 	unsigned int m_age_of_best_genome_ever;
+	epoch_timings m_last_epoch_timings;
+	bool m_recording_timings;
+	std::unique_ptr<perf_counters> m_hardware_counters; // opened on the first epoch which needs them
+	neat_memory_report m_last_memory_usage;
+	ring_buffer<generation_stats> m_stats_history;
+	generation_stats m_pending_stats; // the row of the current epoch
+	bool m_has_pending_stats;
+	uint64_t m_number_of_epochs;
+	std::vector<epoch_observer*> m_observers;
+	metrics_exporter* m_metrics_exporter; // evaluations are counted by the instances generating the organisms
+
+	// phased search
+	search_phase_t m_search_phase;
+	std::vector<search_phase_transition> m_search_phase_log;
+	// the mutation and crossover probabilities saved during a pruning phase
+	std::vector<double> m_complexification_probs;
+	double m_complexification_crossover_prob;
+	double m_complexification_interspecies_crossover_prob;
+	double m_complexity_ceiling; // mean genome size triggering a pruning phase (-1 = not set yet)
+	double m_lowest_mean_genome_size; // of the pruning phase
+	unsigned int m_epochs_since_size_decrease;
+	double m_best_fitness_seen;
+	unsigned int m_epochs_since_fitness_improvement;
+
 };
 }
@@ -2,6 +2,7 @@
 
 #include <vector>
 
+#include "netkit/profiling/memory_report.h"
 #include "genome.h"
 #include "neat_primitive_types.h"
 
@@ -24,6 +25,9 @@ class base_population {
 	size_t size() const { return m_all_genomes.size(); }
 	const std::vector<genome>& get_all_genomes() const { return m_all_genomes; }
 
+	// the genomes and their own memory.
+	virtual memory_report memory_usage() const;
+
   protected:
 	std::vector<genome> m_all_genomes;
 	base_neat* m_neat;
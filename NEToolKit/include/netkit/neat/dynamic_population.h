@@ -26,6 +26,9 @@ class dynamic_population : public base_population {
 	void replace_genome(genome_id_t id, genome geno);
 	void mark_genome_for_removal(genome_id_t geno_id);
 
+	// also counts the removal marks as overhead.
+	memory_report memory_usage() const override;
+
   private:
 	std::vector<bool> m_marked_for_removal;
 	genome_id_t m_lookup_genome_id;
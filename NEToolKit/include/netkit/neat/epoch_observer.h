@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "neat_primitive_types.h"
+
+namespace netkit {
+// forward declarations
+class base_neat;
+class species;
+class genome;
+class innovation;
+struct search_phase_transition;
+
+// callbacks on the events of the evolution (see base_neat::add_observer). Override the ones you need.
+// The notifications only exist when built with NETKIT_WITH_OBSERVERS: otherwise NETKIT_NOTIFY expands
+// to nothing and the hot paths don't pay anything at all.
+// Callbacks are called synchronously from the epoch, in the middle of it: don't modify the neat instance.
+class epoch_observer {
+  public:
+	virtual ~epoch_observer() = default;
+
+	virtual void on_species_created(const base_neat& /*neat*/, const species& /*spec*/) {}
+	// the species is about to be removed
+	virtual void on_species_extinct(const base_neat& /*neat*/, const species& /*spec*/) {}
+	virtual void on_new_innovation(const base_neat& /*neat*/, const innovation& /*innov*/) {}
+	virtual void on_champion_improved(const base_neat& /*neat*/, const genome& /*champion*/) {} // new best genome ever
+	virtual void on_replacement(const base_neat& /*neat*/, genome_id_t /*replaced_genome_id*/) {} // rtNEAT only
+	virtual void on_epoch_completed(const base_neat& /*neat*/, uint64_t /*epoch_index*/) {}
+	virtual void on_search_phase_changed(const base_neat& /*neat*/, const search_phase_transition& /*transition*/) {}
+};
+
+// returns true if the library has been built with NETKIT_WITH_OBSERVERS.
+bool observers_enabled();
+}
+
+// NETKIT_NOTIFY(neat_ptr, event, args...) calls event(*neat_ptr, args...) on every observer of neat_ptr.
+#ifdef NETKIT_WITH_OBSERVERS
+#define NETKIT_NOTIFY(neat, event, ...) (neat)->notify_observers(&netkit::epoch_observer::event, __VA_ARGS__)
+#else
+#define NETKIT_NOTIFY(neat, event, ...) ((void)0)
+#endif
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <functional>
+#include <cstdint>
+
+#include "netkit/csv/serializer.h"
+#include "parameters.h"
+
+namespace netkit {
+class neat; // forward declaration
+
+// outcome of one complete evolution. Trivially copyable (64 bytes) so that it can be streamed as is.
+struct experiment_result {
+	uint64_t configuration; // index of the parameters in the grid
+	uint64_t run; // index of the run for these parameters
+	uint64_t seed; // of the NEAT instance random engine: the run can be replayed with it
+	uint64_t generations; // number of generations rated (the last one included)
+	double best_fitness; // fitness of the best genome ever
+	double seconds;
+	uint32_t best_genome_size; // number of genes of the best genome ever
+	uint32_t success; // 1 if the run has been solved before the maximum number of generations, 0 otherwise
+	uint64_t number_of_species; // at the end of the run
+};
+
+// receives the results as soon as the runs are done (in completion order, not in grid order).
+// Calls are serialized by the runner: a sink doesn't need to be thread safe.
+class experiment_sink {
+  public:
+	virtual ~experiment_sink() = default;
+	virtual void write(const experiment_result& result) = 0;
+};
+
+// one CSV line per run (with a header line).
+class csv_experiment_sink : public experiment_sink {
+  public:
+	explicit csv_experiment_sink(const std::string& filename);
+	void write(const experiment_result& result) override;
+
+  private:
+	serializer m_ser;
+};
+
+// one raw record per run after a small header (see read_experiment_results_binary).
+// The file is only meant to be read back on the same architecture.
+class binary_experiment_sink : public experiment_sink {
+  public:
+	explicit binary_experiment_sink(const std::string& filename);
+	void write(const experiment_result& result) override;
+
+  private:
+	std::ofstream m_file;
+	std::string m_filename;
+};
+
+std::vector<experiment_result> read_experiment_results_binary(const std::string& filename);
+
+// aggregated results of all the runs of one configuration. Its size doesn't depend on the number of runs:
+// the generations of the successful runs are counted in a histogram (one bin per generation).
+struct experiment_summary {
+	explicit experiment_summary(size_t max_generations = 0);
+
+	void add(const experiment_result& result);
+
+	double success_rate() const;
+	double mean_best_fitness() const;
+	double mean_seconds() const;
+	// generations needed by the successful runs (0 if none).
+	double mean_generations() const;
+	uint64_t generations_quantile(double q) const; // nearest rank, q in [0, 1]
+
+	uint64_t number_of_runs;
+	uint64_t number_of_successes;
+	double summed_best_fitness;
+	double summed_seconds;
+	std::vector<uint64_t> successes_per_generation; // index: number of generations of the successful run
+};
+
+// rates all the organisms of the current generation of the instance and returns true if the problem is solved.
+// /!\ called concurrently by the runner (on different instances): it must not share unprotected state.
+using experiment_rating_function = std::function<bool(neat& neat)>;
+
+struct experiment_options {
+	size_t runs_per_configuration = 10;
+	size_t max_generations = 100;
+	uint64_t base_seed = 42; // the seed of each run is derived from it (see experiment_seed)
+	size_t number_of_threads = 0; // 0: one thread per hardware thread
+};
+
+// deterministic and well spread seed of a run: the same base seed always yields the same runs,
+// regardless of the number of threads and of the order the runs are performed in.
+uint64_t experiment_seed(uint64_t base_seed, size_t configuration, size_t run);
+
+// run options.runs_per_configuration independent evolutions of each configuration of the grid, concurrently.
+// A run seeds its instance with experiment_seed, initializes it and then alternates the rating of the generation
+// and the epoch until the rating function reports a solution or options.max_generations generations are rated.
+// Each result is written to the sink (if any) as soon as the run is done, so the memory used doesn't depend
+// on the number of runs. Returns the summary of each configuration, in the grid order.
+std::vector<experiment_summary> run_experiments(const std::vector<parameters>& configurations,
+												const experiment_options& options,
+												const experiment_rating_function& rate,
+												experiment_sink* sink = nullptr);
+}
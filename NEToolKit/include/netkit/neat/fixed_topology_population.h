@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <random>
+
+#include "netkit/network/compiled_network.h"
+#include "netkit/profiling/memory_report.h"
+#include "genome.h"
+#include "parameters.h"
+
+namespace netkit {
+// weight-only evolution of a fixed topology, once the topology search is over: no genes, no speciation
+// and no network generation. The topology of the champion genome is compiled once and the population is
+// a contiguous weights matrix [size() x number_of_weights()], one row per individual (compiled order).
+// The weights are evolved by a genetic algorithm or an evolution strategy (see parameters::weight_search).
+//
+// usage: rate every row, then call epoch().
+//     std::vector<neuron_value_t> values; // scratch neuron values, one per thread
+//     for (size_t i = 0; i < pop.size(); ++i) {
+//         auto outputs = pop.get_topology().evaluate(pop.get_weights(i), inputs, values);
+//         pop.set_fitness(i, ...);
+//     }
+//     pop.epoch();
+class fixed_topology_population {
+  public:
+	// /!\ the NEAT instance of the champion must outlive the population (see get_genome).
+	// The random engine is seeded from the clock, or with the given seed so that a run can be replayed (the first
+	// generation is already drawn by the constructor: seeding rand_engine afterwards is too late).
+	fixed_topology_population(const genome& champion, const parameters& params_);
+	fixed_topology_population(const genome& champion, const parameters& params_, uint64_t seed);
+
+	size_t size() const { return m_fitnesses.size(); }
+	size_t number_of_weights() const { return m_topology.number_of_links(); }
+	const compiled_network& get_topology() const { return m_topology; }
+
+	neuron_value_t* get_weights(size_t i) { return m_weights.data() + i * number_of_weights(); }
+	const neuron_value_t* get_weights(size_t i) const { return m_weights.data() + i * number_of_weights(); }
+
+	void set_fitness(size_t i, double fitness) { m_fitnesses[i] = fitness; }
+	double get_fitness(size_t i) const { return m_fitnesses[i]; }
+
+	// produce the next generation from the rated one.
+	void epoch();
+	unsigned int get_generation() const { return m_generation; }
+
+	// the best weights rated so far (updated by epoch), the champion weights before.
+	const std::vector<neuron_value_t>& get_best_weights_ever() const { return m_best_weights; }
+	double get_best_fitness_ever() const { return m_best_fitness; }
+
+	// a copy of the champion with the weights of the row i (or the best ones).
+	genome get_genome(size_t i) const;
+	genome get_best_genome_ever() const;
+
+	// the step size of the evolution strategy (0 for the genetic search).
+	double get_sigma() const { return m_sigma; }
+
+	memory_report memory_usage() const;
+
+  public:
+	parameters params;
+	std::minstd_rand0 rand_engine;
+
+  private:
+	void helper_update_best_ever();
+	std::vector<size_t> helper_ranking() const; // row indices, best first
+
+	void helper_genetic_epoch();
+	void helper_perturbate(neuron_value_t* row, double rate, double power);
+
+	void helper_evolution_strategy_init();
+	void helper_evolution_strategy_epoch();
+	void helper_evolution_strategy_sample();
+
+	genome helper_genome_from(const neuron_value_t* weights) const;
+
+  private:
+	genome m_champion;
+	compiled_network m_topology;
+
+	std::vector<neuron_value_t> m_weights; // row major
+	std::vector<neuron_value_t> m_next_weights; // next generation (genetic search)
+	std::vector<double> m_fitnesses;
+	std::vector<neuron_value_t> m_mutable; // 1 for the weights that can change, 0 for the frozen genes
+	std::vector<neuron_value_t> m_noise; // scratch row
+
+	std::vector<neuron_value_t> m_best_weights;
+	double m_best_fitness;
+	unsigned int m_generation;
+
+	// evolution strategy state
+	std::vector<neuron_value_t> m_mean;
+	std::vector<neuron_value_t> m_samples; // the standard normal samples of the rows (row major)
+	std::vector<double> m_path; // conjugate evolution path
+	std::vector<double> m_recombination_weights;
+	double m_sigma;
+};
+}
@@ -25,6 +25,13 @@ struct gene {
 	friend deserializer& operator>>(deserializer& des, gene& g);
 };
 
+// the attributes of a neuron of a genome (see genome::generate_network and genome::generate_ctrnn).
+struct neuron_gene {
+	activation_function_t activation; // only used by the hidden neurons (see parameters::output_activation_function)
+	neuron_value_t time_constant; // only used by the CTRNNs
+	neuron_value_t bias; // only used by the CTRNNs
+};
+
 std::ostream& operator<<(std::ostream& os, const gene& g);
 serializer& operator<<(serializer& ser, const gene& g);
 deserializer& operator>>(deserializer& des, gene& g);
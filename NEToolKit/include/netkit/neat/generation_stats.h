@@ -0,0 +1,31 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "netkit/utils/ring_buffer.h"
+
+namespace netkit {
+// one row of the statistics history (see base_neat::get_stats_history), filled from the species stats
+// computed by the epoch anyway. Trivially copyable (64 bytes) so that the history can be dumped as is.
+struct generation_stats {
+	uint64_t generation; // index of the epoch
+	double best_fitness;
+	double avg_fitness;
+	double compatibility_threshold; // after the adjustment of the epoch
+	double mean_genome_size; // number of genes
+	double mean_phenotype_depth; // of the genomes whose phenotype has been generated, -1 if none
+	double epoch_seconds;
+	uint32_t number_of_species;
+	uint32_t population_size; // number of genomes the stats are computed on
+};
+
+// write the rows as CSV (with a header line), from the oldest to the newest.
+void write_generation_stats_csv(const std::string& filename, const ring_buffer<generation_stats>& history);
+
+// write the rows as raw records after a small header, from the oldest to the newest.
+// The file is only meant to be read back on the same architecture (see read_generation_stats_binary).
+void write_generation_stats_binary(const std::string& filename, const ring_buffer<generation_stats>& history);
+std::vector<generation_stats> read_generation_stats_binary(const std::string& filename);
+}
@@ -7,6 +7,8 @@
 #include "netkit/csv/deserializer.h"
 #include "netkit/network/network_primitive_types.h"
 #include "netkit/network/network.h"
+#include "netkit/network/ctrnn.h"
+#include "netkit/profiling/memory_report.h"
 #include "gene.h"
 
 namespace netkit {
@@ -26,14 +28,43 @@ class genome {
 
 	bool link_exists(neuron_id_t from, neuron_id_t to) const;
 
-	void set_fitness(double fitness) { m_fitness = fitness; }
+	void set_fitness(double fitness) { m_fitness = fitness; m_raw_fitness = fitness; }
 	double get_fitness() const { return m_fitness; }
+	// the fitness given by set_fitness. The multi-objective ranking replaces the fitness used by the selection by
+	// its score (see parameters::multiobjective_ranking) but the champions are still the greatest raw fitnesses.
+	void set_ranking_score(double score) { m_fitness = score; }
+	double get_raw_fitness() const { return m_raw_fitness; }
 	void set_adjusted_fitness(double fitness) { m_adjusted_fitness = fitness; }
 	double get_adjusted_fitness() const { return m_adjusted_fitness; }
+	// the objectives used by the multi-objective ranking (see parameters::multiobjective_ranking), all maximized.
+	void set_objectives(std::vector<double> objectives) { m_objectives = std::move(objectives); }
+	const std::vector<double>& get_objectives() const { return m_objectives; }
+	// time taken to evaluate the phenotype, reported by the user (see EVALUATION_TIME_COST).
+	// It is forgotten when the topology changes.
+	void set_evaluation_time(double seconds) { m_evaluation_time = seconds; }
+	double get_evaluation_time() const { return m_evaluation_time; } // -1 if unknown
+
+	// cost of the phenotype as set by params.complexity_cost (see parameters::complexity_penalty).
+	// /!\ with MACS_COST, the phenotype is generated if its depth is unknown.
+	double get_complexity_cost() const;
+	// a greater fitness, or the same fitness and a lower cost if params.complexity_tie_break is set.
+	bool is_fitter_than(const genome& other) const;
 
 	unsigned int number_of_inputs() const { return m_number_of_inputs; }
 	unsigned int number_of_outputs() const { return m_number_of_outputs; }
 
+	// the activation function of a hidden neuron (the outputs use params.output_activation_function).
+	// Throws a std::invalid_argument if the neuron isn't a known hidden neuron.
+	activation_function_t get_activation(neuron_id_t hidden_neuron) const;
+	void set_activation(neuron_id_t hidden_neuron, activation_function_t func);
+	// the time constant and the bias of an output or hidden neuron (see generate_ctrnn).
+	// Throws a std::invalid_argument if the neuron isn't a known output or hidden neuron, or if the time constant
+	// isn't positive.
+	neuron_value_t get_time_constant(neuron_id_t neuron) const;
+	void set_time_constant(neuron_id_t neuron, neuron_value_t time_constant);
+	neuron_value_t get_bias(neuron_id_t neuron) const;
+	void set_bias(neuron_id_t neuron, neuron_value_t bias);
+
 	// specie distance to another genome.
 	double distance_to(const genome& other) const;
 	bool is_compatible_with(const genome& other) const;
@@ -53,6 +84,8 @@ class genome {
 	bool mutate_weights();
 	bool mutate_reset_weights();
 	bool mutate_remove_gene();
+	bool mutate_change_activation(); // give a random hidden neuron another of params.hidden_activation_functions
+	bool mutate_neuron_params(); // perturb the time constants and biases of random output and hidden neurons
 
 	// crossovers
 	genome random_crossover(const genome& other) const;
@@ -60,13 +93,34 @@ class genome {
 	genome crossover_multipoint_rnd(const genome& other) const; // the original crossover
 	genome crossover_multipoint_avg(const genome& other) const; // a crossover for weights convergence
 
+	// when params.record_generation_stats is set, the depth of the phenotype is computed along with it
+	// and kept until the topology changes (see get_phenotype_depth).
 	network generate_network() const;
+	int get_phenotype_depth() const { return m_phenotype_depth; } // -1 if unknown
+	// the continuous-time phenotype: the network above with the time constants and biases of the neurons,
+	// integrated as set by the CTRNN parameters.
+	ctrnn generate_ctrnn() const;
+
+	// the weights of the enabled genes, in the order of the links of the generated network.
+	std::vector<neuron_value_t> get_link_weights() const;
+	// replace the weights of the enabled genes (same order). Throws a std::invalid_argument if the size differs.
+	void set_link_weights(const std::vector<neuron_value_t>& weights);
+
+	// the genes and objectives are the payload, the known neuron ids are overhead.
+	memory_report memory_usage() const;
 
   private:
 	std::vector<size_t> helper_generate_candidate_idx();
+	// index of a known neuron, searched from first_index (throws a std::invalid_argument if not found).
+	size_t helper_neuron_index(neuron_id_t neuron, size_t first_index) const;
+	// the neuron genes of the output and hidden neurons come from the first parent having them.
+	void helper_inherit_neuron_genes(const genome& first_parent, const genome& second_parent);
 
   public:
 	static const neuron_id_t BIAS_ID; // the first neuron is always the bias (see definition).
+	// version of the serialized genomes. The genomes written without a version (the original layout: fitness values
+	// and genes only) can still be read.
+	static const unsigned int SERIALIZATION_VERSION;
 
   private:
 	unsigned int m_number_of_inputs; // [1:m_number_of_inputs] are the inputs.
@@ -74,11 +128,16 @@ class genome {
 
 	std::vector<gene> m_genes;
 	std::vector<neuron_id_t> m_known_neuron_ids;
+	std::vector<neuron_gene> m_neuron_genes; // of the known neurons (not used for the bias and the inputs)
 
 	base_neat* m_neat;
 
 	double m_fitness;
 	double m_adjusted_fitness;
+	double m_raw_fitness;
+	std::vector<double> m_objectives;
+	mutable int m_phenotype_depth; // cache (-1 = unknown)
+	double m_evaluation_time; // -1 = unknown
 
 	bool reenable_gene_ok() const;
 
@@ -139,6 +198,12 @@ class genome {
 			}
 		}
 
+		if (this->m_fitness >= other.m_fitness) {
+			offspring.helper_inherit_neuron_genes(*this, other);
+		} else {
+			offspring.helper_inherit_neuron_genes(other, *this);
+		}
+
 		return std::move(offspring);
 	}
 
@@ -1,135 +1,298 @@
-#include <queue>
-#include <algorithm> // std::min
+#include <algorithm> // std::push_heap, std::pop_heap, std::sort_heap, std::upper_bound
+#include <stdexcept> // std::runtime_error
+#include <string>
 
 #include "netkit/neat/novelbank.h"
 
 namespace {
-	template<typename pos_t>
-	class novel_distance_comparator {
-	public:
-		explicit novel_distance_comparator(pos_t reference, const bool &greater_first = false)
-		  : m_greater(greater_first), m_reference(std::move(reference)) {}
-
-		bool operator()(const pos_t& lhs, const pos_t& rhs) const {
-			if (m_greater) return (m_reference.novelty_distance(lhs) < m_reference.novelty_distance(rhs));
-			else return (m_reference.novelty_distance(lhs) > m_reference.novelty_distance(rhs));
+	// keep the nb_neighbours smallest distances in a max-heap (the farthest neighbour on top).
+	inline void push_neighbour_distance(std::vector<double>& heap, unsigned int nb_neighbours, double distance) {
+		if (heap.size() < nb_neighbours) {
+			heap.push_back(distance);
+			std::push_heap(heap.begin(), heap.end());
+		} else if (!heap.empty() && distance < heap.front()) {
+			std::pop_heap(heap.begin(), heap.end());
+			heap.back() = distance;
+			std::push_heap(heap.begin(), heap.end());
 		}
-
-	private:
-		bool m_greater;
-		pos_t m_reference;
-	};
+	}
 }
 
-template<typename pos_t>
-netkit::novelbank<pos_t>::novelbank(size_t max_size, double min_threshold, unsigned int nb_neighbours)
+template<typename pos_t, typename storage_t>
+netkit::novelbank<pos_t, storage_t>::novelbank(size_t max_size, double min_threshold, unsigned int nb_neighbours)
 	: m_max_size(max_size)
 	, m_min_threshold(min_threshold)
 	, m_nb_neighbours(nb_neighbours)
-	, m_bank()
-    , m_pop() {}
+	, m_bank(max_size)
+	, m_bank_buffer()
+	, m_pop()
+	, m_pop_index() {}
+
+template<typename pos_t, typename storage_t>
+netkit::novelbank<pos_t, storage_t>::novelbank(storage_t bank, double min_threshold, unsigned int nb_neighbours)
+	: m_max_size(bank.capacity())
+	, m_min_threshold(min_threshold)
+	, m_nb_neighbours(nb_neighbours)
+	, m_bank(std::move(bank))
+	, m_bank_buffer()
+	, m_pop()
+	, m_pop_index() {}
 
-template<typename pos_t>
-netkit::novelbank<pos_t>::novelbank(novelbank<pos_t>&& other) noexcept
+template<typename pos_t, typename storage_t>
+netkit::novelbank<pos_t, storage_t>::novelbank(novelbank<pos_t, storage_t>&& other) noexcept
 	: m_max_size(other.m_max_size)
 	, m_min_threshold(other.m_min_threshold)
 	, m_nb_neighbours(other.m_nb_neighbours)
 	, m_bank(std::move(other.m_bank))
-	, m_pop(std::move(other.m_pop)) {}
+	, m_bank_buffer(std::move(other.m_bank_buffer))
+	, m_pop(std::move(other.m_pop))
+	, m_pop_index(std::move(other.m_pop_index)) {}
 
-template<typename pos_t>
-netkit::novelbank<pos_t>& netkit::novelbank<pos_t>::operator=(novelbank<pos_t>&& other) noexcept {
+template<typename pos_t, typename storage_t>
+netkit::novelbank<pos_t, storage_t>& netkit::novelbank<pos_t, storage_t>::operator=(novelbank<pos_t, storage_t>&& other) noexcept {
 	m_max_size = other.m_max_size;
 	m_min_threshold = other.m_min_threshold;
 	m_nb_neighbours = other.m_nb_neighbours;
 	m_bank = std::move(other.m_bank);
+	m_bank_buffer = std::move(other.m_bank_buffer);
 	m_pop = std::move(other.m_pop);
+	m_pop_index = std::move(other.m_pop_index);
 
 	return *this;
 }
 
-template<typename pos_t>
-double netkit::novelbank<pos_t>::evaluate(const novelgenome<pos_t>& ng) {
-	std::priority_queue<pos_t, std::vector<pos_t>, novel_distance_comparator<pos_t>>
-		pq{novel_distance_comparator<pos_t>(ng.get_pos(), true)};
-
-	for (pos_t& pos : m_bank) {
-		pq.push(pos);
+template<typename pos_t, typename storage_t>
+double netkit::novelbank<pos_t, storage_t>::evaluate(const novelgenome<pos_t>& ng) {
+	double sparseness = 0.0;
 
-		if (pq.size() > m_nb_neighbours) {
-			pq.pop();
+	auto it = m_pop_index.find(ng.get_genome_id());
+	if (it != m_pop_index.end()) {
+		pop_member& member = m_pop[it->second];
+		if (member.dirty) {
+			helper_compute_nearest(member);
+		}
+		sparseness = member.summed_distance / m_nb_neighbours;
+	} else {
+		// not registered: nothing to keep, only the distances are needed.
+		std::vector<double> nearest;
+		nearest.reserve(m_nb_neighbours + 1);
+
+		// the storage order doesn't matter here so scan the contiguous storage directly.
+		for (const pos_t& pos : m_bank) {
+			push_neighbour_distance(nearest, m_nb_neighbours, ng.get_pos().novelty_distance(pos));
 		}
-	}
-
-	for (novelgenome<pos_t>& other : m_pop) {
-		if (ng.get_genome_id() != other.get_genome_id()) {
-			pq.push(other.get_pos());
 
-			if (pq.size() > m_nb_neighbours) {
-				pq.pop();
-			}
+		for (const pop_member& other : m_pop) {
+			push_neighbour_distance(nearest, m_nb_neighbours, ng.get_pos().novelty_distance(other.ng.get_pos()));
 		}
-	}
 
-	double sparseness = 0.0;
-	unsigned int i = m_nb_neighbours;
-	while (i-- && !pq.empty()) {
-		sparseness += ng.get_pos().novelty_distance(pq.top());
-		pq.pop();
+		for (double distance : nearest) {
+			sparseness += distance;
+		}
+		sparseness /= m_nb_neighbours;
 	}
-	sparseness /= m_nb_neighbours;
 
 	// add highly novel elements to the novelty bank buffer for later usage.
 	if (sparseness >= m_min_threshold) {
-		m_bank_buffer.push_back(ng.get_pos());
+		m_bank_buffer.push_back(it != m_pop_index.end() ? m_pop[it->second].ng.get_pos() : ng.get_pos());
 	}
 
 	return sparseness;
 }
 
-template<typename pos_t>
-void netkit::novelbank<pos_t>::pop_register(novelgenome<pos_t> ng) {
-	m_pop.push_back(std::move(ng));
+template<typename pos_t, typename storage_t>
+void netkit::novelbank<pos_t, storage_t>::pop_register(novelgenome<pos_t> ng) {
+	genome_id_t genome_id = ng.get_genome_id();
+
+	auto it = m_pop_index.find(genome_id);
+	if (it != m_pop_index.end()) {
+		helper_on_removal(genome_id, false); // the old position goes away...
+		m_pop[it->second] = pop_member(std::move(ng));
+	} else {
+		m_pop_index.emplace(genome_id, m_pop.size());
+		m_pop.emplace_back(std::move(ng));
+	}
+
+	// ... and the new one may be closer to some members.
+	helper_on_insertion(m_pop[m_pop_index[genome_id]].ng.get_pos(), genome_id, false);
 }
 
-template<typename pos_t>
-void netkit::novelbank<pos_t>::pop_clear() {
+template<typename pos_t, typename storage_t>
+void netkit::novelbank<pos_t, storage_t>::pop_remove(genome_id_t genome_id) {
+	auto it = m_pop_index.find(genome_id);
+	if (it == m_pop_index.end()) {
+		return;
+	}
+
+	// swap with the last member to remove in O(1).
+	size_t idx = it->second;
+	m_pop_index.erase(it);
+	if (idx != m_pop.size() - 1) {
+		m_pop[idx] = std::move(m_pop.back());
+		m_pop_index[m_pop[idx].ng.get_genome_id()] = idx;
+	}
+	m_pop.pop_back();
+
+	helper_on_removal(genome_id, false);
+}
+
+template<typename pos_t, typename storage_t>
+void netkit::novelbank<pos_t, storage_t>::pop_clear() {
 	m_pop.clear();
+	m_pop_index.clear();
 }
 
-template<typename pos_t>
-void netkit::novelbank<pos_t>::bank_update() {
-	if (m_bank.size() + m_bank_buffer.size() > m_max_size) {
-		// get rid of the oldest records.
-		size_t excess = m_bank.size() + m_bank_buffer.size() - m_max_size;
-		for (size_t i = excess; i--;) {
-			m_bank.pop_front();
+template<typename pos_t, typename storage_t>
+void netkit::novelbank<pos_t, storage_t>::bank_update() {
+	// update the bank from the buffer. Once the bank is full, the oldest records get overwritten.
+	for (pos_t& p : m_bank_buffer) {
+		if (m_bank.full()) {
+			helper_on_removal(m_bank.oldest_sequence(), true);
 		}
-	}
 
-	// update the bank from the buffer.
-	for (pos_t& p : m_bank_buffer) {
+		uint64_t sequence = m_bank.next_sequence();
 		m_bank.push_back(std::move(p));
+
+		if (m_bank.holds(sequence)) { // false if the bank has no capacity at all
+			helper_on_insertion(m_bank.at_sequence(sequence), sequence, true);
+		}
 	}
 	m_bank_buffer.clear();
 }
 
-template<typename pos_t>
-void netkit::novelbank<pos_t>::bank_clear() {
+template<typename pos_t, typename storage_t>
+void netkit::novelbank<pos_t, storage_t>::bank_clear() {
 	m_bank.clear();
+
+	for (pop_member& member : m_pop) {
+		member.dirty = true;
+	}
+}
+
+template<typename pos_t, typename storage_t>
+netkit::memory_report netkit::novelbank<pos_t, storage_t>::memory_usage() const {
+	memory_report report = m_bank.memory_usage() + vector_overhead(m_bank_buffer) + vector_memory(m_pop);
+	for (const pop_member& member : m_pop) {
+		report += vector_overhead(member.nearest);
+	}
+
+	// estimated: a node (the element, a next pointer and a cached hash) per element and a pointer per bucket.
+	using index_value_t = typename decltype(m_pop_index)::value_type;
+	report.overhead += m_pop_index.size() * (sizeof(index_value_t) + 2 * sizeof(void*))
+					   + m_pop_index.bucket_count() * sizeof(void*);
+	return report;
+}
+
+template<typename pos_t, typename storage_t>
+void netkit::novelbank<pos_t, storage_t>::helper_compute_nearest(pop_member& member) {
+	auto farthest_on_top = [](const neighbour & n1, const neighbour & n2) {
+		return n1.distance < n2.distance;
+	};
+
+	std::vector<neighbour>& nearest = member.nearest;
+	nearest.clear();
+	nearest.reserve(m_nb_neighbours + 1);
+
+	auto push = [&](double distance, uint64_t id, bool archived) {
+		if (nearest.size() < m_nb_neighbours) {
+			nearest.push_back({distance, id, archived});
+			std::push_heap(nearest.begin(), nearest.end(), farthest_on_top);
+		} else if (!nearest.empty() && distance < nearest.front().distance) {
+			std::pop_heap(nearest.begin(), nearest.end(), farthest_on_top);
+			nearest.back() = {distance, id, archived};
+			std::push_heap(nearest.begin(), nearest.end(), farthest_on_top);
+		}
+	};
+
+	const pos_t& reference = member.ng.get_pos();
+
+	// scan the contiguous storage and get back the sequence number from the slot only for the kept records.
+	const pos_t* records = m_bank.data();
+	for (size_t slot = 0; slot < m_bank.size(); ++slot) {
+		push(reference.novelty_distance(records[slot]), slot, true);
+	}
+	for (neighbour& n : nearest) {
+		n.id = m_bank.sequence_of_slot(static_cast<size_t>(n.id));
+	}
+
+	for (const pop_member& other : m_pop) {
+		if (other.ng.get_genome_id() != member.ng.get_genome_id()) {
+			push(reference.novelty_distance(other.ng.get_pos()), other.ng.get_genome_id(), false);
+		}
+	}
+
+	std::sort_heap(nearest.begin(), nearest.end(), farthest_on_top);
+
+	member.summed_distance = 0;
+	for (const neighbour& n : nearest) {
+		member.summed_distance += n.distance;
+	}
+	member.dirty = false;
 }
 
-template<typename pos_t>
-netkit::serializer& netkit::operator<<(serializer& ser, const novelbank<pos_t>& g) {
+template<typename pos_t, typename storage_t>
+void netkit::novelbank<pos_t, storage_t>::helper_on_insertion(const pos_t& pos, uint64_t id, bool archived) {
+	for (pop_member& member : m_pop) {
+		if (member.dirty || (!archived && member.ng.get_genome_id() == id)) {
+			continue; // will be fully recomputed anyway / not its own neighbour
+		}
+
+		std::vector<neighbour>& nearest = member.nearest;
+		double distance = member.ng.get_pos().novelty_distance(pos);
+		if (nearest.size() == m_nb_neighbours && (nearest.empty() || distance >= nearest.back().distance)) {
+			continue; // doesn't beat any of the current neighbours
+		}
+
+		auto position = std::upper_bound(nearest.begin(), nearest.end(), distance, [](double d, const neighbour & n) {
+			return d < n.distance;
+		});
+		nearest.insert(position, {distance, id, archived});
+		member.summed_distance += distance;
+
+		if (nearest.size() > m_nb_neighbours) {
+			member.summed_distance -= nearest.back().distance;
+			nearest.pop_back();
+		}
+	}
+}
+
+template<typename pos_t, typename storage_t>
+void netkit::novelbank<pos_t, storage_t>::helper_on_removal(uint64_t id, bool archived) {
+	for (pop_member& member : m_pop) {
+		if (member.dirty) {
+			continue;
+		}
+
+		for (const neighbour& n : member.nearest) {
+			if (n.id == id && n.archived == archived) {
+				// a neighbour is missing and we don't know what the next closest record is.
+				member.dirty = true;
+				break;
+			}
+		}
+	}
+}
+
+template<typename pos_t, typename storage_t>
+netkit::serializer& netkit::operator<<(serializer& ser, const novelbank<pos_t, storage_t>& g) {
 	ser.append(g.m_max_size);
 	ser.append(g.m_min_threshold);
 	ser.append(g.m_nb_neighbours);
 	ser.new_line();
 
-	ser.append(g.m_bank.size());
-	ser.new_line();
-	for (const pos_t& p : g.m_bank) {
-		ser << p;
+	if constexpr (storage_t::persistent) {
+		// the archive is already on the disk: only remember where. The path may contain separators or spaces.
+		g.m_bank.flush();
+		ser.append(g.m_bank.path().size());
+		ser.append(g.m_bank.path());
+		ser.new_line();
+	} else {
+		// from the oldest record to the newest one so the eviction order is kept.
+		ser.append(g.m_bank.size());
+		ser.new_line();
+		for (size_t i = 0; i < g.m_bank.size(); ++i) {
+			ser << g.m_bank[i];
+		}
 	}
 
 	ser.append(g.m_bank_buffer.size());
@@ -140,29 +303,41 @@ netkit::serializer& netkit::operator<<(serializer& ser, const novelbank<pos_t>&
 
 	ser.append(g.m_pop.size());
 	ser.new_line();
-	for (const auto& ng : g.m_pop) {
-		ser << ng;
+	for (const auto& member : g.m_pop) {
+		ser << member.ng;
 	}
 
 	return ser;
 }
 
-template<typename pos_t>
-netkit::deserializer& netkit::operator>>(netkit::deserializer& des, novelbank<pos_t>& g) {
-	g.m_bank.clear();
+template<typename pos_t, typename storage_t>
+netkit::deserializer& netkit::operator>>(netkit::deserializer& des, novelbank<pos_t, storage_t>& g) {
 	g.m_bank_buffer.clear();
 	g.m_pop.clear();
+	g.m_pop_index.clear();
 
 	des.get_next(g.m_max_size);
 	des.get_next(g.m_min_threshold);
 	des.get_next(g.m_nb_neighbours);
-
-	size_t bank_size;
-	des.get_next(bank_size);
-	for (size_t i = 0; i < bank_size; ++i) {
-		pos_t p;
-		des >> p;
-		g.m_bank.push_back(std::move(p));
+	if constexpr (storage_t::persistent) {
+		size_t path_length;
+		des.get_next(path_length);
+		std::string path;
+		des.get_next(path, path_length);
+		if (mapped_file::size_on_disk(path) < 0 || mapped_file::size_on_disk(path + ".idx") < 0) {
+			throw std::runtime_error("the archive of the novelbank doesn't exist anymore: " + path);
+		}
+		g.m_bank = storage_t(path, g.m_max_size); // reopen the archive as it is on the disk.
+	} else {
+		g.m_bank = storage_t(g.m_max_size);
+
+		size_t bank_size;
+		des.get_next(bank_size);
+		for (size_t i = 0; i < bank_size; ++i) {
+			pos_t p;
+			des >> p;
+			g.m_bank.push_back(std::move(p));
+		}
 	}
 
 	size_t bank_buffer_size;
@@ -178,7 +353,8 @@ netkit::deserializer& netkit::operator>>(netkit::deserializer& des, novelbank<po
 	for (size_t i = 0; i < pop_size; ++i) {
 		novelgenome<pos_t> ng(0);
 		des >> ng;
-		g.m_pop.push_back(std::move(ng));
+		g.m_pop_index.emplace(ng.get_genome_id(), g.m_pop.size());
+		g.m_pop.emplace_back(std::move(ng)); // the neighbourhoods will be recomputed on demand.
 	}
 
 	return des;
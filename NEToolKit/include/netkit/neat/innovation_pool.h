@@ -7,6 +7,7 @@
 #include "netkit/csv/serializer.h"
 #include "netkit/csv/deserializer.h"
 #include "netkit/network/network_primitive_types.h"
+#include "netkit/profiling/memory_report.h"
 #include "neat_primitive_types.h"
 #include "parameters.h"
 #include "gene.h"
@@ -47,6 +48,10 @@ class innovation_pool {
 
 	void clear();
 
+	size_t number_of_genes() const { return m_all_genes.size(); }
+	size_t number_of_innovations() const { return m_all_innovations.size(); }
+	memory_report memory_usage() const;
+
   private:
 	innov_num_t m_next_innovation;
 	neuron_id_t m_next_hidden_neuron_id;
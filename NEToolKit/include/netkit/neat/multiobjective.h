@@ -0,0 +1,26 @@
+#pragma once
+
+#include <vector>
+#include <cstddef> // size_t
+
+namespace netkit {
+// NSGA-II ranking tools. All the objectives are maximized.
+// The objectives are given row-major: the objectives of the individual i are
+// objectives[i * number_of_objectives] to objectives[(i + 1) * number_of_objectives - 1].
+
+// returns the front of every individual (0 is the Pareto front, 1 the front dominated only by the Pareto front...).
+// It is an efficient non-dominated sort using binary search (ENS-BS): the individuals are sorted lexicographically
+// so that one can only be dominated by the previous ones, then the front of each of them is found by a binary
+// search over the fronts built so far. With two objectives, checking the last member of a front is enough,
+// so the whole sort is O(N log N). With more objectives, it is O(M N^2) in the worst case but much less in practice.
+std::vector<unsigned int> non_dominated_sort(const std::vector<double>& objectives, size_t number_of_objectives);
+
+// returns the crowding distance of every individual within its front (infinity for the boundaries of a front).
+std::vector<double> crowding_distances(const std::vector<double>& objectives, size_t number_of_objectives,
+									   const std::vector<unsigned int>& fronts);
+
+// returns a positive score per individual that follows the NSGA-II crowded-comparison order:
+// a better front always means a greater score and, within the same front, a larger crowding distance means
+// a greater score. It is used as the fitness so the species and the genitor selection rely on the ranking.
+std::vector<double> nsga2_scores(const std::vector<double>& objectives, size_t number_of_objectives);
+}
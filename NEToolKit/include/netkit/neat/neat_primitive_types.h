@@ -20,6 +20,34 @@ enum mutation_t {
 	TOGGLE_ENABLE,
 	RESET_WEIGHTS,
 	PERTURBATE_WEIGHTS,
+	CHANGE_ACTIVATION, // see parameters::hidden_activation_functions
+	PERTURBATE_NEURON_PARAMS, // time constants and biases of the neurons (only used by the CTRNNs)
 	NUMBER_OF_MUTATIONS
 };
+
+// how the weights of a fixed topology are searched (see fixed_topology_population).
+enum weight_search_t {
+	GENETIC_WEIGHT_SEARCH, // truncation selection, blend crossover and weight perturbations
+	EVOLUTION_STRATEGY, // (mu/mu_w, lambda)-ES with cumulative step-size adaptation
+
+	NUMBER_OF_WEIGHT_SEARCHES
+};
+
+// what the complexity penalty of a genome is proportional to (see parameters::complexity_penalty).
+enum complexity_cost_t {
+	LINKS_COST, // enabled links
+	NEURONS_COST, // output and hidden neurons
+	MACS_COST, // multiply-accumulates of a query: enabled links times the depth of the phenotype
+	EVALUATION_TIME_COST, // seconds, as measured by the user (see organism::set_evaluation_time)
+
+	NUMBER_OF_COMPLEXITY_COSTS
+};
+
+// the phases of the phased search (see parameters::phased_search).
+enum search_phase_t {
+	COMPLEXIFYING_PHASE, // the mutations are params.mutation_probs
+	PRUNING_PHASE, // no structural addition, more removals
+
+	NUMBER_OF_SEARCH_PHASES
+};
 }
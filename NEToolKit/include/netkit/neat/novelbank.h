@@ -1,10 +1,13 @@
 #pragma once
 
 #include <vector>
-#include <deque>
+#include <unordered_map>
+#include <cstdint>
 
 #include "netkit/csv/serializer.h"
 #include "netkit/csv/deserializer.h"
+#include "netkit/utils/ring_buffer.h"
+#include "netkit/utils/mapped_ring_buffer.h"
 #include "novelgenome.h"
 
 namespace netkit {
@@ -12,42 +15,93 @@ class base_population; // forward declaration
 
 // /!\ the algorithm to find the closest elements by novelty distance is naive and quite slow.
 // It may be best to implement a specific novelbank for the specific pos_t using, for instance, a quad-tree.
-template<typename pos_t>
+// The archive is a fixed capacity ring buffer (max_size elements): its memory is allocated once and the oldest
+// records are overwritten in O(1). Prefer a pos_t with inline storage (see novelpos) so that the whole archive
+// lives in one contiguous block.
+// The archive storage is ring_buffer<pos_t> by default. Use mapped_ring_buffer<pos_t> (see mapped_novelbank) to
+// keep the archive in a memory-mapped file instead: huge archives don't weigh on the RSS, they persist on their own
+// (only the path is serialized) and an experiment restarts instantly by opening the same file again.
+//
+// The k nearest neighbours of every registered member of the population are kept and maintained incrementally:
+// inserting a record (in the archive or the population) only updates the members it is closer to, and removing
+// a record only invalidates the members that had it as a neighbour. Thus evaluating a member whose neighbourhood
+// hasn't changed since its last evaluation (an elite kept from one generation to the next for instance) is O(1).
+template<typename pos_t, typename storage_t = ring_buffer<pos_t>>
 class novelbank {
   public:
 	explicit novelbank(size_t max_size, double min_threshold, unsigned int nb_neighbours);
-	novelbank(const novelbank<pos_t>& other) = default;
-	novelbank& operator=(const novelbank<pos_t>& other) = default;
-	novelbank(novelbank<pos_t>&& other) noexcept;
-	novelbank& operator=(novelbank<pos_t>&& other) noexcept;
+	// use an already built archive storage (max_size is its capacity). A reopened mapped archive keeps its records.
+	explicit novelbank(storage_t bank, double min_threshold, unsigned int nb_neighbours);
+	novelbank(const novelbank& other) = default;
+	novelbank& operator=(const novelbank& other) = default;
+	novelbank(novelbank&& other) noexcept;
+	novelbank& operator=(novelbank&& other) noexcept;
 
+	// returns the sparseness of the given novelgenome.
+	// If a novelgenome with the same genome id has been registered, the registered position is the one evaluated.
 	double evaluate(const novelgenome<pos_t>& ng);
 
+	// register a member of the population. If the genome id is already registered, its position is replaced.
+	// Members that don't change from one generation to the next shouldn't be registered again.
 	void pop_register(novelgenome<pos_t> ng);
+	void pop_remove(genome_id_t genome_id);
 	void pop_clear();
+	bool pop_has(genome_id_t genome_id) const { return m_pop_index.find(genome_id) != m_pop_index.end(); }
 
 	void bank_update();
 	void bank_clear();
+	const storage_t& bank() const { return m_bank; }
+
+	// the archive and the population positions are the payload (the memory owned by pos_t isn't included),
+	// the neighbourhoods and the genome id index are overhead.
+	memory_report memory_usage() const;
 
   private:
 	size_t m_max_size;
 	double m_min_threshold;
 	unsigned int m_nb_neighbours;
 
-	std::deque<pos_t> m_bank;
+	storage_t m_bank;
 	std::vector<pos_t> m_bank_buffer;
-	std::vector<netkit::novelgenome<pos_t>> m_pop;
 
-	template<typename pos_t_>
-	friend serializer& operator<<(serializer& ser, const novelbank<pos_t_>& rg);
-	template<typename pos_t_>
-	friend deserializer& operator>>(deserializer& des, novelbank<pos_t_>& rg);
+	// a neighbour is either a record of the archive (identified by its sequence number) or a member of
+	// the population (identified by its genome id).
+	struct neighbour {
+		double distance;
+		uint64_t id;
+		bool archived;
+	};
+
+	struct pop_member {
+		explicit pop_member(novelgenome<pos_t> ng_) : ng(std::move(ng_)), nearest(), summed_distance(0), dirty(true) {}
+
+		novelgenome<pos_t> ng;
+		std::vector<neighbour> nearest; // sorted by distance, at most m_nb_neighbours elements.
+		double summed_distance;
+		bool dirty; // the neighbourhood must be fully recomputed
+	};
+
+	std::vector<pop_member> m_pop;
+	std::unordered_map<genome_id_t, size_t> m_pop_index; // genome id -> index in m_pop
+
+	void helper_compute_nearest(pop_member& member);
+	void helper_on_insertion(const pos_t& pos, uint64_t id, bool archived);
+	void helper_on_removal(uint64_t id, bool archived);
+
+	template<typename pos_t_, typename storage_t_>
+	friend serializer& operator<<(serializer& ser, const novelbank<pos_t_, storage_t_>& rg);
+	template<typename pos_t_, typename storage_t_>
+	friend deserializer& operator>>(deserializer& des, novelbank<pos_t_, storage_t_>& rg);
 };
 
+// a novelbank whose archive is a memory-mapped file. pos_t must be trivially copyable.
 template<typename pos_t>
-serializer& operator<<(serializer& ser, const novelbank<pos_t>& ng);
-template<typename pos_t>
-deserializer& operator>>(deserializer& des, novelbank<pos_t>& ng);
+using mapped_novelbank = novelbank<pos_t, mapped_ring_buffer<pos_t>>;
+
+template<typename pos_t, typename storage_t>
+serializer& operator<<(serializer& ser, const novelbank<pos_t, storage_t>& ng);
+template<typename pos_t, typename storage_t>
+deserializer& operator>>(deserializer& des, novelbank<pos_t, storage_t>& ng);
 }
 
 #include "impl/novelbank.tpp"
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+
+#include "netkit/csv/serializer.h"
+#include "netkit/csv/deserializer.h"
+
+namespace netkit {
+// fixed-size novelty position (behaviour descriptor) to use as the pos_t of novelgenome and novelbank.
+// The values are stored inline (no heap allocation) so an archive of novelpos is a single contiguous block.
+// The novelty distance is the euclidean distance.
+template<size_t dim>
+struct novelpos {
+	novelpos() : values() {}
+	explicit novelpos(const std::array<double, dim>& values_) : values(values_) {}
+
+	double novelty_distance(const novelpos<dim>& other) const {
+		double sum = 0.0;
+		for (size_t i = 0; i < dim; ++i) {
+			double diff = values[i] - other.values[i];
+			sum += diff * diff;
+		}
+		return std::sqrt(sum);
+	}
+
+	double& operator[](size_t i) { return values[i]; }
+	double operator[](size_t i) const { return values[i]; }
+
+	static constexpr size_t dimension = dim;
+
+	std::array<double, dim> values;
+};
+
+template<size_t dim>
+serializer& operator<<(serializer& ser, const novelpos<dim>& p) {
+	for (double v : p.values) {
+		ser.append(v);
+	}
+	ser.new_line();
+
+	return ser;
+}
+
+template<size_t dim>
+deserializer& operator>>(deserializer& des, novelpos<dim>& p) {
+	for (double& v : p.values) {
+		des.get_next(v);
+	}
+
+	return des;
+}
+}
@@ -22,8 +22,11 @@ class organism {
 	genome& get_genome() const;
 	double get_fitness() const;
 	void set_fitness(double value) const;
+	void set_objectives(std::vector<double> objectives) const; // for the multi-objective ranking
+	void set_evaluation_time(double seconds) const; // for EVALUATION_TIME_COST
 	tick_t get_time_alive() const;
 	void increase_time_alive();
+	memory_report memory_usage() const { return m_network.memory_usage(); }
 
   private:
 	base_population* m_population;
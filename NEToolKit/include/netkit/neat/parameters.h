@@ -1,5 +1,8 @@
 #pragma once
 
+#include <vector>
+
+#include "netkit/network/network_primitive_types.h"
 #include "neat_primitive_types.h"
 
 namespace netkit {
@@ -14,6 +17,8 @@ struct parameters {
 		mutation_probs[TOGGLE_ENABLE] = 0.03;
 		mutation_probs[RESET_WEIGHTS] = 0.03;
 		mutation_probs[PERTURBATE_WEIGHTS] = 0.30;
+		mutation_probs[CHANGE_ACTIVATION] = 0.00; // needs several hidden_activation_functions
+		mutation_probs[PERTURBATE_NEURON_PARAMS] = 0.00; // see the CTRNN section
 	}
 
 	// === general ===
@@ -63,6 +68,24 @@ struct parameters {
 	double initial_weight_perturbation = 10.0;
 	double weight_mutation_power = 3.0;
 
+	// === activation functions ===
+	// The functions a hidden neuron can have (see CHANGE_ACTIVATION), the first one is given to the new neurons.
+	std::vector<activation_function_t> hidden_activation_functions = {STEEPENED_SIGMOID_ACTIVATION};
+	activation_function_t output_activation_function = STEEPENED_SIGMOID_ACTIVATION;
+	// the phenotypes use the lookup tables instead of the exact functions (see activation_functions.h).
+	bool activation_lookup_tables = false;
+
+	// === CTRNN (see genome::generate_ctrnn) ===
+	// The output and hidden neurons have a time constant and a bias, perturbed by PERTURBATE_NEURON_PARAMS.
+	// /!\ the integration diverges if the time step is larger than twice the smallest time constant.
+	ctrnn_integration_t ctrnn_integration = EULER_INTEGRATION;
+	double ctrnn_time_step = 0.05;
+	double ctrnn_initial_time_constant = 1.0;
+	double ctrnn_min_time_constant = 0.1; // the perturbed time constants are clamped
+	double ctrnn_max_time_constant = 10.0;
+	double time_constant_mutation_power = 0.5;
+	double bias_mutation_power = 0.5;
+
 	// === crossovers ===
 	// crossover probability
 	double crossover_prob = 0.20;
@@ -77,6 +100,77 @@ struct parameters {
 			   + crossover_multipoint_rnd_weight;
 	}
 
+	// === fixed topology (see fixed_topology_population) ===
+	// Only the weights of a champion topology are evolved, the population size is initial_population_size.
+	// The genetic search also uses crossover_prob and weight_mutation_power.
+	weight_search_t weight_search = GENETIC_WEIGHT_SEARCH;
+	double fixed_topology_survival_rate = 0.2; // proportion of the best weights allowed to reproduce
+	unsigned int fixed_topology_elitism = 1; // number of best weights copied as is into the next generation
+	double fixed_topology_weight_mutation_rate = 0.2; // probability of each weight of an offspring to be perturbed
+	double evolution_strategy_initial_sigma = 0.5; // initial step size of the evolution strategy
+
+	// === Lamarckian refinement (see refine_weights) ===
+	unsigned int refinement_steps = 50; // gradient descent steps on the supervised samples
+	double refinement_learning_rate = 0.3; // higher rates diverge easily with the steepened sigmoid
+
+	// === HyperNEAT (see substrate) ===
+	// The genomes are CPPNs with 4 inputs (x1, y1, x2, y2) and 1 output: the weight of every substrate link.
+	double substrate_expression_threshold = 0.2; // links whose CPPN output is below it (absolute value) aren't expressed
+	double substrate_max_weight = 5.0; // weight of an expressed link whose CPPN output is 1 (absolute value)
+	size_t cppn_batch_size = 1024; // number of candidate links queried at once
+
+	// === multi-objective ranking ===
+	// Rank the genomes on several objectives (see organism::set_objectives) instead of a single fitness,
+	// NSGA-II style: non-dominated fronts first, then crowding distance within a front. At the beginning of
+	// each epoch, the fitness of every genome is replaced by its rank score, so the species selection and
+	// the genitors selection rely on the ranking. The champions, the best genomes library and the stats keep using
+	// the fitness given by the user (see genome::get_raw_fitness). Typically, objectives are the task fitness and
+	// the novelty. Not used by rtNEAT.
+	bool multiobjective_ranking = false;
+	unsigned int number_of_objectives = 2;
+
+	// === parsimony ===
+	// The networks tend to grow over long runs, and their evaluation cost with them. The adjusted fitness of a
+	// genome is then (fitness - complexity_penalty * cost) / species size, floored at 0 (see species::share_fitness).
+	// The measured costs unknown yet (no evaluation time reported) count as 0.
+	// /!\ with multiobjective_ranking, the fitness is the rank score: the penalty is subtracted from the score, not
+	// from the fitness given by the user. Make the cost one of the objectives instead (and leave the penalty at 0).
+	complexity_cost_t complexity_cost = LINKS_COST;
+	double complexity_penalty = 0.0; // per unit of cost, 0 (or less) = disabled
+	// among genomes of the same fitness, the cheaper ones win (species ranking, champions, best genome ever).
+	bool complexity_tie_break = false;
+
+	// === phased search (see base_neat::get_search_phase) ===
+	// Green's phased pruning. The search complexifies until the mean genome size (genes) exceeds the one at the
+	// end of the last pruning phase (at first, the initial one) by phased_search_complexity_threshold while the
+	// best fitness of the population hasn't improved for phased_search_fitness_stall epochs. It then prunes:
+	// no crossover (the offsprings would get the genes of both parents), no link, neuron or cascade addition nor
+	// reenabling, and the removals get the pruning probabilities below. These probabilities are restored once the
+	// mean genome size hasn't decreased for phased_search_pruning_stall epochs.
+	// /!\ mutation_probs and the crossover probabilities are modified during a pruning phase.
+	bool phased_search = false;
+	double phased_search_complexity_threshold = 30;
+	unsigned int phased_search_fitness_stall = 10;
+	unsigned int phased_search_pruning_stall = 10;
+	double pruning_remove_gene_prob = 0.2;
+	double pruning_remove_neuron_prob = 0.1;
+
+	// === instrumentation ===
+	// measure the duration of the phases of every epoch (see base_neat::get_last_epoch_timings).
+	bool record_epoch_timings = false;
+	// also read the hardware counters (cycles, instructions, cache and branch misses) of every phase.
+	// Linux only: if the counters are unavailable, only the timings are recorded. Needs record_epoch_timings.
+	bool record_hardware_counters = false;
+	// also count the heap allocations (number and bytes) of every phase. Needs record_epoch_timings and the
+	// allocation hooks (see netkit/profiling/allocation_hooks.h), nothing is recorded without them.
+	bool record_allocations = false;
+	// take a memory snapshot at the end of every epoch (see base_neat::get_last_memory_usage).
+	bool record_memory_usage = false;
+	// keep a stats row per epoch in a ring buffer (see base_neat::get_stats_history).
+	// The phenotype depths are computed when the networks are generated (once per topology).
+	bool record_generation_stats = false;
+	size_t generation_stats_capacity = 10000; // number of rows kept, the oldest ones are overwritten
+
 	// === other ===
 	unsigned int babies_stolen = 0; // TODO: not yet implemented
 
@@ -29,6 +29,9 @@ class rtneat : public base_neat {
 	base_population* pop() final;
 	const base_population* pop() const final;
 
+	// also counts the organisms (the phenotypes are kept alive).
+	neat_memory_report memory_usage() const final;
+
   private:
 	void impl_init(const genome& initial_genome) final;
 
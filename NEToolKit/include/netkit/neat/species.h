@@ -2,6 +2,7 @@
 
 #include "netkit/csv/serializer.h"
 #include "netkit/csv/deserializer.h"
+#include "netkit/profiling/memory_report.h"
 #include "neat_primitive_types.h"
 #include "genome.h"
 
@@ -26,6 +27,12 @@ class species {
 	double get_summed_fitnesses() const { return m_summed_fitnesses; }
 	double get_summed_adjusted_fitnesses() const { return m_summed_adjusted_fitnesses; }
 	double get_best_fitness_ever() const { return m_best_fitness_ever; }
+	size_t get_summed_genome_sizes() const { return m_summed_genome_sizes; } // number of genes of all the members
+	double get_summed_phenotype_depths() const { return m_summed_phenotype_depths; } // of the members with a known depth
+	size_t get_number_of_known_depths() const { return m_number_of_known_depths; }
+	// the raw fitnesses (see genome::get_raw_fitness), the fitnesses being the scores of multiobjective_ranking.
+	double get_summed_raw_fitnesses() const { return m_summed_raw_fitnesses; }
+	double get_best_raw_fitness() const { return m_best_raw_fitness; }
 	species_id_t get_id() const { return m_id; }
 	species_age_t get_age() const { return m_age; }
 	species_age_t get_age_of_last_improvement() const { return m_age_of_last_improvement; }
@@ -47,6 +54,9 @@ class species {
 	void share_fitness() const; // share the fitness amongst members
 	void set_expected_offsprings(unsigned int value) { m_expected_offsprings = value; }
 
+	// the members ids are the payload, the representant (a copy of a genome) is overhead.
+	memory_report memory_usage() const;
+
   private:
 	std::vector<genome_id_t> m_members;
 
@@ -56,6 +66,11 @@ class species {
 	double m_summed_fitnesses;
 	double m_summed_adjusted_fitnesses;
 	double m_best_fitness_ever;
+	size_t m_summed_genome_sizes;
+	double m_summed_phenotype_depths;
+	size_t m_number_of_known_depths;
+	double m_summed_raw_fitnesses;
+	double m_best_raw_fitness;
 
 	species_id_t m_id;
 	species_age_t m_age;
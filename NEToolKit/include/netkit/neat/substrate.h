@@ -0,0 +1,53 @@
+#pragma once
+
+#include <vector>
+
+#include "netkit/network/compiled_network.h"
+#include "netkit/network/network_primitive_types.h"
+#include "genome.h"
+#include "parameters.h"
+
+namespace netkit {
+struct substrate_point {
+	double x;
+	double y;
+};
+
+// HyperNEAT: the genomes are CPPNs painting the weights of a much larger network laid out on a plane.
+// The substrate is made of layers of neurons (the first one being the inputs, the last one the outputs), every
+// neuron of a layer being a candidate source of every neuron of the next layer. A candidate link (x1, y1) -> (x2, y2)
+// is expressed if the CPPN output for it is above params.substrate_expression_threshold (see build).
+class substrate {
+  public:
+	// Throws a std::invalid_argument if there are less than two layers or if a layer is empty.
+	explicit substrate(std::vector<std::vector<substrate_point>> layers);
+
+	const std::vector<std::vector<substrate_point>>& get_layers() const { return m_layers; }
+	size_t number_of_inputs() const { return m_layers.front().size(); }
+	size_t number_of_outputs() const { return m_layers.back().size(); }
+	size_t number_of_neurons() const; // without the bias
+	size_t number_of_candidate_links() const;
+
+	// the usual CPPN setup of the parameters of the NEAT evolving the CPPNs: 4 inputs and 1 output, hidden neurons
+	// among gaussian, sine, absolute, identity and steepened sigmoid (CHANGE_ACTIVATION probability of 0.1) and an
+	// identity output.
+	static parameters cppn_parameters(parameters params);
+
+	// queries the CPPN for all the candidate links, params.cppn_batch_size at once (see evaluate_batch), and
+	// compiles the expressed ones. The neuron ids are the bias, then the neurons layer after layer; the hidden
+	// and output neurons use the steepened sigmoid. The expressed links are scaled so that their absolute weight
+	// goes from 0 at the threshold to params.substrate_max_weight for a CPPN output of 1.
+	// Throws a std::invalid_argument if the CPPN doesn't have 4 inputs and 1 output or if the threshold isn't
+	// in [0, 1).
+	compiled_network build(const genome& cppn, const parameters& params) const;
+	// same result, with one CPPN evaluation per candidate link (the reference of the benchmarks).
+	compiled_network build_unbatched(const genome& cppn, const parameters& params) const;
+
+  private:
+	compiled_network helper_compile(const std::vector<link>& links) const;
+
+  private:
+	std::vector<std::vector<substrate_point>> m_layers;
+	std::vector<neuron_id_t> m_first_ids; // network id of the first neuron of each layer
+};
+}
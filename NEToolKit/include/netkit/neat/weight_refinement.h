@@ -0,0 +1,19 @@
+#pragma once
+
+#include <vector>
+#include <optional>
+
+#include "netkit/network/backpropagation.h"
+#include "organism.h"
+#include "parameters.h"
+
+namespace netkit {
+// Lamarckian local search for supervised tasks: a few steps of gradient descent (see backpropagate) on the
+// phenotype of the organism, whose refined weights are written back into the genes of its genome (the frozen
+// genes are left untouched) and into its network. Call it before rating the organism.
+// Only touches the organism and its genome, so it can run in parallel on different organisms.
+// Returns the mean squared error of the refined weights, or nothing (and nothing changes) if the phenotype
+// isn't differentiable (recurrent, or with an activation function without known derivative).
+std::optional<double> refine_weights(organism& org, const std::vector<training_sample>& samples,
+									 const parameters& params);
+}
@@ -1,9 +1,51 @@
 #pragma once
 
+#include <cstddef>
+
 #include "network_primitive_types.h"
 
 namespace netkit {
+using raw_activation_func_t = neuron_value_t (*)(neuron_value_t);
+
 neuron_value_t sigmoid(neuron_value_t input);
 
 neuron_value_t steepened_sigmoid(neuron_value_t input);
+
+neuron_value_t hyperbolic_tangent(neuron_value_t input);
+neuron_value_t relu(neuron_value_t input);
+neuron_value_t step(neuron_value_t input); // 1 if strictly positive, 0 otherwise
+
+// the usual CPPN functions (see substrate).
+neuron_value_t gaussian(neuron_value_t input);
+neuron_value_t sine(neuron_value_t input);
+neuron_value_t absolute(neuron_value_t input);
+neuron_value_t linear(neuron_value_t input); // the identity
+
+// derivatives, expressed with the output of the function (as used by backpropagation).
+neuron_value_t sigmoid_derivative(neuron_value_t output);
+neuron_value_t steepened_sigmoid_derivative(neuron_value_t output);
+neuron_value_t hyperbolic_tangent_derivative(neuron_value_t output);
+neuron_value_t relu_derivative(neuron_value_t output);
+neuron_value_t linear_derivative(neuron_value_t output);
+
+// The functions known by their id have two implementations:
+// - the exact one (the functions above),
+// - a lookup table: a piecewise linear interpolation on a regular grid (4096 intervals on [-16, 16], a period for
+//   the sine), flat outside for the bounded functions and extended by the end segments for the others. It avoids
+//   the calls to exp, tanh and sin, its error is below 1e-4 for the smooth functions and it is exact for relu,
+//   identity and absolute, but the step becomes a steep ramp on ]0, 1/128].
+raw_activation_func_t activation_function(activation_function_t func, bool lookup_table = false);
+const char* activation_function_name(activation_function_t func);
+// nullptr if the derivative can't be expressed with the output (gaussian, step, sine, absolute).
+raw_activation_func_t activation_derivative(activation_function_t func);
+
+// the id and implementation of a function returned by activation_function.
+// Returns false if the function is unknown (lambdas, user functions).
+bool identify_activation_function(raw_activation_func_t raw, activation_function_t& func, bool& lookup_table);
+
+// values[i] = f(sums[i]) for the count values, in a single loop per function that the compiler can vectorize
+// (the exact exp, tanh and sin are library calls: use the lookup tables to vectorize the smooth functions).
+// sums and values may be the same array. The results are the ones of activation_function(func, lookup_table).
+void apply_activation(activation_function_t func, bool lookup_table, const neuron_value_t* sums,
+					  neuron_value_t* values, size_t count);
 }
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <vector>
+
+#include "compiled_network.h"
+#include "network_primitive_types.h"
+
+namespace netkit {
+// an input vector and the outputs expected for it.
+struct training_sample {
+	std::vector<neuron_value_t> inputs;
+	std::vector<neuron_value_t> targets;
+};
+
+// mean over the samples of the squared errors of the outputs (feed-forward networks only).
+double mean_squared_error(const compiled_network& net, const neuron_value_t* weights,
+						  const std::vector<training_sample>& samples);
+
+// steps of full-batch gradient descent on the mean squared error over the samples: a forward pass in the
+// topological order, then a reverse-mode pass accumulating the gradient of every weight (compiled order).
+// If a mask is given, only the weights with a non-zero mask are updated.
+// Returns the mean squared error of the refined weights.
+// Throws a std::invalid_argument if the network isn't differentiable (see compiled_network::is_differentiable).
+double backpropagate(const compiled_network& net, neuron_value_t* weights, const std::vector<training_sample>& samples,
+					 unsigned int steps, double learning_rate, const neuron_value_t* mask = nullptr);
+}
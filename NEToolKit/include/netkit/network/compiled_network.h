@@ -0,0 +1,164 @@
+#pragma once
+
+#include <vector>
+
+#include "network.h"
+#include "network_primitive_types.h"
+#include "activation_functions.h"
+#include "netkit/profiling/memory_report.h"
+#include "netkit/utils/thread_pool.h"
+
+namespace netkit {
+// immutable, flat copy of the topology of a network: the incoming links of every neuron are stored contiguously
+// (compressed sparse rows), in the order the network sums them, so that the results are exactly the network ones.
+// The weights are kept apart: any weights vector in the compiled order (see to_compiled_order) can be evaluated
+// on the same topology, which is how a population of weights shares one topology (see fixed_topology_population).
+// The neuron values are kept apart as well, so a compiled network can be evaluated by several threads at once.
+// The activation functions known by their id (see apply_activation) are applied by a single loop per group of
+// neurons of the same level and function (activate_feed_forward) or per neuron over a batch (evaluate_batch).
+class compiled_network {
+  public:
+	explicit compiled_network(const network& net);
+	// built straight from links between neuron ids (the neuron 0 being the bias), without a network: large generated
+	// networks (see substrate) skip the network and its depth search. The link ids are the indices of the links.
+	// Throws a std::invalid_argument if a link refers to an unknown neuron or if the network has a cycle.
+	compiled_network(const std::vector<link>& links, std::vector<activation_func_t> activations,
+					 std::vector<neuron_id_t> input_ids, std::vector<neuron_id_t> output_ids);
+
+	size_t number_of_neurons() const { return m_activations.size(); }
+	size_t number_of_links() const { return m_sources.size(); }
+	size_t number_of_inputs() const { return m_input_ids.size(); }
+	size_t number_of_outputs() const { return m_output_ids.size(); }
+	const std::vector<neuron_id_t>& get_input_ids() const { return m_input_ids; }
+	const std::vector<neuron_id_t>& get_output_ids() const { return m_output_ids; }
+	int depth() const { return m_depth; } // number of activations to relax the network (see network::max_depth)
+
+	// the neurons with incoming links sorted by level (Kahn's algorithm): a neuron only depends on neurons
+	// of lower levels (level 0 being the bias, the inputs and the neurons without incoming links).
+	// Within a level, the neurons are grouped by activation function.
+	// The levels are only known for feed-forward networks, there is none if the network has a cycle.
+	bool is_feed_forward() const { return m_feed_forward; }
+	size_t number_of_levels() const { return m_level_offsets.empty() ? 0 : m_level_offsets.size() - 1; }
+	const std::vector<neuron_id_t>& get_topological_order() const { return m_topological_order; }
+	// neurons of the level l + 1: [offsets[l], offsets[l + 1]) of the topological order.
+	const std::vector<size_t>& get_level_offsets() const { return m_level_offsets; }
+
+	// feed-forward networks whose activation functions have a known derivative (see backpropagate).
+	bool is_differentiable() const;
+	// derivative of the activation function of the neuron, given its output (the neuron must be differentiable).
+	neuron_value_t derivative(neuron_id_t nid, neuron_value_t output) const { return m_derivatives[nid](output); }
+	size_t incoming_begin(neuron_id_t nid) const { return m_offsets[nid]; }
+	size_t incoming_end(neuron_id_t nid) const { return m_offsets[nid + 1]; }
+	neuron_id_t source(size_t compiled_link) const { return m_sources[compiled_link]; }
+
+	// the weights of the compiled network, in the compiled order.
+	const std::vector<neuron_value_t>& get_weights() const { return m_weights; }
+
+	// conversions between the order of the network links (the order of the enabled genes of a genome,
+	// see genome::get_link_weights) and the compiled order.
+	std::vector<neuron_value_t> to_compiled_order(const std::vector<neuron_value_t>& link_weights) const;
+	std::vector<neuron_value_t> to_link_order(const neuron_value_t* weights) const;
+
+	// same as the network methods, with the neuron values and the weights (compiled order) given.
+	// /!\ flush gives the values some scratch space after the neurons (see activate_feed_forward).
+	void flush(std::vector<neuron_value_t>& values) const;
+	void load_inputs(std::vector<neuron_value_t>& values, const std::vector<neuron_value_t>& inputs) const;
+	void activate(const neuron_value_t* weights, std::vector<neuron_value_t>& values) const;
+	void activate_until_relaxation(const neuron_value_t* weights, std::vector<neuron_value_t>& values) const;
+	// a single pass in the topological order (feed-forward networks only): every neuron gets its final value.
+	// The groups of neurons sharing an activation function are activated at once.
+	void activate_feed_forward(const neuron_value_t* weights, std::vector<neuron_value_t>& values) const;
+	// same values, the neurons of a level being split over the pool (ranges of about the same number of links),
+	// with a barrier before the next level. A level with less than 2 * PARALLEL_LINKS_PER_TASK links (or a pool of a
+	// single thread) is activated by the calling thread, so small networks don't pay for the synchronization.
+	void activate_feed_forward(const neuron_value_t* weights, std::vector<neuron_value_t>& values,
+							   thread_pool& pool) const;
+	// synchronous activation (see network::activate_synchronous): the next values are computed from the previous
+	// ones only, the neurons without incoming links keeping their value. Swap the buffers to go on.
+	// With a pool, the neurons are split in contiguous ranges of about the same number of links, updated in
+	// parallel; a range has at least PARALLEL_LINKS_PER_TASK links, so small networks are updated by the calling
+	// thread. Every neuron is computed the same way whatever the split: the results don't depend on the number of
+	// threads.
+	void activate_synchronous(const neuron_value_t* weights, const std::vector<neuron_value_t>& previous,
+							  std::vector<neuron_value_t>& next) const;
+	void activate_synchronous(const neuron_value_t* weights, const std::vector<neuron_value_t>& previous,
+							  std::vector<neuron_value_t>& next, thread_pool& pool) const;
+	void get_outputs(const std::vector<neuron_value_t>& values, std::vector<neuron_value_t>& outputs) const;
+
+	// flush, load the inputs, relax and get the outputs at once.
+	std::vector<neuron_value_t> evaluate(const neuron_value_t* weights, const std::vector<neuron_value_t>& inputs,
+										 std::vector<neuron_value_t>& values) const;
+	// for a single query on a large network: a feed-forward network is activated level by level over the pool
+	// (see activate_feed_forward), which gives the results of evaluate when the depth covers all the levels (always
+	// the case of the networks built from links). A recurrent network is relaxed by the calling thread.
+	std::vector<neuron_value_t> evaluate(const neuron_value_t* weights, const std::vector<neuron_value_t>& inputs,
+										 std::vector<neuron_value_t>& values, thread_pool& pool) const;
+
+	// evaluates batch_size input vectors at once (row-major, batch_size x number_of_inputs) and writes the outputs
+	// (row-major, batch_size x number_of_outputs). The values are neuron-major: every link is applied to the whole
+	// batch in a contiguous loop, instead of one flush/load_inputs/activate per input vector.
+	// The results are the ones of evaluate.
+	void evaluate_batch(const neuron_value_t* weights, const neuron_value_t* inputs, size_t batch_size,
+						neuron_value_t* outputs, std::vector<neuron_value_t>& values) const;
+
+	memory_report memory_usage() const;
+
+  public:
+	// the least work given to a thread of the pool (see activate_synchronous and activate_feed_forward).
+	static const size_t PARALLEL_LINKS_PER_TASK;
+
+  private:
+	using raw_activation_t = neuron_value_t (*)(neuron_value_t);
+
+	// neurons of a level sharing an activation function: [begin, end) of the topological order.
+	struct activation_group {
+		size_t begin;
+		size_t end;
+		activation_function_t function; // NUMBER_OF_ACTIVATION_FUNCTIONS if unknown (activated neuron by neuron)
+		bool lookup_table;
+	};
+
+	void helper_add_activation(const activation_func_t& func);
+	void helper_sort_by_levels();
+	// number of tasks sharing links over the pool (1: the calling thread does the work).
+	static size_t helper_number_of_tasks(size_t links, const thread_pool& pool);
+	// activates the neurons [begin, end) of the topological order, in the level starting at level_begin.
+	void helper_activate_feed_forward(const neuron_value_t* weights, neuron_value_t* values, size_t level_begin,
+									  size_t begin, size_t end) const;
+	// synchronous activation of the fed neurons [begin, end) (indices of m_fed_neurons).
+	void helper_activate_synchronous(const neuron_value_t* weights, const neuron_value_t* previous,
+									 neuron_value_t* next, size_t begin, size_t end) const;
+	void helper_activate_batch(neuron_id_t nid, const neuron_value_t* weights, size_t batch_size,
+							   neuron_value_t* values, neuron_value_t* sums) const;
+
+	neuron_value_t helper_activate(neuron_id_t nid, neuron_value_t sum) const {
+		raw_activation_t raw = m_raw_activations[nid];
+		return raw != nullptr ? raw(sum) : m_activations[nid](sum);
+	}
+
+  private:
+	// incoming links of the neuron n: [m_offsets[n], m_offsets[n + 1]).
+	std::vector<size_t> m_offsets;
+	std::vector<neuron_id_t> m_sources;
+	std::vector<neuron_value_t> m_weights;
+	std::vector<link_id_t> m_link_ids; // network link id of each compiled link
+
+	std::vector<neuron_id_t> m_fed_neurons; // the neurons with incoming links, in the network order
+	std::vector<activation_func_t> m_activations;
+	std::vector<raw_activation_t> m_raw_activations; // plain functions are called directly (nullptr otherwise)
+	std::vector<activation_function_t> m_functions; // NUMBER_OF_ACTIVATION_FUNCTIONS if unknown
+	std::vector<bool> m_lookup_tables;
+	std::vector<raw_activation_t> m_derivatives; // nullptr if unknown
+
+	bool m_feed_forward;
+	std::vector<neuron_id_t> m_topological_order;
+	std::vector<size_t> m_level_offsets;
+	std::vector<size_t> m_cumulative_links; // number of incoming links of the topological order before each neuron
+	std::vector<activation_group> m_groups;
+	size_t m_largest_level; // the scratch space given by flush
+
+	std::vector<neuron_id_t> m_input_ids;
+	std::vector<neuron_id_t> m_output_ids;
+	int m_depth;
+};
+}
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <vector>
+
+#include "network.h"
+#include "network_primitive_types.h"
+#include "netkit/profiling/memory_report.h"
+
+namespace netkit {
+// continuous-time recurrent network: every neuron but the bias and the inputs has a state y, a time constant tau
+// and a bias b, and follows
+//     tau * dy/dt = -y + f(b + sum of the weighted states of its sources)
+// (the bias neuron is 1 and the inputs are the loaded values). Unlike network::activate, the result doesn't depend
+// on the storage order of the neurons: all the derivatives are computed from the same states, then integrated
+// with a fixed time step (explicit Euler or Heun's method, see ctrnn_integration_t).
+// The states are stored contiguously, grouped by activation function, so that the activations (see
+// apply_activation) and the integration are single loops over the neurons. See ctrnn_batch to run many agents.
+// /!\ the explicit integration diverges if the time step is larger than twice the smallest time constant.
+class ctrnn {
+  public:
+	// the time constants and the biases are given by network neuron id (the ones of the bias and the inputs are
+	// ignored). The links to the bias or to an input are ignored as well.
+	// Throws a std::invalid_argument if their sizes aren't the number of neurons of the network, if the time step
+	// isn't positive or if a time constant isn't positive.
+	ctrnn(const network& net, const std::vector<neuron_value_t>& time_constants,
+		  const std::vector<neuron_value_t>& biases, neuron_value_t time_step,
+		  ctrnn_integration_t integration = EULER_INTEGRATION);
+
+	size_t number_of_neurons() const { return m_biases.size(); } // with a state
+	size_t number_of_links() const { return m_sources.size(); }
+	size_t number_of_inputs() const { return m_number_of_inputs; }
+	size_t number_of_outputs() const { return m_output_slots.size(); }
+	neuron_value_t time_step() const { return m_time_step; }
+	ctrnn_integration_t integration() const { return m_integration; }
+
+	// all the states and inputs to 0.
+	void flush();
+	// Throws a std::invalid_argument if the number of inputs is incorrect.
+	void load_inputs(const std::vector<neuron_value_t>& inputs);
+	// integrates the network over one time step, or over several.
+	void step();
+	void advance(unsigned int steps);
+	std::vector<neuron_value_t> get_outputs() const;
+	// state of a neuron given by its network id (the bias is 1, the inputs are their loaded value).
+	neuron_value_t get_state(neuron_id_t nid) const { return m_values[m_slots[nid]]; }
+
+	memory_report memory_usage() const;
+
+  private:
+	// neurons sharing an activation function: [begin, end) of the states.
+	struct activation_group {
+		size_t begin;
+		size_t end;
+		activation_function_t function; // NUMBER_OF_ACTIVATION_FUNCTIONS if unknown (activated neuron by neuron)
+		bool lookup_table;
+	};
+
+	// the parameters and states of agents sharing the topology, agent-minor: the value of the slot s of the
+	// agent a is values[s * agents + a], and so on for the weights, biases and inverse time constants.
+	struct agents_view {
+		size_t agents;
+		const neuron_value_t* weights;
+		const neuron_value_t* biases;
+		const neuron_value_t* inverse_time_constants;
+		neuron_value_t* values;
+		neuron_value_t* scratch; // 3 * number_of_neurons() * agents
+	};
+
+	// the kernels, shared with ctrnn_batch.
+	void helper_step(const agents_view& view) const;
+	void helper_derivatives(const agents_view& view, neuron_value_t* derivatives) const;
+	agents_view helper_view();
+
+	bool helper_same_topology(const ctrnn& other) const;
+
+  private:
+	// slots of the values: the bias, the inputs, then the neurons with a state.
+	std::vector<size_t> m_slots; // slot of each network neuron
+	size_t m_number_of_inputs;
+	size_t m_first_state; // slot of the first state
+	std::vector<size_t> m_output_slots;
+
+	// incoming links of the state k: [m_offsets[k], m_offsets[k + 1]), in the order of the network.
+	std::vector<size_t> m_offsets;
+	std::vector<size_t> m_sources; // slots
+	std::vector<neuron_value_t> m_weights;
+	std::vector<neuron_value_t> m_biases;
+	std::vector<neuron_value_t> m_inverse_time_constants;
+
+	std::vector<activation_func_t> m_activations; // of the states
+	std::vector<activation_group> m_groups;
+
+	neuron_value_t m_time_step;
+	ctrnn_integration_t m_integration;
+
+	std::vector<neuron_value_t> m_values;
+	std::vector<neuron_value_t> m_scratch;
+
+	friend class ctrnn_batch;
+};
+
+// many agents with the same topology integrated by the same kernels: the states of a neuron for all the agents
+// are contiguous, so every link, activation and integration is a single loop over the agents. Each agent has its
+// own weights, biases and time constants (see set_controller), e.g. the controllers of a fixed topology population,
+// or the same controller in many episodes.
+class ctrnn_batch {
+  public:
+	// number_of_agents copies of the controller. Throws a std::invalid_argument if there is no agent.
+	ctrnn_batch(const ctrnn& controller, size_t number_of_agents);
+
+	size_t number_of_agents() const { return m_agents; }
+	const ctrnn& get_topology() const { return m_topology; }
+
+	// gives an agent the weights, biases and time constants of a controller. The activation functions unknown by
+	// their id (see apply_activation) stay the ones of the first controller.
+	// Throws a std::invalid_argument if the agent doesn't exist or if the controller has another topology (links,
+	// functions, time step or integration).
+	void set_controller(size_t agent, const ctrnn& controller);
+
+	void flush();
+	// row-major: number_of_agents x number_of_inputs.
+	void load_inputs(const neuron_value_t* inputs);
+	void step();
+	void advance(unsigned int steps);
+	// row-major: number_of_agents x number_of_outputs.
+	void get_outputs(neuron_value_t* outputs) const;
+
+	memory_report memory_usage() const;
+
+  private:
+	ctrnn::agents_view helper_view();
+
+  private:
+	ctrnn m_topology;
+	size_t m_agents;
+
+	std::vector<neuron_value_t> m_weights;
+	std::vector<neuron_value_t> m_biases;
+	std::vector<neuron_value_t> m_inverse_time_constants;
+	std::vector<neuron_value_t> m_values;
+	std::vector<neuron_value_t> m_scratch;
+};
+}
@@ -5,6 +5,7 @@
 
 #include "neuron.h"
 #include "link.h"
+#include "netkit/profiling/memory_report.h"
 
 namespace netkit {
 class network {
@@ -18,8 +19,13 @@ class network {
 	// completly discharge the network (initial state).
 	void flush();
 	void load_inputs(std::vector<neuron_value_t> inputs);
+	// in place, in the order of the neuron ids: a neuron already sees the values of this activation of the
+	// neurons before it.
 	void activate();
 	void activate_until_relaxation();
+	// every neuron is fed with the values of the previous activation (double buffer): the result doesn't depend
+	// on the order of the neurons (see compiled_network::activate_synchronous to update them in parallel).
+	void activate_synchronous();
 	std::vector<neuron_value_t> get_outputs();
 
 	neuron_id_t add_neuron(neuron_type_t type, neuron n);
@@ -28,6 +34,8 @@ class network {
 	link_id_t add_link(neuron_id_t from_id, neuron_id_t to_id, neuron_value_t weight);
 	const std::vector<link>& get_links() const;
 	size_t number_of_links() const;
+	const std::vector<neuron_id_t>& get_input_ids() const { return m_input_neuron_ids; }
+	const std::vector<neuron_id_t>& get_output_ids() const { return m_output_neuron_ids; }
 
 	// find the maximum depth for the given neuron that is the size longest path to an input.
 	// It uses a modified Dijkstra's algorithm to perform a full search following incoming links.
@@ -40,6 +48,9 @@ class network {
 	// that being said, it uses a cache system to avoid unnecessary recomputation.
 	int max_depth() const;
 
+	// the links and neurons are the payload, the links ids of every neuron and the input/output ids are overhead.
+	memory_report memory_usage() const;
+
   public:
 	static const neuron_id_t BIAS_ID;
 
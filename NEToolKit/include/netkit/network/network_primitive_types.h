@@ -15,5 +15,29 @@ enum neuron_type_t {
 
 using link_id_t = unsigned int;
 
+// the activation functions known by their id (see activation_functions.h): a genome gives one to each of its
+// hidden neurons, and the compiled networks evaluate the neurons of the same function together.
+enum activation_function_t {
+	STEEPENED_SIGMOID_ACTIVATION,
+	SIGMOID_ACTIVATION,
+	TANH_ACTIVATION,
+	RELU_ACTIVATION,
+	GAUSSIAN_ACTIVATION,
+	IDENTITY_ACTIVATION,
+	STEP_ACTIVATION,
+	SINE_ACTIVATION,
+	ABSOLUTE_ACTIVATION,
+
+	NUMBER_OF_ACTIVATION_FUNCTIONS
+};
+
+// how the continuous-time networks are integrated (see ctrnn).
+enum ctrnn_integration_t {
+	EULER_INTEGRATION, // explicit Euler: one evaluation of the derivatives per step
+	RK2_INTEGRATION, // Heun's method: two evaluations per step, second order
+
+	NUMBER_OF_INTEGRATIONS
+};
+
 using activation_func_t = std::function<neuron_value_t(neuron_value_t)>;
 }
@@ -27,6 +27,8 @@ class neuron {
 	const std::vector<link_id_t>& incoming_links_ids() const;
 	const std::vector<link_id_t>& outgoing_links_ids() const;
 
+	const activation_func_t& get_activation_func() const { return m_activation_func; }
+
   private:
 	std::vector<link_id_t> m_incoming;
 	std::vector<link_id_t> m_outgoing;
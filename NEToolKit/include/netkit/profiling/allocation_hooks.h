@@ -0,0 +1,46 @@
+#pragma once
+
+// Replaces the global operator new and delete to count the allocations (see allocation_tracker.h).
+// /!\ include this header in exactly ONE source file of the program (not in a header): it defines the operators.
+// The allocations of the whole program are counted, including the ones of the library and the standard library.
+// The aligned (std::align_val_t) versions aren't replaced, so over-aligned allocations aren't counted.
+
+#include <new>
+#include <cstdlib>
+
+#include "allocation_tracker.h"
+
+namespace {
+	const bool netkit_allocation_hooks = (netkit::mark_allocation_hooks_installed(), true);
+}
+
+void* operator new(std::size_t size) {
+	netkit::record_allocation(size);
+	if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+		return ptr;
+	}
+	throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+	return ::operator new(size);
+}
+
+void operator delete(void* ptr) noexcept {
+	if (ptr != nullptr) {
+		netkit::record_deallocation();
+		std::free(ptr);
+	}
+}
+
+void operator delete[](void* ptr) noexcept {
+	::operator delete(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+	::operator delete(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept {
+	::operator delete(ptr);
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace netkit {
+// number of heap allocations (operator new) performed.
+struct allocation_counts {
+	uint64_t allocations = 0;
+	uint64_t bytes = 0; // requested by the allocations
+	uint64_t deallocations = 0;
+
+	allocation_counts& operator+=(const allocation_counts& other);
+	allocation_counts operator-(const allocation_counts& other) const;
+};
+
+// the subsystems tracked outside of the epochs (the epoch phases are tracked in the epoch timings,
+// see parameters::record_allocations).
+enum alloc_subsystem_t {
+	ALLOC_GENERATE_NETWORK,
+	ALLOC_SERIALIZATION, // serialization and deserialization of the NEAT instances
+
+	NUMBER_OF_ALLOC_SUBSYSTEMS
+};
+
+const char* alloc_subsystem_name(alloc_subsystem_t subsystem);
+
+// The allocations are only counted once the hooks are installed, by including netkit/profiling/allocation_hooks.h
+// in ONE source file of the program. Otherwise, nothing is counted and the scopes below cost a single branch.
+bool allocation_hooks_installed();
+void mark_allocation_hooks_installed(); // called by the hooks
+
+// called by the hooks. The counts are kept per thread (no synchronization).
+void record_allocation(size_t bytes);
+void record_deallocation();
+
+// allocations of the calling thread since it started (only counted if the hooks are installed).
+allocation_counts thread_allocation_counts();
+
+// allocations performed in each subsystem (all threads) since the start or the last reset.
+allocation_counts get_allocation_counts(alloc_subsystem_t subsystem);
+void reset_allocation_counts();
+
+// RAII scope adding the allocations of the calling thread during its lifetime to a subsystem.
+// Scopes of the same subsystem shouldn't be nested (the allocations would be counted twice).
+class allocation_scope {
+  public:
+	explicit allocation_scope(alloc_subsystem_t subsystem);
+	allocation_scope(const allocation_scope& other) = delete;
+	allocation_scope& operator=(const allocation_scope& other) = delete;
+	~allocation_scope();
+
+  private:
+	alloc_subsystem_t m_subsystem;
+	bool m_tracking;
+	allocation_counts m_start;
+};
+}
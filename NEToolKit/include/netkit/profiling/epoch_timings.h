@@ -0,0 +1,105 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+#include "trace.h"
+#include "perf_counters.h"
+#include "allocation_tracker.h"
+
+namespace netkit {
+// the phases of an epoch. Some phases are nested in others: CROSSOVER and MUTATION are part of REPRODUCTION,
+// and INNOVATION_LOOKUP is part of MUTATION. A parent phase duration includes its nested phases.
+enum phase_t {
+	SPECIES_STATS, // fitness sharing, species sorting and stats (and multi-objective ranking)
+	OFFSPRING_ALLOCATION, // expected number of offsprings of each species (rtNEAT: worst genome and species selection)
+	REPRODUCTION,
+	CROSSOVER,
+	MUTATION,
+	INNOVATION_LOOKUP,
+	RESPECIATION,
+	EXTINCTION, // removal of the empty species
+	THRESHOLD_ADJUSTMENT, // dynamic compatibility threshold
+
+	NUMBER_OF_PHASES
+};
+
+const char* phase_name(phase_t phase);
+
+// durations of the phases of one epoch (see base_neat::get_last_epoch_timings).
+struct epoch_timings {
+	std::array<double, NUMBER_OF_PHASES> seconds{}; // cumulated duration of each phase
+	std::array<uint64_t, NUMBER_OF_PHASES> calls{}; // number of times each phase has been entered
+	double total_seconds = 0; // the whole epoch
+
+	// hardware counters of each phase, only if has_counters (see parameters::record_hardware_counters).
+	bool has_counters = false;
+	std::array<counter_values, NUMBER_OF_PHASES> counters{};
+	const perf_counters* counters_source = nullptr; // set during the epoch only, not owned
+
+	// heap allocations of each phase, only if has_allocations (see parameters::record_allocations).
+	bool has_allocations = false;
+	std::array<allocation_counts, NUMBER_OF_PHASES> allocations{};
+
+	double operator[](phase_t phase) const { return seconds[phase]; }
+	void clear() { *this = epoch_timings(); }
+};
+
+// RAII timer adding its lifetime to a phase. Given no timings (nullptr), it does nothing at all,
+// so it can be left in hot paths when the instrumentation is disabled.
+// If the timings have a counters source, the hardware counters are read at both ends of the scope too,
+// and so are the allocation counts of the thread if the timings have allocations.
+// When built with NETKIT_WITH_TRACING, it also records a trace event named after the phase.
+class phase_scope {
+  public:
+	phase_scope(epoch_timings* timings, phase_t phase)
+		: m_timings(timings)
+		, m_phase(phase)
+		, m_start()
+		, m_start_counters()
+		, m_start_allocations() {
+		if (m_timings != nullptr) {
+			if (m_timings->counters_source != nullptr) {
+				m_start_counters = m_timings->counters_source->read();
+			}
+			if (m_timings->has_allocations) {
+				m_start_allocations = thread_allocation_counts();
+			}
+			m_start = std::chrono::steady_clock::now();
+		}
+#ifdef NETKIT_WITH_TRACING
+		m_trace_start = trace_now_ns();
+#endif
+	}
+
+	phase_scope(const phase_scope& other) = delete;
+	phase_scope& operator=(const phase_scope& other) = delete;
+
+	~phase_scope() {
+#ifdef NETKIT_WITH_TRACING
+		trace_record(phase_name(m_phase), m_trace_start, trace_now_ns());
+#endif
+		if (m_timings != nullptr) {
+			m_timings->seconds[m_phase] += std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count();
+			++m_timings->calls[m_phase];
+			if (m_timings->counters_source != nullptr) {
+				m_timings->counters[m_phase] += m_timings->counters_source->read() - m_start_counters;
+			}
+			if (m_timings->has_allocations) {
+				m_timings->allocations[m_phase] += thread_allocation_counts() - m_start_allocations;
+			}
+		}
+	}
+
+  private:
+	epoch_timings* m_timings;
+	phase_t m_phase;
+	std::chrono::steady_clock::time_point m_start;
+	counter_values m_start_counters;
+	allocation_counts m_start_allocations;
+#ifdef NETKIT_WITH_TRACING
+	uint64_t m_trace_start;
+#endif
+};
+}
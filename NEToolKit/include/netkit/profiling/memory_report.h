@@ -0,0 +1,69 @@
+#pragma once
+
+#include <vector>
+#include <iostream>
+#include <cstddef>
+
+namespace netkit {
+// heap memory owned by an object (see the memory_usage methods), in bytes.
+// The size of the object itself isn't included: it is accounted for by whatever holds it (usually a vector).
+//  - used: the elements actually stored.
+//  - reserved: the memory allocated for these elements (used + the slack of the containers).
+//  - overhead: the bookkeeping memory (indexes, caches, per-element containers like the links of a neuron...).
+//  - mapped: file-backed memory (memory-mapped archives). The OS can page it out, so it isn't part of total().
+struct memory_report {
+	size_t used = 0;
+	size_t reserved = 0;
+	size_t overhead = 0;
+	size_t mapped = 0;
+
+	size_t slack() const { return reserved - used; }
+	size_t total() const { return reserved + overhead; }
+
+	memory_report& operator+=(const memory_report& other);
+};
+
+memory_report operator+(memory_report lhs, const memory_report& rhs);
+std::ostream& operator<<(std::ostream& os, const memory_report& report);
+
+// the element storage of a vector. Memory owned by the elements themselves isn't included.
+template<typename T>
+memory_report vector_memory(const std::vector<T>& vec) {
+	memory_report report;
+	report.used = vec.size() * sizeof(T);
+	report.reserved = vec.capacity() * sizeof(T);
+	return report;
+}
+
+// std::vector<bool> packs its elements.
+inline memory_report vector_memory(const std::vector<bool>& vec) {
+	memory_report report;
+	report.used = (vec.size() + 7) / 8;
+	report.reserved = (vec.capacity() + 7) / 8;
+	return report;
+}
+
+// the memory of a vector, counted as overhead only (for bookkeeping vectors).
+template<typename T>
+memory_report vector_overhead(const std::vector<T>& vec) {
+	memory_report report;
+	report.overhead = vector_memory(vec).reserved;
+	return report;
+}
+
+// memory footprint of a NEAT instance by component (see base_neat::memory_usage).
+struct neat_memory_report {
+	memory_report population; // the genomes
+	memory_report organisms; // the phenotypes kept by the algorithm (rtNEAT only)
+	memory_report species; // the members lists and the representants
+	memory_report innovation_pool; // the innovation history
+	memory_report best_genomes; // the best genome ever and the best genomes library
+	size_t number_of_genomes = 0;
+	size_t number_of_genes = 0; // in the population
+	size_t number_of_innovations = 0;
+
+	memory_report total() const;
+};
+
+std::ostream& operator<<(std::ostream& os, const neat_memory_report& report);
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <cstdint>
+
+#include "epoch_timings.h"
+
+namespace netkit {
+class base_neat; // forward declaration
+
+// exposes the metrics of a NEAT instance in the Prometheus text exposition format (version 0.0.4).
+// Attach it with base_neat::set_metrics_exporter: the instance publishes its metrics at the end of every epoch.
+// Publishing only performs relaxed atomic stores (no lock, no allocation), the formatting is done by the reader:
+// render(), a writer thread (start_file_writer) or a tiny HTTP responder (start_http_server).
+//
+// Some metrics need the corresponding instrumentation, they are omitted until they have been published once:
+// the phase times need params.record_epoch_timings, the memory needs params.record_memory_usage,
+// the generation fitnesses need params.record_generation_stats and the best fitness ever needs
+// the best genome ever to be updated (base_neat::update_best_genome_ever).
+class metrics_exporter {
+  public:
+	metrics_exporter();
+	metrics_exporter(const metrics_exporter& other) = delete;
+	metrics_exporter& operator=(const metrics_exporter& other) = delete;
+	~metrics_exporter(); // stops the threads
+
+	// called by the instance at the end of every epoch (from the evolution thread).
+	void publish(const base_neat& neat, double epoch_seconds);
+
+	// an evaluation is an organism handed to the user (counted by the instances when they generate organisms).
+	void add_evaluations(uint64_t number_of_evaluations);
+
+	// the metrics in the Prometheus text format.
+	std::string render() const;
+
+	// write the metrics to a file (through a temporary file and a rename, so that readers never see a partial file).
+	void write_to_file(const std::string& path) const;
+
+	// write the metrics to the file every period, from a background thread.
+	// A failed write (full disk, missing directory...) doesn't stop the writer, it tries again on the next period:
+	// see get_last_file_error.
+	void start_file_writer(const std::string& path, std::chrono::milliseconds period);
+	// the error of the last failed write of the file writer (empty if none has failed yet) and the number of them.
+	std::string get_last_file_error() const;
+	uint64_t get_number_of_failed_writes() const { return m_failed_writes.load(); }
+
+	// answer GET /metrics on 127.0.0.1:port from a background thread (port 0 picks a free port, see port()).
+	// Only available on POSIX systems: throws a std::runtime_error elsewhere or if the port cannot be bound.
+	void start_http_server(uint16_t port);
+	uint16_t port() const { return m_port; }
+
+	// stop the background threads (if any). The file is written one last time.
+	void stop();
+
+  private:
+	enum gauge_t {
+		EVALUATIONS_PER_SECOND,
+		EPOCH_SECONDS,
+		POPULATION_SIZE,
+		NUMBER_OF_SPECIES,
+		INNOVATIONS,
+		POPULATION_MEMORY,
+		TOTAL_MEMORY,
+		BEST_FITNESS_EVER,
+		GENERATION_BEST_FITNESS,
+		GENERATION_AVG_FITNESS,
+
+		NUMBER_OF_GAUGES
+	};
+
+	// a metric that has never been published is NaN (and omitted).
+	void set(gauge_t gauge, double value) { m_gauges[gauge].store(value, std::memory_order_relaxed); }
+
+	void helper_file_writer_loop(std::string path, std::chrono::milliseconds period);
+	void helper_try_write_to_file(const std::string& path); // never throws, remembers the error instead
+	void helper_http_server_loop();
+
+  private:
+	std::array<std::atomic<double>, NUMBER_OF_GAUGES> m_gauges;
+	std::array<std::atomic<double>, NUMBER_OF_PHASES> m_phase_seconds;
+	std::atomic<uint64_t> m_epochs;
+	std::atomic<uint64_t> m_evaluations;
+
+	// only used by the publishing thread.
+	uint64_t m_evaluations_at_last_publish;
+	std::chrono::steady_clock::time_point m_last_publish;
+
+	std::atomic<bool> m_stop;
+	std::thread m_file_writer;
+	mutable std::mutex m_file_error_mutex;
+	std::string m_last_file_error;
+	std::atomic<uint64_t> m_failed_writes;
+	std::thread m_http_server;
+	int m_listen_fd;
+	uint16_t m_port;
+};
+}
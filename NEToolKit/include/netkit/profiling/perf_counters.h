@@ -0,0 +1,47 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace netkit {
+enum counter_t {
+	CYCLES,
+	INSTRUCTIONS,
+	CACHE_MISSES,
+	BRANCH_MISSES,
+
+	NUMBER_OF_COUNTERS
+};
+
+const char* counter_name(counter_t counter);
+
+struct counter_values {
+	std::array<uint64_t, NUMBER_OF_COUNTERS> values{};
+
+	uint64_t operator[](counter_t counter) const { return values[counter]; }
+	counter_values& operator+=(const counter_values& other);
+	counter_values operator-(const counter_values& other) const;
+};
+
+// hardware performance counters of the calling thread (Linux perf_event_open), opened as one group so
+// they're all measured over the same period. The counters are often unavailable (other platforms,
+// containers, perf_event_paranoid...): then available() is false, read() returns zeros and the
+// instrumentation built on top of it falls back to timings only.
+class perf_counters {
+  public:
+	perf_counters();
+	perf_counters(const perf_counters& other) = delete;
+	perf_counters& operator=(const perf_counters& other) = delete;
+	~perf_counters();
+
+	bool available() const { return m_available; }
+
+	// counts since the creation (scaled if the kernel had to multiplex the counters).
+	// /!\ only meaningful on the thread which created the counters.
+	counter_values read() const;
+
+  private:
+	std::array<int, NUMBER_OF_COUNTERS> m_fds;
+	bool m_available;
+};
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+
+// Trace events (Chrome trace / Perfetto format). Build with the NETKIT_WITH_TRACING cmake option to record them,
+// otherwise the NETKIT_TRACE_* macros compile to nothing.
+//
+// NETKIT_TRACE_SCOPE("name") records the lifetime of the enclosing scope. The name must be a string literal
+// (or any string outliving the trace): only the pointer is stored.
+// Every thread records in its own fixed capacity ring buffer, without locks, and the oldest events are
+// overwritten once it's full. Call write_chrome_trace when the recording threads are idle (between two
+// generations for instance) and load the file in chrome://tracing or https://ui.perfetto.dev.
+
+#define NETKIT_TRACE_CONCAT_IMPL(a, b) a##b
+#define NETKIT_TRACE_CONCAT(a, b) NETKIT_TRACE_CONCAT_IMPL(a, b)
+
+#ifdef NETKIT_WITH_TRACING
+#define NETKIT_TRACE_SCOPE(name) ::netkit::trace_scope NETKIT_TRACE_CONCAT(netkit_trace_scope_, __LINE__)(name)
+#else
+#define NETKIT_TRACE_SCOPE(name) ((void)0)
+#endif
+
+namespace netkit {
+// nanoseconds since the first trace event of the process.
+uint64_t trace_now_ns();
+
+// record a complete event (used by trace_scope).
+void trace_record(const char* name, uint64_t start_ns, uint64_t end_ns);
+
+// write all the recorded events, returns false if the file can't be written.
+bool write_chrome_trace(const std::string& filename);
+
+// forget all the recorded events.
+void trace_clear();
+
+// true if the library has been built with the tracing enabled.
+bool trace_enabled();
+
+class trace_scope {
+  public:
+	explicit trace_scope(const char* name) : m_name(name), m_start(trace_now_ns()) {}
+	trace_scope(const trace_scope& other) = delete;
+	trace_scope& operator=(const trace_scope& other) = delete;
+	~trace_scope() { trace_record(m_name, m_start, trace_now_ns()); }
+
+  private:
+	const char* m_name;
+	uint64_t m_start;
+};
+}
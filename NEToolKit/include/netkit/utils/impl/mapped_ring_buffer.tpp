@@ -0,0 +1,70 @@
+#include <stdexcept> // std::runtime_error
+
+#include "netkit/utils/mapped_ring_buffer.h"
+
+template<typename T>
+netkit::mapped_ring_buffer<T>::mapped_ring_buffer(const std::string& path, size_t capacity)
+	: m_index(path + ".idx", sizeof(index_t))
+	, m_data()
+	, m_capacity(capacity) {
+	index_t& idx = index();
+	bool existing = m_index.reopened() && idx.magic == MAGIC;
+	if (existing) {
+		// check the buffer before the data file is mapped: mapping it would resize it.
+		int64_t expected_size = static_cast<int64_t>(capacity * sizeof(T));
+		if (idx.element_size != sizeof(T) || idx.capacity != capacity
+			|| (capacity > 0 && mapped_file::size_on_disk(path) != expected_size)) {
+			throw std::runtime_error("the mapped ring buffer " + path + " doesn't match the requested capacity or element type.");
+		}
+	}
+
+	m_data = mapped_file(path, capacity * sizeof(T));
+
+	if (!existing) {
+		// brand new buffer (or a data file without a valid index): start over, the index is valid once the data is mapped.
+		idx.magic = MAGIC;
+		idx.element_size = sizeof(T);
+		idx.capacity = capacity;
+		idx.size = 0;
+		idx.next_sequence = 0;
+	}
+}
+
+template<typename T>
+bool netkit::mapped_ring_buffer<T>::push_back(T value) {
+	if (m_capacity == 0) {
+		return false;
+	}
+
+	index_t& idx = index();
+	bool overwritten = idx.size == m_capacity;
+	storage()[slot_of(idx.next_sequence)] = value;
+
+	// update the index once the element is written.
+	if (!overwritten) {
+		++idx.size;
+	}
+	++idx.next_sequence;
+
+	return overwritten;
+}
+
+template<typename T>
+void netkit::mapped_ring_buffer<T>::clear() {
+	index().size = 0;
+	index().next_sequence = 0;
+}
+
+template<typename T>
+uint64_t netkit::mapped_ring_buffer<T>::sequence_of_slot(size_t slot) const {
+	// the newest element in this slot is the last sequence congruent to slot modulo the capacity.
+	uint64_t last = next_sequence() - 1;
+	uint64_t last_slot = last % m_capacity;
+	return last_slot >= slot ? last - (last_slot - slot) : last - (last_slot + m_capacity - slot);
+}
+
+template<typename T>
+void netkit::mapped_ring_buffer<T>::flush() const {
+	m_data.flush();
+	m_index.flush();
+}
@@ -0,0 +1,57 @@
+#include "netkit/utils/ring_buffer.h"
+
+template<typename T>
+netkit::ring_buffer<T>::ring_buffer(size_t capacity)
+	: m_storage()
+	, m_capacity(capacity)
+	, m_next_sequence(0) {
+	m_storage.reserve(m_capacity); // the only allocation ever performed by the buffer.
+}
+
+template<typename T>
+netkit::ring_buffer<T>::ring_buffer(ring_buffer<T>&& other) noexcept
+	: m_storage(std::move(other.m_storage))
+	, m_capacity(other.m_capacity)
+	, m_next_sequence(other.m_next_sequence) {}
+
+template<typename T>
+netkit::ring_buffer<T>& netkit::ring_buffer<T>::operator=(ring_buffer<T>&& other) noexcept {
+	m_storage = std::move(other.m_storage);
+	m_capacity = other.m_capacity;
+	m_next_sequence = other.m_next_sequence;
+
+	return *this;
+}
+
+template<typename T>
+bool netkit::ring_buffer<T>::push_back(T value) {
+	if (m_capacity == 0) {
+		return false;
+	}
+
+	bool overwritten = false;
+	if (m_storage.size() < m_capacity) {
+		m_storage.push_back(std::move(value));
+	} else {
+		// O(1) eviction: the slot of the oldest element is reused.
+		m_storage[slot_of(m_next_sequence)] = std::move(value);
+		overwritten = true;
+	}
+	++m_next_sequence;
+
+	return overwritten;
+}
+
+template<typename T>
+void netkit::ring_buffer<T>::clear() {
+	m_storage.clear();
+	m_next_sequence = 0;
+}
+
+template<typename T>
+uint64_t netkit::ring_buffer<T>::sequence_of_slot(size_t slot) const {
+	// the newest element in this slot is the last sequence congruent to slot modulo the capacity.
+	uint64_t last = m_next_sequence - 1;
+	uint64_t last_slot = last % m_capacity;
+	return last_slot >= slot ? last - (last_slot - slot) : last - (last_slot + m_capacity - slot);
+}
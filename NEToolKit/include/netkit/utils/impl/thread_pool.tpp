@@ -0,0 +1,51 @@
+#include <algorithm> // std::min
+
+#include "netkit/utils/thread_pool.h"
+
+template<typename func_t>
+void netkit::thread_pool::parallel_for(size_t count, func_t func) {
+	if (count == 0) {
+		return;
+	}
+
+	// the loop has its own completion count and error: the other tasks of the pool are neither waited for
+	// nor do their exceptions end up here.
+	struct loop_state {
+		std::mutex mutex;
+		std::condition_variable done;
+		size_t unfinished_chunks = 0;
+		std::exception_ptr first_error;
+	} state;
+
+	// a few chunks per worker to even out the chunks of different costs.
+	size_t number_of_chunks = std::min(count, size() * 4);
+	size_t chunk_size = (count + number_of_chunks - 1) / number_of_chunks;
+	state.unfinished_chunks = (count + chunk_size - 1) / chunk_size;
+	for (size_t begin = 0; begin < count; begin += chunk_size) {
+		size_t end = std::min(count, begin + chunk_size);
+		submit([&func, &state, begin, end]() {
+			std::exception_ptr error;
+			try {
+				for (size_t i = begin; i < end; ++i) {
+					func(i);
+				}
+			} catch (...) {
+				error = std::current_exception();
+			}
+
+			std::lock_guard<std::mutex> lock(state.mutex);
+			if (error && !state.first_error) {
+				state.first_error = error;
+			}
+			if (--state.unfinished_chunks == 0) {
+				state.done.notify_all();
+			}
+		});
+	}
+
+	std::unique_lock<std::mutex> lock(state.mutex);
+	state.done.wait(lock, [&state]() { return state.unfinished_chunks == 0; });
+	if (state.first_error) {
+		std::rethrow_exception(state.first_error);
+	}
+}
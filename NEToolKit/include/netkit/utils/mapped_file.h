@@ -0,0 +1,46 @@
+#pragma once
+
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+namespace netkit {
+// a file mapped in memory (shared mapping: the writes end up in the file).
+// The file is created if it doesn't exist and resized to the requested size otherwise.
+// Only available on POSIX systems: the constructor throws a std::runtime_error elsewhere.
+class mapped_file {
+  public:
+	mapped_file();
+	explicit mapped_file(const std::string& path, size_t size);
+	mapped_file(const mapped_file& other) = delete;
+	mapped_file& operator=(const mapped_file& other) = delete;
+	mapped_file(mapped_file&& other) noexcept;
+	mapped_file& operator=(mapped_file&& other) noexcept;
+	~mapped_file();
+
+	void* data() { return m_data; }
+	const void* data() const { return m_data; }
+	size_t size() const { return m_size; }
+	const std::string& path() const { return m_path; }
+	bool is_mapped() const { return m_data != nullptr; }
+
+	// true if the file already existed with the requested size (its content is the previous one).
+	bool reopened() const { return m_reopened; }
+
+	// synchronously write the modified pages to the disk.
+	void flush() const;
+
+	// size of the file at path without opening nor resizing it, -1 if it doesn't exist.
+	static int64_t size_on_disk(const std::string& path);
+
+  private:
+	void helper_unmap();
+
+  private:
+	std::string m_path;
+	void* m_data;
+	size_t m_size;
+	int m_fd;
+	bool m_reopened;
+};
+}
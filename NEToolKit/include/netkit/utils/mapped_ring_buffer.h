@@ -0,0 +1,95 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+#include <type_traits>
+
+#include "netkit/profiling/memory_report.h"
+#include "mapped_file.h"
+
+namespace netkit {
+// a ring_buffer (same interface and same sequence numbers) whose storage is a memory-mapped file.
+// The elements are stored raw in the file "path" and the index (capacity, size, sequence numbers) is
+// persisted in "path.idx". Only the pages in use are kept in RAM by the OS, so the buffer can be much
+// bigger than the memory one is willing to spend on it, and reopening an existing buffer is instant.
+// The elements must be trivially copyable (see novelpos for instance) since they're stored as raw bytes.
+template<typename T>
+class mapped_ring_buffer {
+	static_assert(std::is_trivially_copyable<T>::value, "the elements of a mapped_ring_buffer must be trivially copyable.");
+
+  public:
+	// opens the buffer stored at path, or creates it if it doesn't exist yet.
+	// Throws a std::runtime_error if an existing buffer has another capacity or element type: the index is
+	// checked first and the files of a buffer with a valid index are never resized.
+	explicit mapped_ring_buffer(const std::string& path, size_t capacity);
+	mapped_ring_buffer(const mapped_ring_buffer<T>& other) = delete;
+	mapped_ring_buffer& operator=(const mapped_ring_buffer<T>& other) = delete;
+	mapped_ring_buffer(mapped_ring_buffer<T>&& other) noexcept = default;
+	mapped_ring_buffer& operator=(mapped_ring_buffer<T>&& other) noexcept = default;
+
+	// add an element and returns true if the oldest element has been overwritten to do so.
+	bool push_back(T value);
+	void clear();
+
+	size_t size() const { return index().size; }
+	size_t capacity() const { return m_capacity; }
+	bool empty() const { return size() == 0; }
+	bool full() const { return size() == m_capacity; }
+
+	// access by age: 0 is the oldest element, size() - 1 the newest.
+	const T& operator[](size_t i) const { return data()[slot_of(oldest_sequence() + i)]; }
+	T& operator[](size_t i) { return storage()[slot_of(oldest_sequence() + i)]; }
+	const T& front() const { return (*this)[0]; }
+	const T& back() const { return (*this)[size() - 1]; }
+
+	// sequence numbers of the stored elements are in [oldest_sequence(), next_sequence()).
+	uint64_t oldest_sequence() const { return index().next_sequence - index().size; }
+	uint64_t next_sequence() const { return index().next_sequence; }
+	bool holds(uint64_t sequence) const { return sequence >= oldest_sequence() && sequence < next_sequence(); }
+	const T& at_sequence(uint64_t sequence) const { return data()[slot_of(sequence)]; }
+	uint64_t sequence_of_slot(size_t slot) const;
+
+	// iterate over the raw storage, which is NOT ordered by age.
+	const T* begin() const { return data(); }
+	const T* end() const { return data() + size(); }
+	const T* data() const { return static_cast<const T*>(m_data.data()); }
+
+	const std::string& path() const { return m_data.path(); }
+
+	// synchronously write the buffer and its index to the disk.
+	void flush() const;
+
+	// the whole mapping is file-backed.
+	memory_report memory_usage() const {
+		memory_report report;
+		report.mapped = m_data.size() + m_index.size();
+		return report;
+	}
+
+	// the content outlives the object: there is no need to serialize it.
+	static constexpr bool persistent = true;
+
+  private:
+	struct index_t {
+		uint64_t magic;
+		uint64_t element_size;
+		uint64_t capacity;
+		uint64_t size;
+		uint64_t next_sequence;
+	};
+
+	static constexpr uint64_t MAGIC = 0x4e4b52494e47ULL; // "NKRING"
+
+	const index_t& index() const { return *static_cast<const index_t*>(m_index.data()); }
+	index_t& index() { return *static_cast<index_t*>(m_index.data()); }
+	T* storage() { return static_cast<T*>(m_data.data()); }
+	size_t slot_of(uint64_t sequence) const { return sequence % m_capacity; }
+
+  private:
+	mapped_file m_index;
+	mapped_file m_data;
+	size_t m_capacity;
+};
+}
+
+#include "impl/mapped_ring_buffer.tpp"
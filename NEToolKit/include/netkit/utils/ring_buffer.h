@@ -0,0 +1,66 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include "netkit/profiling/memory_report.h"
+
+namespace netkit {
+// fixed capacity circular buffer with contiguous storage.
+// The storage is allocated once (capacity elements) and, once full, pushing a new element overwrites the oldest one.
+// Every pushed element gets a sequence number (0 for the first one, 1 for the next one...) which is stored
+// in the slot (sequence % capacity). Thus an element can be referenced by its sequence number as long as it
+// hasn't been overwritten.
+template<typename T>
+class ring_buffer {
+  public:
+	explicit ring_buffer(size_t capacity);
+	ring_buffer(const ring_buffer<T>& other) = default;
+	ring_buffer& operator=(const ring_buffer<T>& other) = default;
+	ring_buffer(ring_buffer<T>&& other) noexcept;
+	ring_buffer& operator=(ring_buffer<T>&& other) noexcept;
+
+	// add an element and returns true if the oldest element has been overwritten to do so.
+	bool push_back(T value);
+	void clear();
+
+	size_t size() const { return m_storage.size(); }
+	size_t capacity() const { return m_capacity; }
+	bool empty() const { return m_storage.empty(); }
+	bool full() const { return m_storage.size() == m_capacity; }
+
+	// access by age: 0 is the oldest element, size() - 1 the newest.
+	const T& operator[](size_t i) const { return m_storage[slot_of(oldest_sequence() + i)]; }
+	T& operator[](size_t i) { return m_storage[slot_of(oldest_sequence() + i)]; }
+	const T& front() const { return (*this)[0]; }
+	const T& back() const { return (*this)[size() - 1]; }
+
+	// sequence numbers of the stored elements are in [oldest_sequence(), next_sequence()).
+	uint64_t oldest_sequence() const { return m_next_sequence - m_storage.size(); }
+	uint64_t next_sequence() const { return m_next_sequence; }
+	bool holds(uint64_t sequence) const { return sequence >= oldest_sequence() && sequence < m_next_sequence; }
+	const T& at_sequence(uint64_t sequence) const { return m_storage[slot_of(sequence)]; }
+	uint64_t sequence_of_slot(size_t slot) const;
+
+	// iterate over the raw storage, which is NOT ordered by age.
+	// Use it for scans where the order doesn't matter (it's the cache friendly way to go).
+	typename std::vector<T>::const_iterator begin() const { return m_storage.cbegin(); }
+	typename std::vector<T>::const_iterator end() const { return m_storage.cend(); }
+	const T* data() const { return m_storage.data(); }
+
+	memory_report memory_usage() const { return vector_memory(m_storage); }
+
+	// the content lives in memory only: it must be serialized to be kept.
+	static constexpr bool persistent = false;
+
+  private:
+	size_t slot_of(uint64_t sequence) const { return sequence % m_capacity; }
+
+  private:
+	std::vector<T> m_storage; // grows until the capacity is reached, then elements are overwritten in place.
+	size_t m_capacity;
+	uint64_t m_next_sequence;
+};
+}
+
+#include "impl/ring_buffer.tpp"
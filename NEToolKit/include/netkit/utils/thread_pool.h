@@ -0,0 +1,50 @@
+#pragma once
+
+#include <deque>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <exception>
+
+namespace netkit {
+// fixed number of worker threads processing the submitted tasks in order.
+// The first exception thrown by a task is kept and rethrown by wait().
+class thread_pool {
+  public:
+	explicit thread_pool(size_t number_of_threads = 0); // 0: one thread per hardware thread
+	thread_pool(const thread_pool& other) = delete;
+	thread_pool& operator=(const thread_pool& other) = delete;
+	~thread_pool(); // finishes the pending tasks
+
+	void submit(std::function<void()> task);
+
+	// block until all the submitted tasks are done.
+	// /!\ not to be called from a task (it would wait for itself).
+	void wait();
+
+	// call func(i) for every i in [0, count), split in contiguous chunks over the workers, and wait for them only
+	// (other pending tasks may still run). The first exception thrown by func is rethrown here.
+	// /!\ not to be called from a task either: the chunks may wait behind it in the queue.
+	template<typename func_t>
+	void parallel_for(size_t count, func_t func);
+
+	size_t size() const { return m_workers.size(); }
+
+  private:
+	void helper_worker_loop();
+
+  private:
+	std::vector<std::thread> m_workers;
+	std::deque<std::function<void()>> m_tasks;
+	std::mutex m_mutex;
+	std::condition_variable m_task_available;
+	std::condition_variable m_all_done;
+	size_t m_unfinished_tasks; // queued or running
+	bool m_stop;
+	std::exception_ptr m_first_error;
+};
+}
+
+#include "impl/thread_pool.tpp"
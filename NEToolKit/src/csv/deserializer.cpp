@@ -6,6 +6,12 @@ netkit::deserializer::deserializer(std::string filename, char separator)
 	m_file.open(filename, std::ios::in);
 }
 
+void netkit::deserializer::get_next(std::string& var, size_t length) {
+	var.assign(length, '\0');
+	m_file.read(&var[0], static_cast<std::streamsize>(length));
+	m_file.get(); // the separator or the end of line after the field.
+}
+
 void netkit::deserializer::skip_line() {
 	while (m_file.get() != '\n') {}
 }
@@ -1,10 +1,43 @@
 #include <utility> // std::move
-#include <stdexcept> // std::invalid_argument
-#include <algorithm> // std::find, std::shuffle
-#include <chrono> // std::chrono::system_clock
+#include <stdexcept> // std::invalid_argument, std::runtime_error
+#include <algorithm> // std::find, std::shuffle, std::max, std::copy
+#include <iterator> // std::begin, std::end
+#include <limits> // std::numeric_limits
+#include <chrono> // std::chrono::system_clock, std::chrono::steady_clock
+#include <sstream> // std::istringstream
+#include <string> // std::string, std::to_string, std::stoul
 
 #include "netkit/neat/base_neat.h"
 #include "netkit/neat/base_population.h"
+#include "netkit/neat/multiobjective.h"
+#include "netkit/profiling/trace.h"
+
+namespace {
+	// the champions are compared on the raw fitness: the multi-objective ranking score only drives the selection.
+	bool is_better_champion(const netkit::genome& candidate, const netkit::genome& champion, bool tie_break) {
+		if (candidate.get_raw_fitness() > champion.get_raw_fitness()) {
+			return true;
+		}
+		if (candidate.get_raw_fitness() < champion.get_raw_fitness() || !tie_break) {
+			return false;
+		}
+		return candidate.get_complexity_cost() < champion.get_complexity_cost();
+	}
+
+	// no structural addition during a pruning phase, more removals.
+	void apply_pruning_probs(netkit::parameters& params) {
+		params.crossover_prob = 0;
+		params.interspecies_crossover_prob = 0;
+		params.mutation_probs[netkit::ADD_LINK] = 0;
+		params.mutation_probs[netkit::ADD_NEURON] = 0;
+		params.mutation_probs[netkit::ADD_CASCADE] = 0;
+		params.mutation_probs[netkit::REENABLE_GENE] = 0;
+		params.mutation_probs[netkit::REMOVE_GENE] = params.pruning_remove_gene_prob;
+		params.mutation_probs[netkit::REMOVE_NEURON] = params.pruning_remove_neuron_prob;
+	}
+}
+
+const unsigned int netkit::base_neat::SERIALIZATION_VERSION = 1;
 
 netkit::base_neat::base_neat(const parameters& params_)
 	: params(params_)
@@ -13,7 +46,27 @@ netkit::base_neat::base_neat(const parameters& params_)
 	, m_best_genomes_library()
 	, m_next_species_id(0)
 	, m_best_genome_ever(nullptr)
-	, m_age_of_best_genome_ever() {
+	, m_age_of_best_genome_ever()
+	, m_last_epoch_timings()
+	, m_recording_timings(false)
+	, m_hardware_counters()
+	, m_last_memory_usage()
+	, m_stats_history(params_.generation_stats_capacity)
+	, m_pending_stats()
+	, m_has_pending_stats(false)
+	, m_number_of_epochs(0)
+	, m_observers()
+	, m_metrics_exporter(nullptr)
+	, m_search_phase(COMPLEXIFYING_PHASE)
+	, m_search_phase_log()
+	, m_complexification_probs()
+	, m_complexification_crossover_prob(0)
+	, m_complexification_interspecies_crossover_prob(0)
+	, m_complexity_ceiling(-1)
+	, m_lowest_mean_genome_size(0)
+	, m_epochs_since_size_decrease(0)
+	, m_best_fitness_seen(0)
+	, m_epochs_since_fitness_improvement(0) {
 	if (this->params.number_of_outputs == 0 || this->params.number_of_inputs == 0) {
 		throw std::invalid_argument("genomes needs at least one input and one output.");
 	}
@@ -32,7 +85,27 @@ netkit::base_neat::base_neat(const base_neat& other)
 	, m_best_genomes_library(other.m_best_genomes_library)
 	, m_next_species_id(other.m_next_species_id)
 	, m_best_genome_ever(new genome{*other.m_best_genome_ever})
-	, m_age_of_best_genome_ever(other.m_age_of_best_genome_ever) {
+	, m_age_of_best_genome_ever(other.m_age_of_best_genome_ever)
+	, m_last_epoch_timings(other.m_last_epoch_timings)
+	, m_recording_timings(false)
+	, m_hardware_counters() // the counters belong to a thread, they are opened again if needed.
+	, m_last_memory_usage(other.m_last_memory_usage)
+	, m_stats_history(other.m_stats_history)
+	, m_pending_stats()
+	, m_has_pending_stats(false)
+	, m_number_of_epochs(other.m_number_of_epochs)
+	, m_observers() // a copy is another run: it has no observer nor exporter.
+	, m_metrics_exporter(nullptr)
+	, m_search_phase(other.m_search_phase)
+	, m_search_phase_log(other.m_search_phase_log)
+	, m_complexification_probs(other.m_complexification_probs)
+	, m_complexification_crossover_prob(other.m_complexification_crossover_prob)
+	, m_complexification_interspecies_crossover_prob(other.m_complexification_interspecies_crossover_prob)
+	, m_complexity_ceiling(other.m_complexity_ceiling)
+	, m_lowest_mean_genome_size(other.m_lowest_mean_genome_size)
+	, m_epochs_since_size_decrease(other.m_epochs_since_size_decrease)
+	, m_best_fitness_seen(other.m_best_fitness_seen)
+	, m_epochs_since_fitness_improvement(other.m_epochs_since_fitness_improvement) {
 	long seed = static_cast<long>(std::chrono::system_clock::now().time_since_epoch().count());
 	rand_engine = std::minstd_rand0(seed);
 }
@@ -45,7 +118,28 @@ netkit::base_neat::base_neat(base_neat&& other) noexcept
 	, m_best_genomes_library(std::move(other.m_best_genomes_library))
 	, m_next_species_id(other.m_next_species_id)
 	, m_best_genome_ever(other.m_best_genome_ever)
-	, m_age_of_best_genome_ever(other.m_age_of_best_genome_ever) {
+	, m_age_of_best_genome_ever(other.m_age_of_best_genome_ever)
+	, m_last_epoch_timings(other.m_last_epoch_timings)
+	, m_recording_timings(false)
+	, m_hardware_counters() // the counters belong to a thread, they are opened again if needed.
+	, m_last_memory_usage(other.m_last_memory_usage)
+	, m_stats_history(std::move(other.m_stats_history))
+	, m_pending_stats()
+	, m_has_pending_stats(false)
+	, m_number_of_epochs(other.m_number_of_epochs)
+	, m_observers(std::move(other.m_observers))
+	, m_metrics_exporter(other.m_metrics_exporter)
+	, m_search_phase(other.m_search_phase)
+	, m_search_phase_log(std::move(other.m_search_phase_log))
+	, m_complexification_probs(std::move(other.m_complexification_probs))
+	, m_complexification_crossover_prob(other.m_complexification_crossover_prob)
+	, m_complexification_interspecies_crossover_prob(other.m_complexification_interspecies_crossover_prob)
+	, m_complexity_ceiling(other.m_complexity_ceiling)
+	, m_lowest_mean_genome_size(other.m_lowest_mean_genome_size)
+	, m_epochs_since_size_decrease(other.m_epochs_since_size_decrease)
+	, m_best_fitness_seen(other.m_best_fitness_seen)
+	, m_epochs_since_fitness_improvement(other.m_epochs_since_fitness_improvement) {
+	other.m_metrics_exporter = nullptr;
 	other.m_best_genome_ever = nullptr;
 }
 
@@ -81,8 +175,66 @@ void netkit::base_neat::init(const genome& initial_genome) {
 }
 
 void netkit::base_neat::epoch() {
+	NETKIT_TRACE_SCOPE("epoch");
+
+	if (params.record_epoch_timings) {
+		m_last_epoch_timings.clear();
+		if (params.record_hardware_counters) {
+			if (!m_hardware_counters) {
+				m_hardware_counters = std::make_unique<perf_counters>();
+			}
+			if (m_hardware_counters->available()) {
+				m_last_epoch_timings.has_counters = true;
+				m_last_epoch_timings.counters_source = m_hardware_counters.get();
+			}
+		}
+		m_last_epoch_timings.has_allocations = params.record_allocations && allocation_hooks_installed();
+		m_recording_timings = true;
+	}
+	m_has_pending_stats = false;
+	auto start = std::chrono::steady_clock::now();
+
+	helper_update_search_phase();
 	impl_epoch();
+
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	if (params.record_epoch_timings) {
+		m_last_epoch_timings.total_seconds = seconds;
+		m_recording_timings = false;
+		m_last_epoch_timings.counters_source = nullptr;
+	}
 	++m_age_of_best_genome_ever;
+
+	if (m_has_pending_stats) {
+		m_pending_stats.generation = m_number_of_epochs;
+		m_pending_stats.compatibility_threshold = params.compatibility_threshold;
+		m_pending_stats.epoch_seconds = seconds;
+		m_stats_history.push_back(m_pending_stats);
+		m_has_pending_stats = false;
+	}
+	NETKIT_NOTIFY(this, on_epoch_completed, m_number_of_epochs);
+	++m_number_of_epochs;
+
+	if (params.record_memory_usage) {
+		m_last_memory_usage = memory_usage();
+	}
+
+	if (m_metrics_exporter != nullptr) {
+		m_metrics_exporter->publish(*this, seconds);
+	}
+}
+
+void netkit::base_neat::add_observer(epoch_observer* observer) {
+	if (!observers_enabled()) {
+		throw std::runtime_error("the observers are never notified: NEToolKit was built without NETKIT_WITH_OBSERVERS.");
+	}
+	if (std::find(m_observers.begin(), m_observers.end(), observer) == m_observers.end()) {
+		m_observers.push_back(observer);
+	}
+}
+
+void netkit::base_neat::remove_observer(epoch_observer* observer) {
+	m_observers.erase(std::remove(m_observers.begin(), m_observers.end(), observer), m_observers.end());
 }
 
 std::optional<netkit::species*> netkit::base_neat::find_appropriate_species_for(const genome& geno) {
@@ -95,11 +247,9 @@ std::optional<netkit::species*> netkit::base_neat::find_appropriate_species_for(
 }
 
 const netkit::genome& netkit::base_neat::get_current_best_genome() const {
-	double best_fitness_so_far =  -1 * std::numeric_limits<double>::max(); // /!\ min() give the minimal positive value for floating types.
 	const genome* champion = nullptr;
 	for (const genome& geno : pop()->get_all_genomes()) {
-		if (geno.get_fitness() > best_fitness_so_far) {
-			best_fitness_so_far = geno.get_fitness();
+		if (champion == nullptr || is_better_champion(geno, *champion, params.complexity_tie_break)) {
 			champion = &geno;
 		}
 	}
@@ -128,16 +278,48 @@ void netkit::base_neat::update_best_genome_ever() {
 	if (m_best_genome_ever == nullptr) {
 		m_best_genome_ever = new genome{ get_current_best_genome() };
 		m_age_of_best_genome_ever = 0;
+		NETKIT_NOTIFY(this, on_champion_improved, *m_best_genome_ever);
 	} else {
 		const genome& current_best_genome = get_current_best_genome();
-		if (current_best_genome.get_fitness() > m_best_genome_ever->get_fitness()) {
+		if (is_better_champion(current_best_genome, *m_best_genome_ever, params.complexity_tie_break)) {
 			delete m_best_genome_ever;
 			m_best_genome_ever = new genome{ current_best_genome };
 			m_age_of_best_genome_ever = 0;
+			NETKIT_NOTIFY(this, on_champion_improved, *m_best_genome_ever);
 		}
 	}
 }
 
+netkit::neat_memory_report netkit::base_neat::memory_usage() const {
+	neat_memory_report report;
+
+	report.population = pop()->memory_usage();
+	report.number_of_genomes = pop()->size();
+	for (const genome& geno : pop()->get_all_genomes()) {
+		report.number_of_genes += geno.get_genes().size();
+	}
+
+	report.species = vector_memory(m_all_species);
+	for (const species& spec : m_all_species) {
+		report.species += spec.memory_usage();
+	}
+
+	report.innovation_pool = innov_pool.memory_usage();
+	report.number_of_innovations = innov_pool.number_of_innovations();
+
+	report.best_genomes = vector_memory(m_best_genomes_library);
+	for (const genome& geno : m_best_genomes_library) {
+		report.best_genomes += geno.memory_usage();
+	}
+	if (m_best_genome_ever != nullptr) {
+		report.best_genomes.used += sizeof(genome);
+		report.best_genomes.reserved += sizeof(genome);
+		report.best_genomes += m_best_genome_ever->memory_usage();
+	}
+
+	return report;
+}
+
 void netkit::base_neat::helper_speciate_all_population() {
 	for (genome_id_t geno_id = 0; geno_id < pop()->size(); ++geno_id) {
 		helper_speciate_one_genome(geno_id);
@@ -151,6 +333,7 @@ void netkit::base_neat::helper_speciate_one_genome(genome_id_t geno_id) {
 	} else {
 		m_all_species.emplace_back(this, pop(), m_next_species_id++, pop()->get_genome(geno_id));
 		m_all_species.back().add_member(geno_id);
+		NETKIT_NOTIFY(this, on_species_created, m_all_species.back());
 	}
 }
 
@@ -164,17 +347,146 @@ void netkit::base_neat::helper_update_best_genomes_library_with(const genome& ge
 	} else {
 		auto worst = std::min_element(m_best_genomes_library.begin(), m_best_genomes_library.end(), [&geno](const genome & g1,
 		const genome & g2) {
-			return g1.get_fitness() < g2.get_fitness();
+			return g1.get_raw_fitness() < g2.get_raw_fitness();
 		});
 
-		if (worst->get_fitness() < geno.get_fitness()) {
+		if (worst->get_raw_fitness() < geno.get_raw_fitness()) {
 			*worst = geno;
 		}
 	}
 }
 
+void netkit::base_neat::helper_record_generation_stats() {
+	if (!params.record_generation_stats) {
+		return;
+	}
+
+	generation_stats row{};
+	double summed_fitnesses = 0;
+	double summed_depths = 0;
+	size_t summed_genome_sizes = 0;
+	size_t number_of_members = 0;
+	size_t number_of_known_depths = 0;
+	bool has_fitness = false;
+	for (const species& spec : m_all_species) {
+		if (spec.empty()) {
+			continue;
+		}
+		// the raw fitnesses, the fitnesses being the ranking scores with multiobjective_ranking.
+		if (!has_fitness || spec.get_best_raw_fitness() > row.best_fitness) {
+			row.best_fitness = spec.get_best_raw_fitness();
+			has_fitness = true;
+		}
+		summed_fitnesses += spec.get_summed_raw_fitnesses();
+		summed_genome_sizes += spec.get_summed_genome_sizes();
+		summed_depths += spec.get_summed_phenotype_depths();
+		number_of_members += spec.number_of_members();
+		number_of_known_depths += spec.get_number_of_known_depths();
+	}
+
+	row.number_of_species = static_cast<uint32_t>(m_all_species.size());
+	row.population_size = static_cast<uint32_t>(number_of_members);
+	if (number_of_members > 0) {
+		row.avg_fitness = summed_fitnesses / static_cast<double>(number_of_members);
+		row.mean_genome_size = static_cast<double>(summed_genome_sizes) / static_cast<double>(number_of_members);
+	}
+	row.mean_phenotype_depth = number_of_known_depths > 0
+							   ? summed_depths / static_cast<double>(number_of_known_depths)
+							   : -1;
+
+	m_pending_stats = row;
+	m_has_pending_stats = true;
+}
+
+void netkit::base_neat::helper_rank_by_objectives() {
+	base_population* population = pop();
+	const size_t number_of_objectives = params.number_of_objectives;
+
+	// gather all the objectives in one contiguous block.
+	std::vector<double> objectives;
+	objectives.reserve(population->size() * number_of_objectives);
+	for (const genome& geno : population->get_all_genomes()) {
+		if (geno.get_objectives().size() != number_of_objectives) {
+			throw std::invalid_argument("a genome has not the expected number of objectives.");
+		}
+		objectives.insert(objectives.end(), geno.get_objectives().begin(), geno.get_objectives().end());
+	}
+
+	std::vector<double> scores = nsga2_scores(objectives, number_of_objectives);
+	for (genome_id_t i = 0, size = population->size(); i < size; ++i) {
+		population->get_genome(i).set_ranking_score(scores[i]);
+	}
+}
+
+void netkit::base_neat::helper_update_search_phase() {
+	if (!params.phased_search || pop()->size() == 0) {
+		return;
+	}
+
+	double summed_genome_sizes = 0;
+	double best_fitness = -1 * std::numeric_limits<double>::max();
+	for (const genome& geno : pop()->get_all_genomes()) {
+		summed_genome_sizes += static_cast<double>(geno.get_genes().size());
+		best_fitness = std::max(best_fitness, geno.get_raw_fitness());
+	}
+	const double mean_genome_size = summed_genome_sizes / static_cast<double>(pop()->size());
+
+	if (m_complexity_ceiling < 0) { // first epoch
+		m_complexity_ceiling = mean_genome_size + params.phased_search_complexity_threshold;
+		m_best_fitness_seen = best_fitness;
+		m_epochs_since_fitness_improvement = 0;
+	} else if (best_fitness > m_best_fitness_seen) {
+		m_best_fitness_seen = best_fitness;
+		m_epochs_since_fitness_improvement = 0;
+	} else {
+		++m_epochs_since_fitness_improvement;
+	}
+
+	if (m_search_phase == COMPLEXIFYING_PHASE) {
+		if (mean_genome_size > m_complexity_ceiling
+			&& m_epochs_since_fitness_improvement >= params.phased_search_fitness_stall) {
+			m_lowest_mean_genome_size = mean_genome_size;
+			m_epochs_since_size_decrease = 0;
+			helper_switch_search_phase(PRUNING_PHASE, mean_genome_size, best_fitness);
+		}
+	} else {
+		if (mean_genome_size < m_lowest_mean_genome_size) {
+			m_lowest_mean_genome_size = mean_genome_size;
+			m_epochs_since_size_decrease = 0;
+		} else {
+			++m_epochs_since_size_decrease;
+		}
+
+		if (m_epochs_since_size_decrease >= params.phased_search_pruning_stall) {
+			m_complexity_ceiling = mean_genome_size + params.phased_search_complexity_threshold;
+			m_epochs_since_fitness_improvement = 0;
+			helper_switch_search_phase(COMPLEXIFYING_PHASE, mean_genome_size, best_fitness);
+		}
+	}
+}
+
+void netkit::base_neat::helper_switch_search_phase(search_phase_t phase, double mean_genome_size,
+												   double best_fitness) {
+	if (phase == PRUNING_PHASE) {
+		m_complexification_probs.assign(std::begin(params.mutation_probs), std::end(params.mutation_probs));
+		m_complexification_crossover_prob = params.crossover_prob;
+		m_complexification_interspecies_crossover_prob = params.interspecies_crossover_prob;
+		apply_pruning_probs(params);
+	} else {
+		std::copy(m_complexification_probs.begin(), m_complexification_probs.end(), params.mutation_probs);
+		m_complexification_probs.clear();
+		params.crossover_prob = m_complexification_crossover_prob;
+		params.interspecies_crossover_prob = m_complexification_interspecies_crossover_prob;
+	}
+
+	m_search_phase = phase;
+	m_search_phase_log.push_back({m_number_of_epochs, phase, mean_genome_size, best_fitness});
+	NETKIT_NOTIFY(this, on_search_phase_changed, m_search_phase_log.back());
+}
+
 void netkit::base_neat::helper_serialize_base_neat(serializer& ser) const {
-	// serialize important values
+	// serialize important values, after the version of the layout.
+	ser.append("v" + std::to_string(base_neat::SERIALIZATION_VERSION));
 	ser.append(m_next_species_id);
 	ser.append(m_age_of_best_genome_ever);
 	ser.append(params.compatibility_threshold);
@@ -205,11 +517,47 @@ void netkit::base_neat::helper_serialize_base_neat(serializer& ser) const {
 
 	// serialize innovation pool
 	ser << innov_pool;
+
+	// serialize the phased search state
+	ser.append(static_cast<int>(m_search_phase));
+	ser.append(m_complexity_ceiling);
+	ser.append(m_lowest_mean_genome_size);
+	ser.append(m_epochs_since_size_decrease);
+	ser.append(m_best_fitness_seen);
+	ser.append(m_epochs_since_fitness_improvement);
+	ser.append(m_complexification_crossover_prob);
+	ser.append(m_complexification_interspecies_crossover_prob);
+	ser.append(m_complexification_probs.size());
+	for (double prob : m_complexification_probs) {
+		ser.append(prob);
+	}
+	ser.new_line();
+	ser.append(m_search_phase_log.size());
+	for (const search_phase_transition& transition : m_search_phase_log) {
+		ser.append(transition.epoch);
+		ser.append(static_cast<int>(transition.phase));
+		ser.append(transition.mean_genome_size);
+		ser.append(transition.best_fitness);
+	}
+	ser.new_line();
 }
 
 void netkit::base_neat::helper_deserialize_base_neat(deserializer& des) {
+	// the original layout has no version and starts directly with the next species id.
+	std::string first_field;
+	des.get_next(first_field);
+	unsigned int version = 0;
+	if (!first_field.empty() && first_field[0] == 'v') {
+		version = static_cast<unsigned int>(std::stoul(first_field.substr(1)));
+		if (version > base_neat::SERIALIZATION_VERSION) {
+			throw std::runtime_error("unknown neat serialization version: " + first_field);
+		}
+		des.get_next(m_next_species_id);
+	} else {
+		std::istringstream(first_field) >> m_next_species_id;
+	}
+
 	// deserialize important values
-	des.get_next(m_next_species_id);
 	des.get_next(m_age_of_best_genome_ever);
 
 	double compat_thres;
@@ -253,4 +601,52 @@ void netkit::base_neat::helper_deserialize_base_neat(deserializer& des) {
 
 	// deserialize the innovation pool
 	des >> innov_pool;
+
+	// deserialize the phased search state. The original layout doesn't have it: the search restarts complexifying.
+	m_search_phase = COMPLEXIFYING_PHASE;
+	m_search_phase_log.clear();
+	m_complexification_probs.clear();
+	m_complexity_ceiling = -1;
+	if (version == 0) {
+		return;
+	}
+
+	int phase;
+	des.get_next(phase);
+	if (phase < 0 || phase >= NUMBER_OF_SEARCH_PHASES) {
+		throw std::runtime_error("unknown search phase: " + std::to_string(phase));
+	}
+	m_search_phase = static_cast<search_phase_t>(phase);
+	des.get_next(m_complexity_ceiling);
+	des.get_next(m_lowest_mean_genome_size);
+	des.get_next(m_epochs_since_size_decrease);
+	des.get_next(m_best_fitness_seen);
+	des.get_next(m_epochs_since_fitness_improvement);
+	des.get_next(m_complexification_crossover_prob);
+	des.get_next(m_complexification_interspecies_crossover_prob);
+	size_t number_of_probs;
+	des.get_next(number_of_probs);
+	m_complexification_probs.resize(number_of_probs);
+	for (double& prob : m_complexification_probs) {
+		des.get_next(prob);
+	}
+
+	size_t number_of_transitions;
+	des.get_next(number_of_transitions);
+	m_search_phase_log.resize(number_of_transitions);
+	for (search_phase_transition& transition : m_search_phase_log) {
+		des.get_next(transition.epoch);
+		des.get_next(phase);
+		transition.phase = static_cast<search_phase_t>(phase);
+		des.get_next(transition.mean_genome_size);
+		des.get_next(transition.best_fitness);
+	}
+
+	// the probabilities of the complexification are the ones of the parameters, the pruning ones are restored.
+	if (m_search_phase == PRUNING_PHASE) {
+		if (m_complexification_probs.size() != NUMBER_OF_MUTATIONS) {
+			throw std::runtime_error("the saved mutation probabilities of the pruning phase are missing.");
+		}
+		apply_pruning_probs(params);
+	}
 }
@@ -14,3 +14,11 @@ netkit::base_population& netkit::base_population::operator=(base_population&& ot
 	m_neat = other.m_neat;
 	return *this;
 }
+
+netkit::memory_report netkit::base_population::memory_usage() const {
+	memory_report report = vector_memory(m_all_genomes);
+	for (const genome& geno : m_all_genomes) {
+		report += geno.memory_usage();
+	}
+	return report;
+}
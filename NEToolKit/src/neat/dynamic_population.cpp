@@ -80,6 +80,10 @@ void netkit::dynamic_population::mark_genome_for_removal(genome_id_t geno_id) {
 	m_lookup_genome_id = geno_id;
 }
 
+netkit::memory_report netkit::dynamic_population::memory_usage() const {
+	return base_population::memory_usage() + vector_overhead(m_marked_for_removal);
+}
+
 netkit::serializer& netkit::operator<<(serializer& ser, const dynamic_population& pop) {
 	ser.append(pop.m_lookup_genome_id);
 	ser.append(pop.m_all_genomes.size());
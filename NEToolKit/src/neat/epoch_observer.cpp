@@ -0,0 +1,9 @@
+#include "netkit/neat/epoch_observer.h"
+
+bool netkit::observers_enabled() {
+#ifdef NETKIT_WITH_OBSERVERS
+	return true;
+#else
+	return false;
+#endif
+}
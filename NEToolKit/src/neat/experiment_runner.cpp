@@ -0,0 +1,242 @@
+#include <mutex>
+#include <chrono>
+#include <cmath> // std::ceil
+#include <stdexcept> // std::invalid_argument, std::runtime_error
+#include <type_traits>
+
+#include "netkit/neat/experiment_runner.h"
+#include "netkit/neat/neat.h"
+#include "netkit/utils/thread_pool.h"
+
+static_assert(std::is_trivially_copyable<netkit::experiment_result>::value, "experiment_result is written as raw bytes.");
+
+namespace {
+	constexpr uint64_t EXPERIMENTS_MAGIC = 0x4e4b455850455253ULL; // "NKEXPERS"
+
+	struct experiments_header {
+		uint64_t magic;
+		uint64_t record_size;
+	};
+
+	uint64_t splitmix64(uint64_t x) {
+		x += 0x9e3779b97f4a7c15ULL;
+		x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+		x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+		return x ^ (x >> 31);
+	}
+
+	netkit::experiment_result perform_run(const netkit::parameters& params, const netkit::experiment_options& options,
+										  const netkit::experiment_rating_function& rate,
+										  size_t configuration, size_t run) {
+		netkit::experiment_result result{};
+		result.configuration = configuration;
+		result.run = run;
+		result.seed = netkit::experiment_seed(options.base_seed, configuration, run);
+
+		auto start = std::chrono::steady_clock::now();
+
+		netkit::neat neat(params);
+		neat.rand_engine.seed(result.seed); // instead of the clock
+		neat.init();
+
+		bool solved = false;
+		while (result.generations < options.max_generations) {
+			++result.generations;
+			solved = rate(neat);
+			neat.update_best_genome_ever();
+			if (solved) {
+				break;
+			}
+			if (result.generations < options.max_generations) {
+				neat.epoch();
+			}
+		}
+
+		result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		result.success = solved ? 1 : 0;
+		result.best_fitness = neat.get_best_fitness_ever();
+		if (neat.has_best_genome_ever()) {
+			result.best_genome_size = static_cast<uint32_t>(neat.get_best_genome_ever()->get_genes().size());
+		}
+		result.number_of_species = neat.get_all_species().size();
+
+		return result;
+	}
+}
+
+// === sinks ===
+
+netkit::csv_experiment_sink::csv_experiment_sink(const std::string& filename)
+	: m_ser(filename, ",") {
+	m_ser.append("configuration");
+	m_ser.append("run");
+	m_ser.append("seed");
+	m_ser.append("success");
+	m_ser.append("generations");
+	m_ser.append("best_fitness");
+	m_ser.append("best_genome_size");
+	m_ser.append("number_of_species");
+	m_ser.append("seconds");
+	m_ser.new_line();
+}
+
+void netkit::csv_experiment_sink::write(const experiment_result& result) {
+	m_ser.append(result.configuration);
+	m_ser.append(result.run);
+	m_ser.append(result.seed);
+	m_ser.append(result.success);
+	m_ser.append(result.generations);
+	m_ser.append(result.best_fitness);
+	m_ser.append(result.best_genome_size);
+	m_ser.append(result.number_of_species);
+	m_ser.append(result.seconds);
+	m_ser.new_line();
+}
+
+netkit::binary_experiment_sink::binary_experiment_sink(const std::string& filename)
+	: m_file(filename, std::ios::binary | std::ios::trunc)
+	, m_filename(filename) {
+	if (!m_file) {
+		throw std::runtime_error("cannot open " + filename + " to write the experiment results.");
+	}
+
+	experiments_header header{EXPERIMENTS_MAGIC, sizeof(experiment_result)};
+	m_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+}
+
+void netkit::binary_experiment_sink::write(const experiment_result& result) {
+	m_file.write(reinterpret_cast<const char*>(&result), sizeof(result));
+	if (!m_file) {
+		throw std::runtime_error("failed to write the experiment results to " + m_filename + ".");
+	}
+}
+
+std::vector<netkit::experiment_result> netkit::read_experiment_results_binary(const std::string& filename) {
+	std::ifstream file(filename, std::ios::binary);
+	if (!file) {
+		throw std::runtime_error("cannot open " + filename + " to read the experiment results.");
+	}
+
+	experiments_header header{};
+	file.read(reinterpret_cast<char*>(&header), sizeof(header));
+	if (!file || header.magic != EXPERIMENTS_MAGIC || header.record_size != sizeof(experiment_result)) {
+		throw std::runtime_error(filename + " is not an experiment results file written by this version.");
+	}
+
+	// the number of records isn't known in advance: read until the end of the file.
+	std::vector<experiment_result> results;
+	experiment_result result{};
+	while (file.read(reinterpret_cast<char*>(&result), sizeof(result))) {
+		results.push_back(result);
+	}
+	if (file.gcount() != 0) {
+		throw std::runtime_error(filename + " is truncated.");
+	}
+
+	return results;
+}
+
+// === summary ===
+
+netkit::experiment_summary::experiment_summary(size_t max_generations)
+	: number_of_runs(0)
+	, number_of_successes(0)
+	, summed_best_fitness(0)
+	, summed_seconds(0)
+	, successes_per_generation(max_generations + 1, 0) {}
+
+void netkit::experiment_summary::add(const experiment_result& result) {
+	++number_of_runs;
+	summed_best_fitness += result.best_fitness;
+	summed_seconds += result.seconds;
+
+	if (result.success != 0) {
+		++number_of_successes;
+		if (result.generations >= successes_per_generation.size()) {
+			successes_per_generation.resize(result.generations + 1, 0);
+		}
+		++successes_per_generation[result.generations];
+	}
+}
+
+double netkit::experiment_summary::success_rate() const {
+	return number_of_runs > 0 ? static_cast<double>(number_of_successes) / static_cast<double>(number_of_runs) : 0;
+}
+
+double netkit::experiment_summary::mean_best_fitness() const {
+	return number_of_runs > 0 ? summed_best_fitness / static_cast<double>(number_of_runs) : 0;
+}
+
+double netkit::experiment_summary::mean_seconds() const {
+	return number_of_runs > 0 ? summed_seconds / static_cast<double>(number_of_runs) : 0;
+}
+
+double netkit::experiment_summary::mean_generations() const {
+	if (number_of_successes == 0) {
+		return 0;
+	}
+
+	double summed_generations = 0;
+	for (size_t generations = 0; generations < successes_per_generation.size(); ++generations) {
+		summed_generations += static_cast<double>(generations * successes_per_generation[generations]);
+	}
+	return summed_generations / static_cast<double>(number_of_successes);
+}
+
+uint64_t netkit::experiment_summary::generations_quantile(double q) const {
+	if (number_of_successes == 0) {
+		return 0;
+	}
+
+	auto rank = static_cast<uint64_t>(std::ceil(q * static_cast<double>(number_of_successes)));
+	rank = rank == 0 ? 1 : rank;
+
+	uint64_t seen = 0;
+	for (size_t generations = 0; generations < successes_per_generation.size(); ++generations) {
+		seen += successes_per_generation[generations];
+		if (seen >= rank) {
+			return generations;
+		}
+	}
+	return successes_per_generation.size() - 1;
+}
+
+// === runner ===
+
+uint64_t netkit::experiment_seed(uint64_t base_seed, size_t configuration, size_t run) {
+	return splitmix64(splitmix64(base_seed + configuration) + run);
+}
+
+std::vector<netkit::experiment_summary> netkit::run_experiments(const std::vector<parameters>& configurations,
+																const experiment_options& options,
+																const experiment_rating_function& rate,
+																experiment_sink* sink) {
+	if (!rate) {
+		throw std::invalid_argument("the experiments need a rating function.");
+	}
+	if (options.max_generations == 0) {
+		throw std::invalid_argument("the experiments need at least one generation.");
+	}
+
+	std::vector<experiment_summary> summaries(configurations.size(), experiment_summary(options.max_generations));
+	std::mutex results_mutex; // protects the summaries and the sink
+
+	// one task per run (rather than parallel_for chunks): the durations of the runs vary a lot.
+	thread_pool pool(options.number_of_threads);
+	for (size_t configuration = 0; configuration < configurations.size(); ++configuration) {
+		for (size_t run = 0; run < options.runs_per_configuration; ++run) {
+			pool.submit([&, configuration, run]() {
+				experiment_result result = perform_run(configurations[configuration], options, rate, configuration, run);
+
+				std::lock_guard<std::mutex> lock(results_mutex);
+				summaries[configuration].add(result);
+				if (sink != nullptr) {
+					sink->write(result);
+				}
+			});
+		}
+	}
+	pool.wait();
+
+	return summaries;
+}
@@ -0,0 +1,257 @@
+#include <algorithm> // std::stable_sort, std::copy, std::max, std::min
+#include <numeric> // std::iota
+#include <chrono> // std::chrono::system_clock
+#include <cmath> // std::ceil, std::log, std::sqrt, std::exp
+#include <limits>
+#include <stdexcept> // std::invalid_argument
+
+#include "netkit/neat/fixed_topology_population.h"
+
+netkit::fixed_topology_population::fixed_topology_population(const genome& champion, const parameters& params_)
+	: fixed_topology_population(champion, params_,
+								static_cast<uint64_t>(std::chrono::system_clock::now().time_since_epoch().count())) {}
+
+netkit::fixed_topology_population::fixed_topology_population(const genome& champion, const parameters& params_,
+															 uint64_t seed)
+	: params(params_)
+	, rand_engine()
+	, m_champion(champion)
+	, m_topology(champion.generate_network())
+	, m_weights()
+	, m_next_weights()
+	, m_fitnesses()
+	, m_mutable()
+	, m_noise()
+	, m_best_weights(m_topology.get_weights())
+	, m_best_fitness(std::numeric_limits<double>::lowest())
+	, m_generation(0)
+	, m_mean()
+	, m_samples()
+	, m_path()
+	, m_recombination_weights()
+	, m_sigma(0) {
+	if (params.initial_population_size == 0) {
+		throw std::invalid_argument("a fixed topology population needs at least one individual.");
+	}
+
+	rand_engine.seed(seed);
+
+	// the frozen genes (see mutate_add_cascade) keep their weights.
+	std::vector<neuron_value_t> mutable_links;
+	for (const gene& g : m_champion.get_genes()) {
+		if (g.enabled) {
+			mutable_links.push_back(g.frozen ? 0 : 1);
+		}
+	}
+	m_mutable = m_topology.to_compiled_order(mutable_links);
+
+	size_t n = number_of_weights();
+	m_fitnesses.assign(params.initial_population_size, 0);
+	m_weights.resize(size() * n);
+	m_noise.resize(n);
+
+	if (params.weight_search == EVOLUTION_STRATEGY) {
+		helper_evolution_strategy_init();
+	} else {
+		// the champion and perturbed copies of it.
+		m_next_weights.resize(size() * n);
+		for (size_t i = 0; i < size(); ++i) {
+			std::copy(m_best_weights.begin(), m_best_weights.end(), get_weights(i));
+			if (i > 0) {
+				helper_perturbate(get_weights(i), params.fixed_topology_weight_mutation_rate,
+								  params.weight_mutation_power);
+			}
+		}
+	}
+}
+
+void netkit::fixed_topology_population::epoch() {
+	helper_update_best_ever();
+
+	if (params.weight_search == EVOLUTION_STRATEGY) {
+		helper_evolution_strategy_epoch();
+	} else {
+		helper_genetic_epoch();
+	}
+
+	std::fill(m_fitnesses.begin(), m_fitnesses.end(), 0);
+	++m_generation;
+}
+
+netkit::genome netkit::fixed_topology_population::get_genome(size_t i) const {
+	genome geno = helper_genome_from(get_weights(i));
+	geno.set_fitness(m_fitnesses[i]);
+	return geno;
+}
+
+netkit::genome netkit::fixed_topology_population::get_best_genome_ever() const {
+	genome geno = helper_genome_from(m_best_weights.data());
+	geno.set_fitness(m_best_fitness);
+	return geno;
+}
+
+netkit::memory_report netkit::fixed_topology_population::memory_usage() const {
+	memory_report report = vector_memory(m_weights) + vector_memory(m_next_weights) + vector_memory(m_fitnesses);
+	report += vector_memory(m_samples) + vector_memory(m_mean) + vector_memory(m_best_weights);
+	report += vector_overhead(m_mutable) + vector_overhead(m_noise) + vector_overhead(m_path)
+			  + vector_overhead(m_recombination_weights);
+	report += m_topology.memory_usage() + m_champion.memory_usage();
+	return report;
+}
+
+void netkit::fixed_topology_population::helper_update_best_ever() {
+	auto best = std::max_element(m_fitnesses.begin(), m_fitnesses.end());
+	if (*best > m_best_fitness) {
+		m_best_fitness = *best;
+		const neuron_value_t* row = get_weights(static_cast<size_t>(best - m_fitnesses.begin()));
+		std::copy(row, row + number_of_weights(), m_best_weights.begin());
+	}
+}
+
+std::vector<size_t> netkit::fixed_topology_population::helper_ranking() const {
+	std::vector<size_t> ranking(size());
+	std::iota(ranking.begin(), ranking.end(), 0);
+	std::stable_sort(ranking.begin(), ranking.end(), [this](size_t a, size_t b) {
+		return m_fitnesses[a] > m_fitnesses[b];
+	});
+	return ranking;
+}
+
+void netkit::fixed_topology_population::helper_genetic_epoch() {
+	std::vector<size_t> ranking = helper_ranking();
+	size_t n = number_of_weights();
+
+	double survivors = std::ceil(params.fixed_topology_survival_rate * static_cast<double>(size()));
+	auto number_of_survivors = static_cast<size_t>(survivors);
+	number_of_survivors = std::min(size(), std::max<size_t>(1, number_of_survivors));
+	size_t number_of_elites = std::min<size_t>(size(), params.fixed_topology_elitism);
+
+	std::uniform_int_distribution<size_t> survivor_selector(0, number_of_survivors - 1);
+	std::bernoulli_distribution crossover_dist(params.crossover_prob);
+	std::uniform_real_distribution<neuron_value_t> blend_dist(0, 1);
+
+	for (size_t child = 0; child < size(); ++child) {
+		neuron_value_t* offspring = m_next_weights.data() + child * n;
+
+		if (child < number_of_elites) {
+			const neuron_value_t* elite = get_weights(ranking[child]);
+			std::copy(elite, elite + n, offspring);
+			continue;
+		}
+
+		const neuron_value_t* mom = get_weights(ranking[survivor_selector(rand_engine)]);
+		if (crossover_dist(rand_engine)) {
+			// blend crossover: a random point of the segment between the parents.
+			const neuron_value_t* dad = get_weights(ranking[survivor_selector(rand_engine)]);
+			neuron_value_t t = blend_dist(rand_engine);
+			for (size_t j = 0; j < n; ++j) {
+				offspring[j] = mom[j] + t * (dad[j] - mom[j]);
+			}
+		} else {
+			std::copy(mom, mom + n, offspring);
+		}
+
+		helper_perturbate(offspring, params.fixed_topology_weight_mutation_rate, params.weight_mutation_power);
+	}
+
+	std::swap(m_weights, m_next_weights);
+}
+
+void netkit::fixed_topology_population::helper_perturbate(neuron_value_t* row, double rate, double power) {
+	std::bernoulli_distribution pick_dist(rate);
+	std::uniform_real_distribution<neuron_value_t> perturbator(-power, power);
+
+	for (neuron_value_t& noise : m_noise) {
+		noise = pick_dist(rand_engine) ? perturbator(rand_engine) : 0;
+	}
+	for (size_t j = 0; j < m_noise.size(); ++j) {
+		row[j] += m_noise[j] * m_mutable[j];
+	}
+}
+
+void netkit::fixed_topology_population::helper_evolution_strategy_init() {
+	// log-linear recombination weights of the best half of the samples.
+	size_t mu = std::max<size_t>(1, size() / 2);
+	double summed_weights = 0;
+	for (size_t i = 0; i < mu; ++i) {
+		m_recombination_weights.push_back(std::log(static_cast<double>(mu) + 0.5)
+										  - std::log(static_cast<double>(i) + 1.0));
+		summed_weights += m_recombination_weights.back();
+	}
+	for (double& w : m_recombination_weights) {
+		w /= summed_weights;
+	}
+
+	m_mean = m_best_weights;
+	m_path.assign(number_of_weights(), 0);
+	m_samples.resize(size() * number_of_weights());
+	m_sigma = params.evolution_strategy_initial_sigma;
+
+	helper_evolution_strategy_sample();
+}
+
+void netkit::fixed_topology_population::helper_evolution_strategy_epoch() {
+	std::vector<size_t> ranking = helper_ranking();
+	size_t n = number_of_weights();
+
+	// weighted mean of the best samples (kept in m_noise).
+	std::fill(m_noise.begin(), m_noise.end(), 0);
+	double mu_eff = 0;
+	for (size_t k = 0; k < m_recombination_weights.size(); ++k) {
+		double w = m_recombination_weights[k];
+		const neuron_value_t* z = m_samples.data() + ranking[k] * n;
+		for (size_t j = 0; j < n; ++j) {
+			m_noise[j] += w * z[j];
+		}
+		mu_eff += w * w;
+	}
+	mu_eff = 1 / mu_eff;
+
+	double dimension = 0; // only the mutable weights are searched
+	for (neuron_value_t m : m_mutable) {
+		dimension += m;
+	}
+
+	if (dimension > 0) {
+		// cumulative step-size adaptation.
+		double c_sigma = (mu_eff + 2) / (dimension + mu_eff + 5);
+		double d_sigma = 1 + 2 * std::max(0.0, std::sqrt((mu_eff - 1) / (dimension + 1)) - 1) + c_sigma;
+		double path_coef = std::sqrt(c_sigma * (2 - c_sigma) * mu_eff);
+
+		double path_norm = 0;
+		for (size_t j = 0; j < n; ++j) {
+			m_mean[j] += m_sigma * m_noise[j];
+			m_path[j] = (1 - c_sigma) * m_path[j] + path_coef * m_noise[j];
+			path_norm += m_path[j] * m_path[j];
+		}
+		path_norm = std::sqrt(path_norm);
+
+		// expected norm of a standard normal vector.
+		double expected_norm = std::sqrt(dimension) * (1 - 1 / (4 * dimension) + 1 / (21 * dimension * dimension));
+		m_sigma *= std::exp((c_sigma / d_sigma) * (path_norm / expected_norm - 1));
+	}
+
+	helper_evolution_strategy_sample();
+}
+
+void netkit::fixed_topology_population::helper_evolution_strategy_sample() {
+	std::normal_distribution<neuron_value_t> normal_dist(0, 1);
+	size_t n = number_of_weights();
+
+	for (size_t i = 0; i < size(); ++i) {
+		neuron_value_t* z = m_samples.data() + i * n;
+		neuron_value_t* x = get_weights(i);
+		for (size_t j = 0; j < n; ++j) {
+			z[j] = normal_dist(rand_engine) * m_mutable[j];
+		}
+		for (size_t j = 0; j < n; ++j) {
+			x[j] = m_mean[j] + m_sigma * z[j];
+		}
+	}
+}
+
+netkit::genome netkit::fixed_topology_population::helper_genome_from(const neuron_value_t* weights) const {
+	genome geno(m_champion);
+	geno.set_link_weights(m_topology.to_link_order(weights));
+	return geno;
+}
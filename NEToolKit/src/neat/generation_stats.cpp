@@ -0,0 +1,93 @@
+#include <fstream>
+#include <stdexcept> // std::runtime_error
+#include <type_traits>
+
+#include "netkit/neat/generation_stats.h"
+#include "netkit/csv/serializer.h"
+
+static_assert(std::is_trivially_copyable<netkit::generation_stats>::value, "generation_stats is written as raw bytes.");
+
+namespace {
+	constexpr uint64_t STATS_MAGIC = 0x4e4b5354415453ULL; // "NKSTATS"
+
+	struct stats_header {
+		uint64_t magic;
+		uint64_t record_size;
+		uint64_t number_of_records;
+	};
+}
+
+void netkit::write_generation_stats_csv(const std::string& filename, const ring_buffer<generation_stats>& history) {
+	serializer ser(filename, ",");
+	ser.append("generation");
+	ser.append("best_fitness");
+	ser.append("avg_fitness");
+	ser.append("number_of_species");
+	ser.append("compatibility_threshold");
+	ser.append("mean_genome_size");
+	ser.append("mean_phenotype_depth");
+	ser.append("epoch_seconds");
+	ser.append("population_size");
+	ser.new_line();
+
+	for (size_t i = 0; i < history.size(); ++i) {
+		const generation_stats& row = history[i];
+		ser.append(row.generation);
+		ser.append(row.best_fitness);
+		ser.append(row.avg_fitness);
+		ser.append(row.number_of_species);
+		ser.append(row.compatibility_threshold);
+		ser.append(row.mean_genome_size);
+		ser.append(row.mean_phenotype_depth);
+		ser.append(row.epoch_seconds);
+		ser.append(row.population_size);
+		ser.new_line();
+	}
+	ser.close();
+}
+
+void netkit::write_generation_stats_binary(const std::string& filename, const ring_buffer<generation_stats>& history) {
+	std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+	if (!file) {
+		throw std::runtime_error("cannot open " + filename + " to write the stats history.");
+	}
+
+	stats_header header{STATS_MAGIC, sizeof(generation_stats), history.size()};
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+	// the storage isn't ordered by age: once full, the oldest element is in the slot of the next sequence number.
+	size_t oldest_slot = 0;
+	if (!history.empty() && history.full()) {
+		oldest_slot = history.next_sequence() % history.capacity();
+	}
+	file.write(reinterpret_cast<const char*>(history.data() + oldest_slot),
+			   static_cast<std::streamsize>((history.size() - oldest_slot) * sizeof(generation_stats)));
+	file.write(reinterpret_cast<const char*>(history.data()),
+			   static_cast<std::streamsize>(oldest_slot * sizeof(generation_stats)));
+
+	if (!file) {
+		throw std::runtime_error("failed to write the stats history to " + filename + ".");
+	}
+}
+
+std::vector<netkit::generation_stats> netkit::read_generation_stats_binary(const std::string& filename) {
+	std::ifstream file(filename, std::ios::binary);
+	if (!file) {
+		throw std::runtime_error("cannot open " + filename + " to read the stats history.");
+	}
+
+	stats_header header{};
+	file.read(reinterpret_cast<char*>(&header), sizeof(header));
+	if (!file || header.magic != STATS_MAGIC || header.record_size != sizeof(generation_stats)) {
+		throw std::runtime_error(filename + " is not a stats history written by this version.");
+	}
+
+	std::vector<generation_stats> rows(header.number_of_records);
+	file.read(reinterpret_cast<char*>(rows.data()),
+			  static_cast<std::streamsize>(rows.size() * sizeof(generation_stats)));
+	if (!file) {
+		throw std::runtime_error(filename + " is truncated.");
+	}
+
+	return rows;
+}
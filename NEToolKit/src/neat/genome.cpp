@@ -2,23 +2,35 @@
 #include <algorithm> // find, shuffle
 #include <numeric> // iota
 #include <random>
+#include <sstream> // std::istringstream
+#include <stdexcept> // std::invalid_argument, std::runtime_error
+#include <string>
 
 #include "netkit/network/activation_functions.h"
 #include "netkit/network/network_primitive_types.h"
 #include "netkit/neat/base_neat.h"
 #include "netkit/neat/genome.h"
 #include "netkit/neat/innovation.h"
+#include "netkit/profiling/trace.h"
+#include "netkit/profiling/allocation_tracker.h"
 
 const netkit::neuron_id_t netkit::genome::BIAS_ID = 0;
+// 1: the raw fitness, the objectives and the known output and hidden neurons with their neuron genes.
+const unsigned int netkit::genome::SERIALIZATION_VERSION = 1;
 
 netkit::genome::genome(base_neat* neat_instance)
 	: m_number_of_inputs(neat_instance->params.number_of_inputs)
 	, m_number_of_outputs(neat_instance->params.number_of_outputs)
 	, m_genes()
 	, m_known_neuron_ids()
+	, m_neuron_genes()
 	, m_neat(neat_instance)
 	, m_fitness(0)
-	, m_adjusted_fitness(0) {
+	, m_adjusted_fitness(0)
+	, m_raw_fitness(0)
+	, m_objectives()
+	, m_phenotype_depth(-1)
+	, m_evaluation_time(-1) {
 	m_known_neuron_ids.push_back(BIAS_ID);
 
 	for (neuron_id_t i = 0; i < m_number_of_inputs; i++) {
@@ -28,6 +40,10 @@ netkit::genome::genome(base_neat* neat_instance)
 	for (neuron_id_t i = 0; i < m_number_of_outputs; i++) {
 		m_known_neuron_ids.push_back(i + 1 + m_number_of_inputs);
 	}
+
+	const neuron_gene output_gene = {neat_instance->params.output_activation_function,
+									 neat_instance->params.ctrnn_initial_time_constant, 0};
+	m_neuron_genes.assign(m_known_neuron_ids.size(), output_gene);
 }
 
 netkit::genome::genome(genome&& other) noexcept
@@ -35,18 +51,28 @@ netkit::genome::genome(genome&& other) noexcept
 	, m_number_of_outputs(other.m_number_of_outputs)
 	, m_genes(std::move(other.m_genes))
 	, m_known_neuron_ids(std::move(other.m_known_neuron_ids))
+	, m_neuron_genes(std::move(other.m_neuron_genes))
 	, m_neat(other.m_neat)
 	, m_fitness(other.m_fitness)
-	, m_adjusted_fitness(other.m_adjusted_fitness) {}
+	, m_adjusted_fitness(other.m_adjusted_fitness)
+	, m_raw_fitness(other.m_raw_fitness)
+	, m_objectives(std::move(other.m_objectives))
+	, m_phenotype_depth(other.m_phenotype_depth)
+	, m_evaluation_time(other.m_evaluation_time) {}
 
 netkit::genome& netkit::genome::operator=(genome&& other) noexcept {
 	m_number_of_inputs = other.m_number_of_inputs;
 	m_number_of_outputs = other.m_number_of_outputs;
 	m_genes = std::move(other.m_genes);
 	m_known_neuron_ids = std::move(other.m_known_neuron_ids);
+	m_neuron_genes = std::move(other.m_neuron_genes);
 	m_neat = other.m_neat;
 	m_fitness = other.m_fitness;
 	m_adjusted_fitness = other.m_adjusted_fitness;
+	m_raw_fitness = other.m_raw_fitness;
+	m_objectives = std::move(other.m_objectives);
+	m_phenotype_depth = other.m_phenotype_depth;
+	m_evaluation_time = other.m_evaluation_time;
 
 	return *this;
 }
@@ -70,13 +96,21 @@ bool netkit::genome::operator==(const genome& other) {
 }
 
 void netkit::genome::add_gene(gene new_gene) {
-	// if this genes refers to an unknown neuron, add it to the known neurons list.
+	m_phenotype_depth = -1;
+	m_evaluation_time = -1;
+
+	// if this genes refers to an unknown neuron, add it to the known neurons list (it is a hidden neuron).
+	const std::vector<activation_function_t>& functions = m_neat->params.hidden_activation_functions;
+	const neuron_gene new_neuron_gene = {functions.empty() ? STEEPENED_SIGMOID_ACTIVATION : functions.front(),
+										 m_neat->params.ctrnn_initial_time_constant, 0};
 	if (std::find(m_known_neuron_ids.begin(), m_known_neuron_ids.end(), new_gene.from) == m_known_neuron_ids.end()) {
 		m_known_neuron_ids.push_back(new_gene.from);
+		m_neuron_genes.push_back(new_neuron_gene);
 	}
 
 	if (std::find(m_known_neuron_ids.begin(), m_known_neuron_ids.end(), new_gene.to) == m_known_neuron_ids.end()) {
 		m_known_neuron_ids.push_back(new_gene.to);
+		m_neuron_genes.push_back(new_neuron_gene);
 	}
 
 	// make sure the genes are sorted by innovation number.
@@ -160,6 +194,7 @@ netkit::genome netkit::genome::get_random_mutation() const {
 
 	offspring.set_fitness(0);
 	offspring.set_adjusted_fitness(0);
+	offspring.m_objectives.clear();
 
 	return std::move(offspring);
 }
@@ -209,6 +244,12 @@ bool netkit::genome::random_mutate() {
 			case PERTURBATE_WEIGHTS:
 				return_value |= mutate_weights();
 				break;
+			case CHANGE_ACTIVATION:
+				return_value |= mutate_change_activation();
+				break;
+			case PERTURBATE_NEURON_PARAMS:
+				return_value |= mutate_neuron_params();
+				break;
 			default: // should not happen
 				break;
 			}
@@ -237,8 +278,10 @@ bool netkit::genome::mutate_add_link() {
 
 	std::uniform_real_distribution<netkit::neuron_value_t> perturbator(-m_neat->params.initial_weight_perturbation,
 																	   m_neat->params.initial_weight_perturbation);
-	std::optional<gene> existing_gene =
-		m_neat->innov_pool.find_gene(m_known_neuron_ids[from], m_known_neuron_ids[to]);
+	std::optional<gene> existing_gene = [&]() {
+		phase_scope scope(m_neat->current_timings(), INNOVATION_LOOKUP);
+		return m_neat->innov_pool.find_gene(m_known_neuron_ids[from], m_known_neuron_ids[to]);
+	}();
 	if (existing_gene.has_value()) {
 		gene copied_gene(*existing_gene);
 		copied_gene.weight = perturbator(m_neat->rand_engine);
@@ -247,11 +290,9 @@ bool netkit::genome::mutate_add_link() {
 		gene new_gene(m_neat->innov_pool.next_innovation(), m_known_neuron_ids[from], m_known_neuron_ids[to],
 					  perturbator(m_neat->rand_engine));
 		m_neat->innov_pool.register_gene(new_gene);
-		m_neat->innov_pool.register_innovation(innovation::new_link_innovation(
-												   new_gene.innov_num,
-												   new_gene.from,
-												   new_gene.to
-											   ));
+		innovation new_innov = innovation::new_link_innovation(new_gene.innov_num, new_gene.from, new_gene.to);
+		m_neat->innov_pool.register_innovation(new_innov);
+		NETKIT_NOTIFY(m_neat, on_new_innovation, new_innov);
 		add_gene(new_gene);
 	}
 
@@ -278,8 +319,10 @@ bool netkit::genome::mutate_add_neuron() {
 
 	m_genes[sel_idx].enabled = false;
 
-	std::optional<innovation> existing_innovation =
-		m_neat->innov_pool.find_innovation(NEW_NEURON, m_genes[sel_idx].from, m_genes[sel_idx].to);
+	std::optional<innovation> existing_innovation = [&]() {
+		phase_scope scope(m_neat->current_timings(), INNOVATION_LOOKUP);
+		return m_neat->innov_pool.find_innovation(NEW_NEURON, m_genes[sel_idx].from, m_genes[sel_idx].to);
+	}();
 
 	if (existing_innovation.has_value()) {
 		// this existing innovation already occurred in this genome.
@@ -304,13 +347,15 @@ bool netkit::genome::mutate_add_neuron() {
 
 		m_neat->innov_pool.register_gene(new_gene_1);
 		m_neat->innov_pool.register_gene(new_gene_2);
-		m_neat->innov_pool.register_innovation(innovation::new_neuron_innovation(
-												   new_gene_1.innov_num,
-												   new_gene_2.innov_num,
-												   m_genes[sel_idx].from,
-												   m_genes[sel_idx].to,
-												   new_neuron_id
-											   ));
+		innovation new_innov = innovation::new_neuron_innovation(
+								   new_gene_1.innov_num,
+								   new_gene_2.innov_num,
+								   m_genes[sel_idx].from,
+								   m_genes[sel_idx].to,
+								   new_neuron_id
+							   );
+		m_neat->innov_pool.register_innovation(new_innov);
+		NETKIT_NOTIFY(m_neat, on_new_innovation, new_innov);
 
 		add_gene(new_gene_1);
 		add_gene(new_gene_2);
@@ -363,12 +408,15 @@ bool netkit::genome::mutate_remove_neuron() {
 
 	std::uniform_int_distribution<size_t> neuron_selector(m_number_of_inputs + m_number_of_outputs + 1,
 														  m_known_neuron_ids.size() - 1);
-	neuron_id_t selected_neuron = m_known_neuron_ids[neuron_selector(m_neat->rand_engine)];
-	m_known_neuron_ids.erase(std::remove(m_known_neuron_ids.begin(), m_known_neuron_ids.end(), selected_neuron),
-							 m_known_neuron_ids.end());
+	size_t selected_idx = neuron_selector(m_neat->rand_engine);
+	neuron_id_t selected_neuron = m_known_neuron_ids[selected_idx];
+	m_known_neuron_ids.erase(m_known_neuron_ids.begin() + selected_idx);
+	m_neuron_genes.erase(m_neuron_genes.begin() + selected_idx);
 	m_genes.erase(std::remove_if(m_genes.begin(), m_genes.end(), [&selected_neuron](const gene & g) {
 		return g.from == selected_neuron || g.to == selected_neuron;
 	}), m_genes.end());
+	m_phenotype_depth = -1;
+	m_evaluation_time = -1;
 
 	return true;
 }
@@ -386,6 +434,8 @@ bool netkit::genome::mutate_reenable_gene() {
 	} else {
 		std::uniform_int_distribution<size_t> candidate_selector(0, candidates.size() - 1);
 		candidates[candidate_selector(m_neat->rand_engine)]->enabled = true;
+		m_phenotype_depth = -1;
+		m_evaluation_time = -1;
 		return true;
 	}
 }
@@ -399,6 +449,8 @@ bool netkit::genome::mutate_toggle_enable() {
 	std::uniform_int_distribution<size_t> gene_selector(0, candidates_idx.size() - 1);
 	size_t rnd_val = gene_selector(m_neat->rand_engine);
 	m_genes[candidates_idx[rnd_val]].enabled = !m_genes[candidates_idx[rnd_val]].enabled;
+	m_phenotype_depth = -1;
+	m_evaluation_time = -1;
 
 	return true;
 }
@@ -446,11 +498,70 @@ bool netkit::genome::mutate_remove_gene() {
 
 	std::uniform_int_distribution<size_t> gene_selector(0, candidates_idx.size() - 1);
 	m_genes.erase(m_genes.begin() + candidates_idx[gene_selector(m_neat->rand_engine)]);
+	m_phenotype_depth = -1;
+	m_evaluation_time = -1;
 	// TODO: check if a neuron goes unknown afterward. /!\ do not remove bias, input and output neurons.
 
 	return true;
 }
 
+bool netkit::genome::mutate_change_activation() {
+	const std::vector<activation_function_t>& functions = m_neat->params.hidden_activation_functions;
+	const size_t first_hidden = m_number_of_inputs + m_number_of_outputs + 1;
+	if (m_known_neuron_ids.size() == first_hidden || functions.size() < 2) {
+		return false;
+	}
+
+	std::uniform_int_distribution<size_t> neuron_selector(first_hidden, m_known_neuron_ids.size() - 1);
+	size_t selected_idx = neuron_selector(m_neat->rand_engine);
+
+	// another function than the current one.
+	std::vector<activation_function_t> candidates;
+	for (activation_function_t func : functions) {
+		if (func != m_neuron_genes[selected_idx].activation) {
+			candidates.push_back(func);
+		}
+	}
+	if (candidates.empty()) {
+		return false;
+	}
+
+	std::uniform_int_distribution<size_t> function_selector(0, candidates.size() - 1);
+	m_neuron_genes[selected_idx].activation = candidates[function_selector(m_neat->rand_engine)];
+
+	return true;
+}
+
+bool netkit::genome::mutate_neuron_params() {
+	// the outputs and the hidden neurons.
+	const size_t first_output = m_number_of_inputs + 1;
+	if (m_known_neuron_ids.size() == first_output) {
+		return false;
+	}
+
+	std::vector<size_t> candidates_idx(m_known_neuron_ids.size() - first_output);
+	std::iota(candidates_idx.begin(), candidates_idx.end(), first_output);
+	std::shuffle(candidates_idx.begin(), candidates_idx.end(), m_neat->rand_engine);
+
+	std::uniform_int_distribution<size_t> nb_neurons_selector(1, candidates_idx.size());
+	size_t nb_neurons = nb_neurons_selector(m_neat->rand_engine);
+
+	const parameters& params = m_neat->params;
+	std::uniform_real_distribution<neuron_value_t> time_constant_perturbator(-params.time_constant_mutation_power,
+																			 params.time_constant_mutation_power);
+	std::uniform_real_distribution<neuron_value_t> bias_perturbator(-params.bias_mutation_power,
+																	params.bias_mutation_power);
+	for (size_t i = 0; i < nb_neurons; ++i) {
+		neuron_gene& ng = m_neuron_genes[candidates_idx[i]];
+		ng.time_constant += time_constant_perturbator(m_neat->rand_engine);
+		ng.time_constant = std::max<neuron_value_t>(params.ctrnn_min_time_constant, ng.time_constant);
+		ng.time_constant = std::min<neuron_value_t>(params.ctrnn_max_time_constant, ng.time_constant);
+		ng.bias += bias_perturbator(m_neat->rand_engine);
+	}
+
+	return true;
+}
+
 netkit::genome netkit::genome::random_crossover(const genome& other) const {
 	std::uniform_int_distribution<unsigned int> crossover_selector(0, m_neat->params.sum_all_crossover_weights() - 1);
 	unsigned int rnd_val = crossover_selector(m_neat->rand_engine);
@@ -501,6 +612,8 @@ netkit::genome netkit::genome::crossover_multipoint_avg(const genome& other) con
 }
 
 netkit::network netkit::genome::generate_network() const {
+	NETKIT_TRACE_SCOPE("generate_network");
+	allocation_scope alloc_scope(ALLOC_GENERATE_NETWORK);
 	network net;
 
 	// we need to map the genome neuron ids to
@@ -509,18 +622,23 @@ netkit::network netkit::genome::generate_network() const {
 
 	ids_map.emplace(BIAS_ID, network::BIAS_ID);
 
+	const bool lookup_tables = m_neat->params.activation_lookup_tables;
+	const activation_func_t output_activation = activation_function(m_neat->params.output_activation_function,
+																	lookup_tables);
+
 	for (size_t i = 0; i < m_number_of_inputs; i++) {
 		neuron_id_t net_neuron_id = net.add_neuron(INPUT, neuron(&steepened_sigmoid));
 		ids_map.emplace(i + 1, net_neuron_id);
 	}
 
 	for (size_t i = 0; i < m_number_of_outputs; i++) {
-		neuron_id_t net_neuron_id = net.add_neuron(OUTPUT, neuron(&steepened_sigmoid));
+		neuron_id_t net_neuron_id = net.add_neuron(OUTPUT, neuron(output_activation));
 		ids_map.emplace(i + m_number_of_inputs + 1, net_neuron_id);
 	}
 
 	for (size_t i = m_number_of_inputs + m_number_of_outputs + 1; i < m_known_neuron_ids.size(); i++) {
-		neuron_id_t net_neuron_id = net.add_neuron(HIDDEN, neuron(&steepened_sigmoid));
+		neuron_id_t net_neuron_id = net.add_neuron(HIDDEN, neuron(activation_function(m_neuron_genes[i].activation,
+												   lookup_tables)));
 		ids_map.emplace(m_known_neuron_ids[i], net_neuron_id);
 	}
 
@@ -532,9 +650,137 @@ netkit::network netkit::genome::generate_network() const {
 		}
 	}
 
+	if (m_phenotype_depth < 0 && (m_neat->params.record_generation_stats || m_neat->params.complexity_cost == MACS_COST)) {
+		m_phenotype_depth = net.max_depth();
+	}
+
 	return std::move(net);
 }
 
+double netkit::genome::get_complexity_cost() const {
+	size_t enabled_links = 0;
+	for (const gene& g : m_genes) {
+		if (g.enabled) {
+			++enabled_links;
+		}
+	}
+
+	switch (m_neat->params.complexity_cost) {
+	case LINKS_COST:
+		return static_cast<double>(enabled_links);
+	case NEURONS_COST:
+		return static_cast<double>(m_known_neuron_ids.size() - m_number_of_inputs - 1);
+	case MACS_COST:
+		if (m_phenotype_depth < 0) {
+			m_phenotype_depth = generate_network().max_depth();
+		}
+		return static_cast<double>(enabled_links) * m_phenotype_depth;
+	case EVALUATION_TIME_COST:
+		return m_evaluation_time < 0 ? 0 : m_evaluation_time;
+	default:
+		return 0;
+	}
+}
+
+bool netkit::genome::is_fitter_than(const genome& other) const {
+	if (m_fitness > other.m_fitness) {
+		return true;
+	}
+	if (m_fitness < other.m_fitness || !m_neat->params.complexity_tie_break) {
+		return false;
+	}
+	return get_complexity_cost() < other.get_complexity_cost();
+}
+
+netkit::ctrnn netkit::genome::generate_ctrnn() const {
+	// the network ids are the indices of the known neurons (see generate_network).
+	std::vector<neuron_value_t> time_constants(m_known_neuron_ids.size());
+	std::vector<neuron_value_t> biases(m_known_neuron_ids.size());
+	for (size_t i = 0; i < m_known_neuron_ids.size(); ++i) {
+		time_constants[i] = m_neuron_genes[i].time_constant;
+		biases[i] = m_neuron_genes[i].bias;
+	}
+
+	return ctrnn(generate_network(), time_constants, biases, m_neat->params.ctrnn_time_step,
+				 m_neat->params.ctrnn_integration);
+}
+
+std::vector<netkit::neuron_value_t> netkit::genome::get_link_weights() const {
+	std::vector<neuron_value_t> weights;
+	weights.reserve(m_genes.size());
+	for (const gene& g : m_genes) {
+		if (g.enabled) {
+			weights.push_back(g.weight);
+		}
+	}
+	return weights;
+}
+
+void netkit::genome::set_link_weights(const std::vector<neuron_value_t>& weights) {
+	size_t i = 0;
+	for (const gene& g : m_genes) {
+		i += g.enabled ? 1 : 0;
+	}
+	if (i != weights.size()) {
+		throw std::invalid_argument("the number of weights doesn't match the number of enabled genes.");
+	}
+
+	i = 0;
+	for (gene& g : m_genes) {
+		if (g.enabled) {
+			g.weight = weights[i++];
+		}
+	}
+}
+
+netkit::activation_function_t netkit::genome::get_activation(neuron_id_t hidden_neuron) const {
+	return m_neuron_genes[helper_neuron_index(hidden_neuron, m_number_of_inputs + m_number_of_outputs + 1)].activation;
+}
+
+void netkit::genome::set_activation(neuron_id_t hidden_neuron, activation_function_t func) {
+	m_neuron_genes[helper_neuron_index(hidden_neuron, m_number_of_inputs + m_number_of_outputs + 1)].activation = func;
+}
+
+netkit::neuron_value_t netkit::genome::get_time_constant(neuron_id_t neuron) const {
+	return m_neuron_genes[helper_neuron_index(neuron, m_number_of_inputs + 1)].time_constant;
+}
+
+void netkit::genome::set_time_constant(neuron_id_t neuron, neuron_value_t time_constant) {
+	if (!(time_constant > 0)) {
+		throw std::invalid_argument("the time constants must be positive.");
+	}
+	m_neuron_genes[helper_neuron_index(neuron, m_number_of_inputs + 1)].time_constant = time_constant;
+}
+
+netkit::neuron_value_t netkit::genome::get_bias(neuron_id_t neuron) const {
+	return m_neuron_genes[helper_neuron_index(neuron, m_number_of_inputs + 1)].bias;
+}
+
+void netkit::genome::set_bias(neuron_id_t neuron, neuron_value_t bias) {
+	m_neuron_genes[helper_neuron_index(neuron, m_number_of_inputs + 1)].bias = bias;
+}
+
+size_t netkit::genome::helper_neuron_index(neuron_id_t neuron, size_t first_index) const {
+	auto it = std::find(m_known_neuron_ids.begin() + first_index, m_known_neuron_ids.end(), neuron);
+	if (it == m_known_neuron_ids.end()) {
+		throw std::invalid_argument("unknown neuron (or a neuron without this attribute).");
+	}
+	return static_cast<size_t>(it - m_known_neuron_ids.begin());
+}
+
+void netkit::genome::helper_inherit_neuron_genes(const genome& first_parent, const genome& second_parent) {
+	for (size_t i = m_number_of_inputs + 1; i < m_known_neuron_ids.size(); ++i) {
+		for (const genome* parent : {&first_parent, &second_parent}) {
+			auto it = std::find(parent->m_known_neuron_ids.begin(), parent->m_known_neuron_ids.end(),
+								m_known_neuron_ids[i]);
+			if (it != parent->m_known_neuron_ids.end()) {
+				m_neuron_genes[i] = parent->m_neuron_genes[it - parent->m_known_neuron_ids.begin()];
+				break;
+			}
+		}
+	}
+}
+
 std::vector<size_t> netkit::genome::helper_generate_candidate_idx() {
 	std::vector<size_t> candidates_idx;
 	candidates_idx.reserve(m_genes.size());
@@ -552,6 +798,11 @@ bool netkit::genome::reenable_gene_ok() const {
 	return distrib(m_neat->rand_engine);
 }
 
+netkit::memory_report netkit::genome::memory_usage() const {
+	return vector_memory(m_genes) + vector_memory(m_neuron_genes) + vector_memory(m_objectives)
+		   + vector_overhead(m_known_neuron_ids);
+}
+
 std::ostream& netkit::operator<<(std::ostream& os, const genome& genome) {
 	os << "<genome: (fitness = " << genome.m_fitness << ") "
 	   << genome.m_number_of_inputs << " input(s) "
@@ -569,11 +820,17 @@ std::ostream& netkit::operator<<(std::ostream& os, const genome& genome) {
 netkit::serializer& netkit::operator<<(serializer& ser, const genome& genome) {
 	// The number of inputs and outputs depends on the NEAT parameters and the NEAT class is required to build
 	// a genome, so we will assume these don't need to be serialized.
-	// No need to serialize the known neurons as well since the list can be reconstructed from the genes.
+	// The known output and hidden neurons are serialized with their neuron genes, orphans included.
 
-	// serialize fitness values
+	// serialize fitness values, after the version of the layout.
+	ser.append("v" + std::to_string(genome::SERIALIZATION_VERSION));
 	ser.append(genome.m_fitness);
 	ser.append(genome.m_adjusted_fitness);
+	ser.append(genome.m_raw_fitness);
+	ser.append(genome.m_objectives.size());
+	for (double objective : genome.m_objectives) {
+		ser.append(objective);
+	}
 	ser.new_line();
 
 	// serialize genes
@@ -583,18 +840,60 @@ netkit::serializer& netkit::operator<<(serializer& ser, const genome& genome) {
 		ser << g;
 	}
 
+	// serialize the neuron genes of the output and hidden neurons
+	const size_t first_output = genome.m_number_of_inputs + 1;
+	ser.append(genome.m_known_neuron_ids.size() - first_output);
+	for (size_t i = first_output; i < genome.m_known_neuron_ids.size(); ++i) {
+		ser.append(genome.m_known_neuron_ids[i]);
+		ser.append(static_cast<int>(genome.m_neuron_genes[i].activation));
+		ser.append(genome.m_neuron_genes[i].time_constant);
+		ser.append(genome.m_neuron_genes[i].bias);
+	}
+	ser.new_line();
+
 	return ser;
 }
 
 netkit::deserializer& netkit::operator>>(netkit::deserializer& des, genome& genome) {
+	// the original layout has no version and starts directly with the fitness.
+	std::string first_field;
+	des.get_next(first_field);
+	unsigned int version = 0;
+	if (!first_field.empty() && first_field[0] == 'v') {
+		version = static_cast<unsigned int>(std::stoul(first_field.substr(1)));
+		if (version > genome::SERIALIZATION_VERSION) {
+			throw std::runtime_error("unknown genome serialization version: " + first_field);
+		}
+		des.get_next(genome.m_fitness);
+	} else {
+		std::istringstream(first_field) >> genome.m_fitness;
+	}
+
 	// deserialize fitness values
-	des.get_next(genome.m_fitness);
 	des.get_next(genome.m_adjusted_fitness);
+	genome.m_objectives.clear();
+	if (version >= 1) {
+		des.get_next(genome.m_raw_fitness);
+		size_t number_of_objectives;
+		des.get_next(number_of_objectives);
+		genome.m_objectives.resize(number_of_objectives);
+		for (double& objective : genome.m_objectives) {
+			des.get_next(objective);
+		}
+	} else {
+		genome.m_raw_fitness = genome.m_fitness;
+	}
 
 	// deserialize genes
 	size_t number_of_genes;
 	des.get_next(number_of_genes);
-	genome.m_genes.clear();
+	std::vector<gene> genes;
+	genes.reserve(number_of_genes);
+	for (size_t i = 0; i < number_of_genes; ++i) {
+		gene g(0, 0, 0, 0);
+		des >> g;
+		genes.push_back(g);
+	}
 
 	// clean known neurons list.
 	genome.m_known_neuron_ids.clear();
@@ -602,14 +901,38 @@ netkit::deserializer& netkit::operator>>(netkit::deserializer& des, genome& geno
 	for (neuron_id_t i = 0; i < genome.m_number_of_inputs; i++) {
 		genome.m_known_neuron_ids.push_back(i + 1);
 	}
-	for (neuron_id_t i = 0; i < genome.m_number_of_outputs; i++) {
-		genome.m_known_neuron_ids.push_back(i + 1 + genome.m_number_of_inputs);
+	const neuron_gene output_gene = {genome.m_neat->params.output_activation_function,
+									 genome.m_neat->params.ctrnn_initial_time_constant, 0};
+	genome.m_neuron_genes.assign(genome.m_known_neuron_ids.size(), output_gene);
+
+	if (version == 0) {
+		// the known neurons are reconstructed from the genes, with the default neuron genes.
+		for (neuron_id_t i = 0; i < genome.m_number_of_outputs; i++) {
+			genome.m_known_neuron_ids.push_back(i + 1 + genome.m_number_of_inputs);
+			genome.m_neuron_genes.push_back(output_gene);
+		}
+	} else {
+		// the output and hidden neurons in their original order, with their neuron genes. A hidden neuron
+		// may have lost all its genes (see mutate_remove_gene): it stays known, as in the serialized genome.
+		size_t number_of_neurons;
+		des.get_next(number_of_neurons);
+		for (size_t i = 0; i < number_of_neurons; ++i) {
+			neuron_id_t nid;
+			int func;
+			neuron_gene ng;
+			des.get_next(nid);
+			des.get_next(func);
+			des.get_next(ng.time_constant);
+			des.get_next(ng.bias);
+			ng.activation = static_cast<activation_function_t>(func);
+			genome.m_known_neuron_ids.push_back(nid);
+			genome.m_neuron_genes.push_back(ng);
+		}
 	}
 
+	genome.m_genes.clear();
 	genome.m_genes.reserve(number_of_genes);
-	for (size_t i = 0; i < number_of_genes; ++i) {
-		gene g(0, 0, 0, 0);
-		des >> g;
+	for (const gene& g : genes) {
 		genome.add_gene(g);
 	}
 
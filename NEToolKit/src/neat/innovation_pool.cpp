@@ -52,6 +52,10 @@ void netkit::innovation_pool::clear() {
 	m_all_genes.clear();
 }
 
+netkit::memory_report netkit::innovation_pool::memory_usage() const {
+	return vector_memory(m_all_genes) + vector_memory(m_all_innovations);
+}
+
 netkit::serializer& netkit::operator<<(serializer& ser, const innovation_pool& innov_pool) {
 	// serialize useful variables
 	ser.append(innov_pool.m_next_innovation);
@@ -0,0 +1,145 @@
+#include <algorithm> // std::sort, std::max_element
+#include <numeric> // std::iota
+#include <limits> // std::numeric_limits
+#include <cmath> // std::isinf
+#include <stdexcept> // std::invalid_argument
+
+#include "netkit/neat/multiobjective.h"
+
+namespace {
+	bool dominates(const double* a, const double* b, size_t number_of_objectives) {
+		bool strictly_better = false;
+		for (size_t m = 0; m < number_of_objectives; ++m) {
+			if (a[m] < b[m]) {
+				return false;
+			}
+			if (a[m] > b[m]) {
+				strictly_better = true;
+			}
+		}
+		return strictly_better;
+	}
+}
+
+std::vector<unsigned int> netkit::non_dominated_sort(const std::vector<double>& objectives,
+													 size_t number_of_objectives) {
+	if (number_of_objectives == 0 || objectives.size() % number_of_objectives != 0) {
+		throw std::invalid_argument("the number of objective values is not a multiple of the number of objectives.");
+	}
+
+	const size_t number_of_individuals = objectives.size() / number_of_objectives;
+	auto obj = [&](size_t i) { return &objectives[i * number_of_objectives]; };
+
+	// lexicographic order, best first: an individual can only be dominated by the ones before it.
+	std::vector<size_t> order(number_of_individuals);
+	std::iota(order.begin(), order.end(), 0);
+	std::sort(order.begin(), order.end(), [&](size_t i, size_t j) {
+		return std::lexicographical_compare(obj(j), obj(j) + number_of_objectives, obj(i), obj(i) + number_of_objectives);
+	});
+
+	std::vector<unsigned int> fronts(number_of_individuals, 0);
+	std::vector<std::vector<size_t>> all_fronts; // members of each front in insertion order
+
+	auto dominated_by_front = [&](size_t i, const std::vector<size_t>& front) -> bool {
+		if (number_of_objectives == 2) {
+			// within a front, the first objective decreases so the second one increases:
+			// if anyone dominates i, the last member does.
+			return dominates(obj(front.back()), obj(i), 2);
+		}
+
+		// the last members are the closest ones in the lexicographic order, so start with them.
+		for (auto it = front.rbegin(); it != front.rend(); ++it) {
+			if (dominates(obj(*it), obj(i), number_of_objectives)) {
+				return true;
+			}
+		}
+		return false;
+	};
+
+	for (size_t i : order) {
+		// being dominated by a front means being dominated by all the previous ones, so binary search
+		// the first front that doesn't dominate i.
+		size_t low = 0;
+		size_t high = all_fronts.size();
+		while (low < high) {
+			size_t middle = (low + high) / 2;
+			if (dominated_by_front(i, all_fronts[middle])) {
+				low = middle + 1;
+			} else {
+				high = middle;
+			}
+		}
+
+		if (low == all_fronts.size()) {
+			all_fronts.emplace_back();
+		}
+		all_fronts[low].push_back(i);
+		fronts[i] = static_cast<unsigned int>(low);
+	}
+
+	return fronts;
+}
+
+std::vector<double> netkit::crowding_distances(const std::vector<double>& objectives, size_t number_of_objectives,
+											   const std::vector<unsigned int>& fronts) {
+	const size_t number_of_individuals = fronts.size();
+	std::vector<double> distances(number_of_individuals, 0.0);
+	if (number_of_individuals == 0) {
+		return distances;
+	}
+
+	// group the individuals by front.
+	unsigned int number_of_fronts = *std::max_element(fronts.begin(), fronts.end()) + 1;
+	std::vector<std::vector<size_t>> members(number_of_fronts);
+	for (size_t i = 0; i < number_of_individuals; ++i) {
+		members[fronts[i]].push_back(i);
+	}
+
+	const double infinity = std::numeric_limits<double>::infinity();
+	for (std::vector<size_t>& front : members) {
+		if (front.size() <= 2) {
+			for (size_t i : front) {
+				distances[i] = infinity;
+			}
+			continue;
+		}
+
+		for (size_t m = 0; m < number_of_objectives; ++m) {
+			auto value = [&](size_t i) { return objectives[i * number_of_objectives + m]; };
+
+			std::sort(front.begin(), front.end(), [&](size_t i, size_t j) { return value(i) < value(j); });
+			distances[front.front()] = infinity;
+			distances[front.back()] = infinity;
+
+			double range = value(front.back()) - value(front.front());
+			if (range <= 0) {
+				continue;
+			}
+
+			for (size_t k = 1; k + 1 < front.size(); ++k) {
+				distances[front[k]] += (value(front[k + 1]) - value(front[k - 1])) / range;
+			}
+		}
+	}
+
+	return distances;
+}
+
+std::vector<double> netkit::nsga2_scores(const std::vector<double>& objectives, size_t number_of_objectives) {
+	std::vector<unsigned int> fronts = non_dominated_sort(objectives, number_of_objectives);
+	std::vector<double> distances = crowding_distances(objectives, number_of_objectives, fronts);
+
+	std::vector<double> scores(fronts.size(), 0.0);
+	if (fronts.empty()) {
+		return scores;
+	}
+
+	unsigned int number_of_fronts = *std::max_element(fronts.begin(), fronts.end()) + 1;
+	for (size_t i = 0; i < fronts.size(); ++i) {
+		// the crowding distance is squashed into [0, 0.5] so it never overtakes the front.
+		double crowding = std::isinf(distances[i]) ? 1.0 : distances[i] / (1.0 + distances[i]);
+		scores[i] = static_cast<double>(number_of_fronts - fronts[i]) + 0.5 * crowding;
+	}
+
+	return scores;
+}
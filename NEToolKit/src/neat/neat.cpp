@@ -1,6 +1,8 @@
 #include <utility> // std::move
 
 #include "netkit/neat/neat.h"
+#include "netkit/profiling/trace.h"
+#include "netkit/profiling/allocation_tracker.h"
 
 netkit::neat::neat(const parameters& params_)
 	: base_neat(params_)
@@ -26,6 +28,10 @@ netkit::organism netkit::neat::generate_and_get_next_organism() {
 		throw std::runtime_error("attempted to generate the next organism even though all organisms have already been generated.");
 	}
 
+	if (m_metrics_exporter != nullptr) {
+		m_metrics_exporter->add_evaluations(1);
+	}
+
 	genome& geno = m_population[m_next_genome_id];
 	return {&m_population, m_next_genome_id++, geno.generate_network()};
 }
@@ -44,132 +50,172 @@ void netkit::neat::impl_init(const genome& initial_genome) {
 void netkit::neat::impl_epoch() {
 	// initialize generation-specific variables
 	m_next_genome_id = 0;
+	epoch_timings* timings = current_timings(); // nullptr if not recording
 
 	// Compute the overall average fitness.
 	species* best_species = nullptr;
 	double best_fitness_so_far = -1 * std::numeric_limits<double>::max();
 	double overall_average = 0;
-	for (species& spec : m_all_species) {
-		spec.sort_by_fitness();
-		spec.share_fitness();
-		spec.update_stats();
-		overall_average += spec.get_summed_adjusted_fitnesses();
-		if (spec.get_best_fitness() > best_fitness_so_far) {
-			best_fitness_so_far = spec.get_best_fitness();
-			best_species = &spec;
-		}
-	}
-	overall_average /= static_cast<double>(m_population.size());
-
-	// Compute the expected number of offsprings for each species.
-	unsigned int total_expected_offsprings = 0;
-	for (species& spec : m_all_species) {
-		unsigned int this_species_expected_offsprings;
-		if (spec.get_age() - spec.get_age_of_last_improvement() >= params.no_reproduction_threshold) {
-			// if a species doesn't improve for "extinction threshold" generations it goes extinct.
-			this_species_expected_offsprings = 0;
-		} else {
-			this_species_expected_offsprings = static_cast<unsigned int>(spec.get_summed_adjusted_fitnesses() / overall_average);
+	{
+		phase_scope scope(timings, SPECIES_STATS);
+
+		// the species and genitors selection rely on the fitness, so turn the objectives into it first.
+		if (params.multiobjective_ranking) {
+			helper_rank_by_objectives();
 		}
 
-		spec.set_expected_offsprings(this_species_expected_offsprings);
-		total_expected_offsprings += this_species_expected_offsprings;
+		for (species& spec : m_all_species) {
+			spec.sort_by_fitness();
+			spec.share_fitness();
+			spec.update_stats();
+			overall_average += spec.get_summed_adjusted_fitnesses();
+			if (spec.get_best_fitness() > best_fitness_so_far) {
+				best_fitness_so_far = spec.get_best_fitness();
+				best_species = &spec;
+			}
+		}
+		overall_average /= static_cast<double>(m_population.size());
+		helper_record_generation_stats();
 	}
 
 	auto next_generation_pop_size = static_cast<unsigned int>(m_population.size()); // TODO: dynamic population?
 
-	// Need to make up for lost floating point precision in offsprings assignation
-	// by giving the missing offsprings to the current best species.
-	best_species->set_expected_offsprings(
-		best_species->get_expected_offsprings() + next_generation_pop_size - total_expected_offsprings
-	);
+	{
+		phase_scope scope(timings, OFFSPRING_ALLOCATION);
+
+		// Compute the expected number of offsprings for each species.
+		unsigned int total_expected_offsprings = 0;
+		for (species& spec : m_all_species) {
+			unsigned int this_species_expected_offsprings;
+			if (spec.get_age() - spec.get_age_of_last_improvement() >= params.no_reproduction_threshold) {
+				// if a species doesn't improve for "extinction threshold" generations it goes extinct.
+				this_species_expected_offsprings = 0;
+			} else {
+				this_species_expected_offsprings = static_cast<unsigned int>(spec.get_summed_adjusted_fitnesses() / overall_average);
+			}
+
+			spec.set_expected_offsprings(this_species_expected_offsprings);
+			total_expected_offsprings += this_species_expected_offsprings;
+		}
+
+		// Need to make up for lost floating point precision in offsprings assignation
+		// by giving the missing offsprings to the current best species.
+		best_species->set_expected_offsprings(
+			best_species->get_expected_offsprings() + next_generation_pop_size - total_expected_offsprings
+		);
+	}
 
 	// Build the next generation offsprings.
 	std::vector<genome> offsprings;
 	offsprings.reserve(next_generation_pop_size);
-	std::uniform_real_distribution<double> prob(0.0, 1.0);
-	std::uniform_int_distribution<size_t> species_selector(0, m_all_species.size() - 1);
-	for (species& spec : m_all_species) {
-		unsigned int offsprings_produced = 0;
-
-		// keep the champion of species with 5 or more members
-		if (offsprings_produced < spec.get_expected_offsprings()
-			&& spec.number_of_members() >= 5) { // TODO: externalize in parameters
-			if (params.use_best_genomes_library) {
-				// update genome library using the champion of the species.
-				helper_update_best_genomes_library_with(m_population.get_genome(spec.get_champion()));
-			}
-			offsprings.emplace_back(m_population.get_genome(spec.get_champion()));
-			++offsprings_produced;
-		}
-
-		while (offsprings_produced < spec.get_expected_offsprings()) {
-			++offsprings_produced;
-			genome* genitor = &m_population.get_genome(spec.select_one_genitor());
-
-			// if using the best genomes library.
-			bool replacement_occured = false;
-			if (!m_best_genomes_library.empty() && genitor->get_fitness() < params.bad_genome_max_fitness
-				&& prob(rand_engine) < params.replace_bad_genes_using_best_genomes_library_prob) {
-				auto good_geno = get_random_genome_from_best_genome_library();
-				if (good_geno->get_fitness() > genitor->get_fitness()) {
-					offsprings.push_back(*good_geno);
-					replacement_occured = true;
+	{
+		phase_scope scope(timings, REPRODUCTION);
+
+		std::uniform_real_distribution<double> prob(0.0, 1.0);
+		std::uniform_int_distribution<size_t> species_selector(0, m_all_species.size() - 1);
+		for (species& spec : m_all_species) {
+			unsigned int offsprings_produced = 0;
+
+			// keep the champion of species with 5 or more members
+			if (offsprings_produced < spec.get_expected_offsprings()
+				&& spec.number_of_members() >= 5) { // TODO: externalize in parameters
+				if (params.use_best_genomes_library) {
+					// update genome library using the champion of the species.
+					helper_update_best_genomes_library_with(m_population.get_genome(spec.get_champion()));
 				}
+				offsprings.emplace_back(m_population.get_genome(spec.get_champion()));
+				++offsprings_produced;
 			}
 
-			if (!replacement_occured) {
-				if (prob(rand_engine) < params.crossover_prob) { // let's go for a crossover
-					genome* genitor2 = nullptr;
-
-					// interspecies crossover prob
-					if (prob(rand_engine) < params.interspecies_crossover_prob) {
-						unsigned long rnd_spec_val = species_selector(rand_engine);
-						genitor2 = &m_population.get_genome(m_all_species[rnd_spec_val].select_one_genitor());
-					} else {
-						genitor2 = &m_population.get_genome(spec.select_one_genitor());
+			while (offsprings_produced < spec.get_expected_offsprings()) {
+				++offsprings_produced;
+				genome* genitor = &m_population.get_genome(spec.select_one_genitor());
+
+				// if using the best genomes library.
+				bool replacement_occured = false;
+				if (!m_best_genomes_library.empty() && genitor->get_raw_fitness() < params.bad_genome_max_fitness
+					&& prob(rand_engine) < params.replace_bad_genes_using_best_genomes_library_prob) {
+					auto good_geno = get_random_genome_from_best_genome_library();
+					if (good_geno->get_raw_fitness() > genitor->get_raw_fitness()) {
+						offsprings.push_back(*good_geno);
+						replacement_occured = true;
 					}
+				}
 
-					// mutate the offspring or not
-					if (prob(rand_engine) < params.mutation_during_crossover_prob) {
-						offsprings.push_back(genitor->random_crossover(*genitor2).get_random_mutation());
+				if (!replacement_occured) {
+					if (prob(rand_engine) < params.crossover_prob) { // let's go for a crossover
+						genome* genitor2 = nullptr;
+
+						// interspecies crossover prob
+						if (prob(rand_engine) < params.interspecies_crossover_prob) {
+							unsigned long rnd_spec_val = species_selector(rand_engine);
+							genitor2 = &m_population.get_genome(m_all_species[rnd_spec_val].select_one_genitor());
+						} else {
+							genitor2 = &m_population.get_genome(spec.select_one_genitor());
+						}
+
+						// mutate the offspring or not, drawn before the crossover to keep the random sequence of a seed.
+						bool mutate = prob(rand_engine) < params.mutation_during_crossover_prob;
+						genome offspring = [&]() {
+							phase_scope crossover_scope(timings, CROSSOVER);
+							return genitor->random_crossover(*genitor2);
+						}();
+
+						if (mutate) {
+							phase_scope mutation_scope(timings, MUTATION);
+							offspring = offspring.get_random_mutation();
+						}
+						offsprings.push_back(std::move(offspring));
 					} else {
-						offsprings.push_back(genitor->random_crossover(*genitor2));
+						phase_scope mutation_scope(timings, MUTATION);
+						offsprings.push_back(genitor->get_random_mutation());
 					}
-				} else {
-					offsprings.push_back(genitor->get_random_mutation());
 				}
 			}
 		}
 	}
 
-	// prepare the species for the next generation
-	// Can't be performed in the previous loop since init_for_next_gen method clear the members for
-	// next speciation, and we need the members for interspecies crossovers.
-	for (species& spec : m_all_species) {
-		spec.init_for_next_gen(params.keep_same_representant_for_species
-							   ? spec.get_representant()
-							   : m_population.get_genome(spec.get_random_member()));
-	}
+	{
+		phase_scope scope(timings, RESPECIATION);
+
+		// prepare the species for the next generation
+		// Can't be performed in the previous loop since init_for_next_gen method clear the members for
+		// next speciation, and we need the members for interspecies crossovers.
+		for (species& spec : m_all_species) {
+			spec.init_for_next_gen(params.keep_same_representant_for_species
+								   ? spec.get_representant()
+								   : m_population.get_genome(spec.get_random_member()));
+		}
 
-	// update the population with the new offsprings.
-	m_population.clear(); // just in case...
-	m_population.set_genomes(std::move(offsprings));
+		// update the population with the new offsprings.
+		m_population.clear(); // just in case...
+		m_population.set_genomes(std::move(offsprings));
 
-	// finally speciate the population
-	helper_speciate_all_population();
+		// finally speciate the population
+		helper_speciate_all_population();
+	}
+
+	{
+		phase_scope scope(timings, EXTINCTION);
 
-	// remove species that has no more member. They go extinct!
-	m_all_species.erase(
-	std::remove_if(m_all_species.begin(), m_all_species.end(), [](const species & s) {
-		return s.empty();
-	}),
-	m_all_species.end()
-	);
-	// /!\ from now, best_species pointer may be invalid!!!
+		// remove species that has no more member. They go extinct!
+		m_all_species.erase(
+		std::remove_if(m_all_species.begin(), m_all_species.end(), [&](const species & s) {
+			if (!s.empty()) {
+				return false;
+			}
+			NETKIT_NOTIFY(this, on_species_extinct, s);
+			return true;
+		}),
+		m_all_species.end()
+		);
+		// /!\ from now, best_species pointer may be invalid!!!
+	}
 
 	// adjust the compatibility threshold if it is dynamic.
 	if (params.dynamic_compatibility_threshold) {
+		phase_scope scope(timings, THRESHOLD_ADJUSTMENT);
+
 		if (m_all_species.size() > params.target_number_of_species) {
 			params.compatibility_threshold += params.compatibility_threshold_change_step;
 		} else if (m_all_species.size() < params.target_number_of_species) {
@@ -191,6 +237,9 @@ const netkit::base_population* netkit::neat::pop() const {
 }
 
 netkit::serializer& netkit::operator<<(serializer& ser, const neat& n) {
+	NETKIT_TRACE_SCOPE("serialize_neat");
+	allocation_scope alloc_scope(ALLOC_SERIALIZATION);
+
 	n.helper_serialize_base_neat(ser);
 
 	// serialize next_genome_id
@@ -204,6 +253,9 @@ netkit::serializer& netkit::operator<<(serializer& ser, const neat& n) {
 }
 
 netkit::deserializer& netkit::operator>>(deserializer& des, neat& n) {
+	NETKIT_TRACE_SCOPE("deserialize_neat");
+	allocation_scope alloc_scope(ALLOC_SERIALIZATION);
+
 	n.helper_deserialize_base_neat(des);
 
 	// serialize next_genome_id
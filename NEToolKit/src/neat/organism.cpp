@@ -39,6 +39,14 @@ void netkit::organism::set_fitness(double value) const {
 	m_population->get_genome(m_genome_id).set_fitness(value);
 }
 
+void netkit::organism::set_objectives(std::vector<double> objectives) const {
+	m_population->get_genome(m_genome_id).set_objectives(std::move(objectives));
+}
+
+void netkit::organism::set_evaluation_time(double seconds) const {
+	m_population->get_genome(m_genome_id).set_evaluation_time(seconds);
+}
+
 netkit::tick_t netkit::organism::get_time_alive() const {
 	return m_time_alive;
 }
@@ -2,6 +2,8 @@
 #include <chrono>
 
 #include "netkit/neat/rtneat.h"
+#include "netkit/profiling/trace.h"
+#include "netkit/profiling/allocation_tracker.h"
 
 netkit::rtneat::rtneat(const parameters& params_)
 	: base_neat(params_)
@@ -27,6 +29,10 @@ void netkit::rtneat::generate_all_organisms() {
 	for (genome_id_t i = 0, size = m_population.size(); i < size; ++i) {
 		m_all_organisms.emplace_back(&m_population, i, m_population[i].generate_network());
 	}
+
+	if (m_metrics_exporter != nullptr) {
+		m_metrics_exporter->add_evaluations(m_population.size());
+	}
 }
 
 std::vector<netkit::organism>& netkit::rtneat::get_all_organisms() {
@@ -54,21 +60,29 @@ void netkit::rtneat::impl_epoch() {
 		return;
 	}
 
+	epoch_timings* timings = current_timings(); // nullptr if not recording
+
 	// first step: compute the adjusted fitness of every genomes
-	for (species& spec : m_all_species) {
-		spec.share_fitness();
+	{
+		phase_scope scope(timings, SPECIES_STATS);
+		for (species& spec : m_all_species) {
+			spec.share_fitness();
+		}
 	}
 
 	// second step: pick the worst genome
 	genome_id_t worst_genome = 0;
 	bool found_candidate = false;
-	double worst_fitness = std::numeric_limits<double>::max();
-	for (genome_id_t gen_id = 0; gen_id < m_population.size(); ++gen_id) {
-		if (m_population[gen_id].get_fitness() < worst_fitness
-			&& m_all_organisms[gen_id].get_time_alive() > params.minmum_alive_time_before_being_replaced) {
-			worst_genome = gen_id;
-			worst_fitness = m_population[gen_id].get_fitness();
-			found_candidate = true;
+	{
+		phase_scope scope(timings, OFFSPRING_ALLOCATION);
+		double worst_fitness = std::numeric_limits<double>::max();
+		for (genome_id_t gen_id = 0; gen_id < m_population.size(); ++gen_id) {
+			if (m_population[gen_id].get_fitness() < worst_fitness
+				&& m_all_organisms[gen_id].get_time_alive() > params.minmum_alive_time_before_being_replaced) {
+				worst_genome = gen_id;
+				worst_fitness = m_population[gen_id].get_fitness();
+				found_candidate = true;
+			}
 		}
 	}
 
@@ -76,16 +90,20 @@ void netkit::rtneat::impl_epoch() {
 		// third step: remove the worst genome from its species and calculate the new adjusted fitness of its members.
 		// (at the same time, compute the total of all species fitness average for next step)
 		double summed_average = 0;
-		for (species& spec : m_all_species) {
-			if (spec.has(worst_genome)) {
-				spec.remove_member(worst_genome);
-				spec.share_fitness();
+		{
+			phase_scope scope(timings, SPECIES_STATS);
+			for (species& spec : m_all_species) {
+				if (spec.has(worst_genome)) {
+					spec.remove_member(worst_genome);
+					spec.share_fitness();
+				}
+				spec.update_stats();
+				spec.sort_by_fitness();
+				summed_average += spec.get_avg_adjusted_fitness();
 			}
-			spec.update_stats();
-			spec.sort_by_fitness();
-			summed_average += spec.get_avg_adjusted_fitness();
+			summed_average /= static_cast<double>(m_population.size());
+			helper_record_generation_stats();
 		}
-		summed_average /= static_cast<double>(m_population.size());
 
 		// fourth step: select species for reproduction
 		std::uniform_real_distribution<double> prob(0.0, 1.0);
@@ -95,32 +113,45 @@ void netkit::rtneat::impl_epoch() {
 			double selection_probability = spec.get_avg_adjusted_fitness() / summed_average;
 			if (rnd_val <= spec.get_avg_adjusted_fitness() / summed_average) {
 				// we have a winner!
+				{
+					phase_scope reproduction_scope(timings, REPRODUCTION);
 
-				if (prob(rand_engine) < params.crossover_prob) { // let's go for a crossover
-					genome* genitor1 = &m_population.get_genome(spec.select_one_genitor());
-					genome* genitor2 = nullptr;
+					if (prob(rand_engine) < params.crossover_prob) { // let's go for a crossover
+						genome* genitor1 = &m_population.get_genome(spec.select_one_genitor());
+						genome* genitor2 = nullptr;
 
-					// interspecies crossover prob
-					if (prob(rand_engine) < params.interspecies_crossover_prob) {
-						unsigned long rnd_spec_val = species_selector(rand_engine);
-						genitor2 = &m_population.get_genome(m_all_species[rnd_spec_val].select_one_genitor());
-					} else {
-						genitor2 = &m_population.get_genome(spec.select_one_genitor());
-					}
+						// interspecies crossover prob
+						if (prob(rand_engine) < params.interspecies_crossover_prob) {
+							unsigned long rnd_spec_val = species_selector(rand_engine);
+							genitor2 = &m_population.get_genome(m_all_species[rnd_spec_val].select_one_genitor());
+						} else {
+							genitor2 = &m_population.get_genome(spec.select_one_genitor());
+						}
+
+						// mutate the offspring or not, drawn before the crossover to keep the random sequence of a seed.
+						bool mutate = prob(rand_engine) < params.mutation_during_crossover_prob;
+						genome offspring = [&]() {
+							phase_scope crossover_scope(timings, CROSSOVER);
+							return genitor1->random_crossover(*genitor2);
+						}();
 
-					// mutate the offspring or not
-					if (prob(rand_engine) < params.mutation_during_crossover_prob) {
-						m_population.replace_genome(worst_genome, genitor1->random_crossover(*genitor2).get_random_mutation());
+						if (mutate) {
+							phase_scope mutation_scope(timings, MUTATION);
+							offspring = offspring.get_random_mutation();
+						}
+						m_population.replace_genome(worst_genome, std::move(offspring));
 					} else {
-						m_population.replace_genome(worst_genome, genitor1->random_crossover(*genitor2));
+						genome* genitor = &m_population.get_genome(spec.select_one_genitor());
+						phase_scope mutation_scope(timings, MUTATION);
+						m_population.replace_genome(worst_genome, genitor->get_random_mutation());
 					}
-				} else {
-					genome* genitor = &m_population.get_genome(spec.select_one_genitor());
-					m_population.replace_genome(worst_genome, genitor->get_random_mutation());
 				}
 
 				// speciate the new offspring
-				helper_speciate_one_genome(worst_genome);
+				{
+					phase_scope respeciation_scope(timings, RESPECIATION);
+					helper_speciate_one_genome(worst_genome);
+				}
 
 				break; // stop iterating
 			} else {
@@ -133,24 +164,37 @@ void netkit::rtneat::impl_epoch() {
 
 		// fifth step: reorganize species and adjust the compatibility threshold if it is dynamic.
 		if (m_nb_replacements_performed % params.number_of_replacements_before_species_reorganization == 0) {
-			for (species& spec : m_all_species) {
-				if (!spec.empty()) { // the species could be empty. It will be deleted later.
-					// If this check is not performed, there is a segfault for trying to get member in an empty set.
-					spec.init_for_next_gen(m_population.get_genome(spec.get_random_member()));
+			{
+				phase_scope scope(timings, RESPECIATION);
+				for (species& spec : m_all_species) {
+					if (!spec.empty()) { // the species could be empty. It will be deleted later.
+						// If this check is not performed, there is a segfault for trying to get member in an empty set.
+						spec.init_for_next_gen(m_population.get_genome(spec.get_random_member()));
+					}
 				}
+
+				helper_speciate_all_population();
 			}
 
-			helper_speciate_all_population();
+			{
+				phase_scope scope(timings, EXTINCTION);
 
-			// remove species that has no more member. They go extinct!
-			m_all_species.erase(
-			std::remove_if(m_all_species.begin(), m_all_species.end(), [](const species & s) {
-				return s.empty();
-			}),
-			m_all_species.end()
-			);
+				// remove species that has no more member. They go extinct!
+				m_all_species.erase(
+				std::remove_if(m_all_species.begin(), m_all_species.end(), [&](const species & s) {
+					if (!s.empty()) {
+						return false;
+					}
+					NETKIT_NOTIFY(this, on_species_extinct, s);
+					return true;
+				}),
+				m_all_species.end()
+				);
+			}
 
 			if (params.dynamic_compatibility_threshold) {
+				phase_scope scope(timings, THRESHOLD_ADJUSTMENT);
+
 				// adjust the compatibility threshold
 				if (m_all_species.size() > params.target_number_of_species) {
 					params.compatibility_threshold += params.compatibility_threshold_change_step;
@@ -165,6 +209,10 @@ void netkit::rtneat::impl_epoch() {
 		m_replaced_genome_id = worst_genome;
 		m_all_organisms[m_replaced_genome_id] = organism(&m_population, m_replaced_genome_id,
 														 m_population[m_replaced_genome_id].generate_network());
+		NETKIT_NOTIFY(this, on_replacement, m_replaced_genome_id);
+		if (m_metrics_exporter != nullptr) {
+			m_metrics_exporter->add_evaluations(1);
+		}
 	} else {
 		m_replacement_occured = false;
 	}
@@ -178,7 +226,19 @@ const netkit::base_population* netkit::rtneat::pop() const {
 	return &m_population;
 }
 
+netkit::neat_memory_report netkit::rtneat::memory_usage() const {
+	neat_memory_report report = base_neat::memory_usage();
+	report.organisms = vector_memory(m_all_organisms);
+	for (const organism& org : m_all_organisms) {
+		report.organisms += org.memory_usage();
+	}
+	return report;
+}
+
 netkit::serializer& netkit::operator<<(serializer& ser, const rtneat& n) {
+	NETKIT_TRACE_SCOPE("serialize_rtneat");
+	allocation_scope alloc_scope(ALLOC_SERIALIZATION);
+
 	n.helper_serialize_base_neat(ser);
 
 	// serialize population
@@ -188,6 +248,9 @@ netkit::serializer& netkit::operator<<(serializer& ser, const rtneat& n) {
 }
 
 netkit::deserializer& netkit::operator>>(deserializer& des, rtneat& n) {
+	NETKIT_TRACE_SCOPE("deserialize_rtneat");
+	allocation_scope alloc_scope(ALLOC_SERIALIZATION);
+
 	n.helper_deserialize_base_neat(des);
 
 	// deserialize population
@@ -1,10 +1,19 @@
-#include <algorithm> // std::sort, std::find
+#include <algorithm> // std::sort, std::find, std::max
 #include <limits> // std::numeric_limits
 
 #include "netkit/neat/species.h"
 #include "netkit/neat/base_neat.h"
 #include "netkit/neat/base_population.h"
 
+namespace {
+	// a member with the keys of genome::is_fitter_than.
+	struct ranked_member {
+		netkit::genome_id_t id;
+		double fitness;
+		double cost;
+	};
+}
+
 netkit::species::species(base_neat* neat_instance, base_population* population, species_id_t id,
 						 const genome& representant)
 	: m_members()
@@ -14,6 +23,11 @@ netkit::species::species(base_neat* neat_instance, base_population* population,
 	, m_summed_fitnesses(0)
 	, m_summed_adjusted_fitnesses(0)
 	, m_best_fitness_ever(0)
+	, m_summed_genome_sizes(0)
+	, m_summed_phenotype_depths(0)
+	, m_number_of_known_depths(0)
+	, m_summed_raw_fitnesses(0)
+	, m_best_raw_fitness(0)
 	, m_id(id)
 	, m_age(0)
 	, m_age_of_last_improvement(0)
@@ -31,6 +45,11 @@ netkit::species::species(const species& other)
 	, m_summed_fitnesses(other.m_summed_fitnesses)
 	, m_summed_adjusted_fitnesses(other.m_summed_adjusted_fitnesses)
 	, m_best_fitness_ever(other.m_best_fitness_ever)
+	, m_summed_genome_sizes(other.m_summed_genome_sizes)
+	, m_summed_phenotype_depths(other.m_summed_phenotype_depths)
+	, m_number_of_known_depths(other.m_number_of_known_depths)
+	, m_summed_raw_fitnesses(other.m_summed_raw_fitnesses)
+	, m_best_raw_fitness(other.m_best_raw_fitness)
 	, m_id(other.m_id)
 	, m_age(other.m_age)
 	, m_age_of_last_improvement(other.m_age_of_last_improvement)
@@ -48,6 +67,11 @@ netkit::species::species(species&& other) noexcept
 	, m_summed_fitnesses(other.m_summed_fitnesses)
 	, m_summed_adjusted_fitnesses(other.m_summed_adjusted_fitnesses)
 	, m_best_fitness_ever(other.m_best_fitness_ever)
+	, m_summed_genome_sizes(other.m_summed_genome_sizes)
+	, m_summed_phenotype_depths(other.m_summed_phenotype_depths)
+	, m_number_of_known_depths(other.m_number_of_known_depths)
+	, m_summed_raw_fitnesses(other.m_summed_raw_fitnesses)
+	, m_best_raw_fitness(other.m_best_raw_fitness)
 	, m_id(other.m_id)
 	, m_age(other.m_age)
 	, m_age_of_last_improvement(other.m_age_of_last_improvement)
@@ -71,6 +95,11 @@ netkit::species& netkit::species::operator=(const species& other) {
 	m_summed_fitnesses = other.m_summed_fitnesses;
 	m_summed_adjusted_fitnesses = other.m_summed_adjusted_fitnesses;
 	m_best_fitness_ever = other.m_best_fitness_ever;
+	m_summed_genome_sizes = other.m_summed_genome_sizes;
+	m_summed_phenotype_depths = other.m_summed_phenotype_depths;
+	m_number_of_known_depths = other.m_number_of_known_depths;
+	m_summed_raw_fitnesses = other.m_summed_raw_fitnesses;
+	m_best_raw_fitness = other.m_best_raw_fitness;
 	m_id = other.m_id;
 	m_age = other.m_age;
 	m_age_of_last_improvement = other.m_age_of_last_improvement;
@@ -95,6 +124,11 @@ netkit::species& netkit::species::operator=(species&& other) noexcept {
 	m_summed_fitnesses = other.m_summed_fitnesses;
 	m_summed_adjusted_fitnesses = other.m_summed_adjusted_fitnesses;
 	m_best_fitness_ever = other.m_best_fitness_ever;
+	m_summed_genome_sizes = other.m_summed_genome_sizes;
+	m_summed_phenotype_depths = other.m_summed_phenotype_depths;
+	m_number_of_known_depths = other.m_number_of_known_depths;
+	m_summed_raw_fitnesses = other.m_summed_raw_fitnesses;
+	m_best_raw_fitness = other.m_best_raw_fitness;
 	m_id = other.m_id;
 	m_age = other.m_age;
 	m_age_of_last_improvement = other.m_age_of_last_improvement;
@@ -114,11 +148,9 @@ netkit::genome_id_t netkit::species::get_champion() const {
 		return m_members.front();
 	} else {
 		genome_id_t best = m_members.front();
-		double best_fitness_so_far = -1 * std::numeric_limits<double>::max();
 		for (genome_id_t g : m_members) {
-			if (m_population->get_genome(g).get_fitness() > best_fitness_so_far) {
+			if (m_population->get_genome(g).is_fitter_than(m_population->get_genome(best))) {
 				best = g;
-				best_fitness_so_far = m_population->get_genome(g).get_fitness();
 			}
 		}
 		return best;
@@ -158,12 +190,34 @@ netkit::genome_id_t netkit::species::select_one_genitor() {
 }
 
 void netkit::species::sort_by_fitness() {
-	if (!m_sorted) {
+	if (m_sorted) {
+		return;
+	}
+
+	if (!m_neat->params.complexity_tie_break) {
 		std::sort(m_members.begin(), m_members.end(), [&](genome_id_t g1, genome_id_t g2) -> bool {
-			return m_population->get_genome(g1).get_fitness() > m_population->get_genome(g2).get_fitness();
+			return m_population->get_genome(g1).is_fitter_than(m_population->get_genome(g2));
 		});
-		m_sorted = true;
+	} else {
+		// the costs are computed once before sorting, not in the comparator: with MACS_COST, getting the cost of a
+		// genome can generate its phenotype.
+		std::vector<ranked_member> ranked;
+		ranked.reserve(m_members.size());
+		for (genome_id_t g : m_members) {
+			const genome& geno = m_population->get_genome(g);
+			ranked.push_back({g, geno.get_fitness(), geno.get_complexity_cost()});
+		}
+		std::sort(ranked.begin(), ranked.end(), [](const ranked_member& m1, const ranked_member& m2) -> bool {
+			if (m1.fitness > m2.fitness) {
+				return true;
+			}
+			return !(m1.fitness < m2.fitness) && m1.cost < m2.cost;
+		});
+		for (size_t i = 0; i < ranked.size(); ++i) {
+			m_members[i] = ranked[i].id;
+		}
 	}
+	m_sorted = true;
 }
 
 void netkit::species::update_stats() {
@@ -172,10 +226,22 @@ void netkit::species::update_stats() {
 	m_best_fitness = 0;
 	m_summed_fitnesses = 0;
 	m_summed_adjusted_fitnesses = 0;
+	m_summed_genome_sizes = 0;
+	m_summed_phenotype_depths = 0;
+	m_number_of_known_depths = 0;
+	m_summed_raw_fitnesses = 0;
+	m_best_raw_fitness = std::numeric_limits<double>::lowest();
 
 	for (genome_id_t g : m_members) {
 		m_summed_fitnesses += m_population->get_genome(g).get_fitness();
+		m_summed_raw_fitnesses += m_population->get_genome(g).get_raw_fitness();
+		m_best_raw_fitness = std::max(m_best_raw_fitness, m_population->get_genome(g).get_raw_fitness());
 		m_summed_adjusted_fitnesses += m_population->get_genome(g).get_adjusted_fitness();
+		m_summed_genome_sizes += m_population->get_genome(g).get_genes().size();
+		if (m_population->get_genome(g).get_phenotype_depth() >= 0) {
+			m_summed_phenotype_depths += m_population->get_genome(g).get_phenotype_depth();
+			++m_number_of_known_depths;
+		}
 
 		if (m_population->get_genome(g).get_fitness() > m_best_fitness) {
 			m_best_fitness = m_population->get_genome(g).get_fitness();
@@ -196,6 +262,11 @@ void netkit::species::init_for_next_gen(genome new_representant) {
 	m_best_fitness = 0;
 	m_summed_fitnesses = 0;
 	m_summed_adjusted_fitnesses = 0;
+	m_summed_genome_sizes = 0;
+	m_summed_phenotype_depths = 0;
+	m_number_of_known_depths = 0;
+	m_summed_raw_fitnesses = 0;
+	m_best_raw_fitness = 0;
 	++m_age;
 
 	delete m_representant;
@@ -215,11 +286,24 @@ void netkit::species::remove_member(genome_id_t geno_id) {
 }
 
 void netkit::species::share_fitness() const {
+	const double penalty = m_neat->params.complexity_penalty;
 	for (genome_id_t g : m_members) {
-		m_population->get_genome(g).set_adjusted_fitness(
-			m_population->get_genome(g).get_fitness() / static_cast<double>(m_members.size())
-		);
+		genome& geno = m_population->get_genome(g);
+		double fitness = geno.get_fitness();
+		if (penalty > 0) {
+			// floored so that the expected offsprings stay positive.
+			fitness = std::max(0., fitness - penalty * geno.get_complexity_cost());
+		}
+		geno.set_adjusted_fitness(fitness / static_cast<double>(m_members.size()));
+	}
+}
+
+netkit::memory_report netkit::species::memory_usage() const {
+	memory_report report = vector_memory(m_members);
+	if (m_representant != nullptr) {
+		report.overhead += sizeof(genome) + m_representant->memory_usage().total();
 	}
+	return report;
 }
 
 std::ostream& netkit::operator<<(std::ostream& os, const species& spec) {
@@ -0,0 +1,169 @@
+#include <algorithm> // std::min, std::max
+#include <cmath> // std::abs
+#include <stdexcept> // std::invalid_argument
+
+#include "netkit/neat/substrate.h"
+#include "netkit/network/activation_functions.h"
+
+namespace {
+	constexpr size_t CPPN_INPUTS = 4;
+
+	// maps the CPPN output to a substrate weight, returns false if the link isn't expressed.
+	bool express(netkit::neuron_value_t output, const netkit::parameters& params, netkit::neuron_value_t& weight) {
+		output = std::max<netkit::neuron_value_t>(-1, std::min<netkit::neuron_value_t>(1, output));
+		netkit::neuron_value_t magnitude = std::abs(output);
+		if (magnitude <= params.substrate_expression_threshold) {
+			return false;
+		}
+
+		weight = (magnitude - params.substrate_expression_threshold) / (1 - params.substrate_expression_threshold)
+				 * params.substrate_max_weight;
+		if (output < 0) {
+			weight = -weight;
+		}
+		return true;
+	}
+
+	netkit::compiled_network compile_cppn(const netkit::genome& cppn, const netkit::parameters& params) {
+		if (params.substrate_expression_threshold < 0 || params.substrate_expression_threshold >= 1) {
+			throw std::invalid_argument("the expression threshold must be in [0, 1).");
+		}
+
+		netkit::compiled_network net(cppn.generate_network());
+		if (net.number_of_inputs() != CPPN_INPUTS || net.number_of_outputs() != 1) {
+			throw std::invalid_argument("a CPPN has 4 inputs (x1, y1, x2, y2) and 1 output.");
+		}
+		return net;
+	}
+
+	// calls func(from, to, source point, target point) for every candidate link, target after target.
+	template <typename Func>
+	void for_each_candidate(const std::vector<std::vector<netkit::substrate_point>>& layers,
+							const std::vector<netkit::neuron_id_t>& first_ids, Func func) {
+		for (size_t l = 0; l + 1 < layers.size(); ++l) {
+			for (size_t t = 0; t < layers[l + 1].size(); ++t) {
+				for (size_t s = 0; s < layers[l].size(); ++s) {
+					func(static_cast<netkit::neuron_id_t>(first_ids[l] + s),
+						 static_cast<netkit::neuron_id_t>(first_ids[l + 1] + t), layers[l][s], layers[l + 1][t]);
+				}
+			}
+		}
+	}
+}
+
+netkit::substrate::substrate(std::vector<std::vector<substrate_point>> layers)
+	: m_layers(std::move(layers))
+	, m_first_ids() {
+	if (m_layers.size() < 2) {
+		throw std::invalid_argument("a substrate needs at least an input and an output layer.");
+	}
+
+	neuron_id_t next_id = network::BIAS_ID + 1;
+	for (const std::vector<substrate_point>& layer : m_layers) {
+		if (layer.empty()) {
+			throw std::invalid_argument("a substrate layer can't be empty.");
+		}
+		m_first_ids.push_back(next_id);
+		next_id += static_cast<neuron_id_t>(layer.size());
+	}
+}
+
+size_t netkit::substrate::number_of_neurons() const {
+	size_t count = 0;
+	for (const std::vector<substrate_point>& layer : m_layers) {
+		count += layer.size();
+	}
+	return count;
+}
+
+size_t netkit::substrate::number_of_candidate_links() const {
+	size_t count = 0;
+	for (size_t l = 0; l + 1 < m_layers.size(); ++l) {
+		count += m_layers[l].size() * m_layers[l + 1].size();
+	}
+	return count;
+}
+
+netkit::parameters netkit::substrate::cppn_parameters(parameters params) {
+	params.number_of_inputs = CPPN_INPUTS;
+	params.number_of_outputs = 1;
+	params.hidden_activation_functions = {GAUSSIAN_ACTIVATION, SINE_ACTIVATION, ABSOLUTE_ACTIVATION,
+										  IDENTITY_ACTIVATION, STEEPENED_SIGMOID_ACTIVATION};
+	params.output_activation_function = IDENTITY_ACTIVATION;
+	params.mutation_probs[CHANGE_ACTIVATION] = 0.1;
+	return params;
+}
+
+netkit::compiled_network netkit::substrate::build(const genome& cppn, const parameters& params) const {
+	compiled_network net = compile_cppn(cppn, params);
+	const std::vector<neuron_value_t>& weights = net.get_weights();
+	const size_t batch_size = std::max<size_t>(1, params.cppn_batch_size);
+
+	std::vector<link> links;
+	std::vector<link> pending; // the candidate links of the current batch
+	std::vector<neuron_value_t> queries;
+	std::vector<neuron_value_t> outputs(batch_size);
+	std::vector<neuron_value_t> values;
+	pending.reserve(batch_size);
+	queries.reserve(batch_size * CPPN_INPUTS);
+
+	auto flush_batch = [&]() {
+		net.evaluate_batch(weights.data(), queries.data(), pending.size(), outputs.data(), values);
+		for (size_t i = 0; i < pending.size(); ++i) {
+			neuron_value_t weight;
+			if (express(outputs[i], params, weight)) {
+				links.emplace_back(pending[i].from, pending[i].to, weight);
+			}
+		}
+		pending.clear();
+		queries.clear();
+	};
+
+	for_each_candidate(m_layers, m_first_ids, [&](neuron_id_t from, neuron_id_t to, const substrate_point& source,
+												  const substrate_point& target) {
+		pending.emplace_back(from, to);
+		queries.insert(queries.end(), {source.x, source.y, target.x, target.y});
+		if (pending.size() == batch_size) {
+			flush_batch();
+		}
+	});
+	if (!pending.empty()) {
+		flush_batch();
+	}
+
+	return helper_compile(links);
+}
+
+netkit::compiled_network netkit::substrate::build_unbatched(const genome& cppn, const parameters& params) const {
+	compiled_network net = compile_cppn(cppn, params);
+	const std::vector<neuron_value_t>& weights = net.get_weights();
+
+	std::vector<link> links;
+	std::vector<neuron_value_t> values;
+	for_each_candidate(m_layers, m_first_ids, [&](neuron_id_t from, neuron_id_t to, const substrate_point& source,
+												  const substrate_point& target) {
+		std::vector<neuron_value_t> outputs = net.evaluate(weights.data(), {source.x, source.y, target.x, target.y},
+														   values);
+		neuron_value_t weight;
+		if (express(outputs[0], params, weight)) {
+			links.emplace_back(from, to, weight);
+		}
+	});
+
+	return helper_compile(links);
+}
+
+netkit::compiled_network netkit::substrate::helper_compile(const std::vector<link>& links) const {
+	std::vector<activation_func_t> activations(number_of_neurons() + 1, &steepened_sigmoid);
+
+	std::vector<neuron_id_t> input_ids;
+	for (size_t i = 0; i < number_of_inputs(); ++i) {
+		input_ids.push_back(static_cast<neuron_id_t>(m_first_ids.front() + i));
+	}
+	std::vector<neuron_id_t> output_ids;
+	for (size_t i = 0; i < number_of_outputs(); ++i) {
+		output_ids.push_back(static_cast<neuron_id_t>(m_first_ids.back() + i));
+	}
+
+	return compiled_network(links, std::move(activations), std::move(input_ids), std::move(output_ids));
+}
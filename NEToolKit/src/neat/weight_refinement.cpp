@@ -0,0 +1,27 @@
+#include "netkit/neat/weight_refinement.h"
+#include "netkit/network/compiled_network.h"
+
+std::optional<double> netkit::refine_weights(organism& org, const std::vector<training_sample>& samples,
+											 const parameters& params) {
+	compiled_network net(org.get_network());
+	if (!net.is_differentiable()) {
+		return {};
+	}
+
+	genome& geno = org.get_genome();
+	std::vector<neuron_value_t> mutable_links; // the links are the enabled genes, in order
+	for (const gene& g : geno.get_genes()) {
+		if (g.enabled) {
+			mutable_links.push_back(g.frozen ? 0 : 1);
+		}
+	}
+	std::vector<neuron_value_t> mask = net.to_compiled_order(mutable_links);
+
+	std::vector<neuron_value_t> weights = net.get_weights();
+	double error = backpropagate(net, weights.data(), samples, params.refinement_steps,
+								 params.refinement_learning_rate, mask.data());
+
+	geno.set_link_weights(net.to_link_order(weights.data()));
+	org.get_network() = geno.generate_network();
+	return error;
+}
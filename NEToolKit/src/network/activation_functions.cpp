@@ -1,11 +1,320 @@
+#include <algorithm> // std::min, std::max
 #include <cmath>
+#include <vector>
 
 #include "netkit/network/activation_functions.h"
 
+namespace {
+	using netkit::neuron_value_t;
+	using netkit::raw_activation_func_t;
+
+	const double PI = 3.14159265358979323846;
+
+	// the functions, with an internal linkage so that they are inlined in the kernels (the exported ones can be
+	// interposed in a shared library, so they are never inlined).
+	inline neuron_value_t steepened_sigmoid_of(neuron_value_t x) { return 1 / (1 + std::exp(-4.9 * x)); }
+	inline neuron_value_t sigmoid_of(neuron_value_t x) { return 1 / (1 + std::exp(-x)); }
+	inline neuron_value_t tanh_of(neuron_value_t x) { return std::tanh(x); }
+	inline neuron_value_t relu_of(neuron_value_t x) { return x > 0 ? x : 0; }
+	inline neuron_value_t gaussian_of(neuron_value_t x) { return std::exp(-x * x); }
+	inline neuron_value_t identity_of(neuron_value_t x) { return x; }
+	inline neuron_value_t step_of(neuron_value_t x) { return x > 0 ? 1 : 0; }
+	inline neuron_value_t sine_of(neuron_value_t x) { return std::sin(x); }
+	inline neuron_value_t absolute_of(neuron_value_t x) { return std::abs(x); }
+
+	// the kernels work on blocks of a fixed size written to a local buffer: no alias between the inputs and the
+	// outputs and a known trip count, which is what the vectorizer needs at -O2.
+	const size_t BLOCK_SIZE = 16;
+
+	template <typename func_t>
+	void apply_by_blocks(const func_t& func, const neuron_value_t* sums, neuron_value_t* values, size_t count) {
+		size_t i = 0;
+		for (; i + BLOCK_SIZE <= count; i += BLOCK_SIZE) {
+			neuron_value_t block[BLOCK_SIZE];
+			for (size_t k = 0; k < BLOCK_SIZE; ++k) {
+				block[k] = func(sums[i + k]);
+			}
+			for (size_t k = 0; k < BLOCK_SIZE; ++k) {
+				values[i + k] = block[k];
+			}
+		}
+		for (; i < count; ++i) {
+			values[i] = func(sums[i]);
+		}
+	}
+
+	// how a lookup table behaves outside of its range.
+	enum table_extension_t {
+		CLAMPED_TABLE, // the function is flat at the ends (sigmoids, tanh, gaussian, step)
+		EXTENDED_TABLE, // the end segments go on (relu, identity, absolute)
+		PERIODIC_TABLE // the range is a period (sine)
+	};
+
+	class function_table {
+	  public:
+		static const int INTERVALS = 4096;
+
+		function_table(raw_activation_func_t func, neuron_value_t min, neuron_value_t max, table_extension_t extension)
+			: m_values(INTERVALS + 1)
+			, m_min(min)
+			, m_period(max - min)
+			, m_scale(INTERVALS / (max - min))
+			, m_extension(extension) {
+			for (int i = 0; i <= INTERVALS; ++i) {
+				m_values[i] = func(min + i / m_scale);
+			}
+		}
+
+		table_extension_t extension() const { return m_extension; }
+
+		neuron_value_t operator()(neuron_value_t input) const {
+			switch (m_extension) {
+			case EXTENDED_TABLE:
+				return lookup<EXTENDED_TABLE>(input);
+			case PERIODIC_TABLE:
+				return lookup<PERIODIC_TABLE>(input);
+			default:
+				return lookup<CLAMPED_TABLE>(input);
+			}
+		}
+
+		template <table_extension_t extension>
+		neuron_value_t lookup(neuron_value_t input) const {
+			if (extension == PERIODIC_TABLE) {
+				input -= m_period * std::floor((input - m_min) / m_period);
+			}
+
+			neuron_value_t position = (input - m_min) * m_scale;
+			if (extension != EXTENDED_TABLE) {
+				position = clamp(position, INTERVALS);
+			}
+			// (an int conversion is a single instruction, unlike a size_t one)
+			int i = static_cast<int>(clamp(position, INTERVALS - 1));
+			neuron_value_t t = position - i;
+			return m_values[i] + t * (m_values[i + 1] - m_values[i]);
+		}
+
+	  private:
+		// in [0, max], NaN giving 0. Written as plain comparisons, which become min and max instructions
+		// rather than branches.
+		static neuron_value_t clamp(neuron_value_t x, neuron_value_t max) {
+			x = x > 0 ? x : 0;
+			return x < max ? x : max;
+		}
+
+	  private:
+		std::vector<neuron_value_t> m_values;
+		neuron_value_t m_min;
+		neuron_value_t m_period;
+		neuron_value_t m_scale; // intervals per unit
+		table_extension_t m_extension;
+	};
+
+	const raw_activation_func_t EXACT_FUNCTIONS[netkit::NUMBER_OF_ACTIVATION_FUNCTIONS] = {
+		&netkit::steepened_sigmoid,
+		&netkit::sigmoid,
+		&netkit::hyperbolic_tangent,
+		&netkit::relu,
+		&netkit::gaussian,
+		&netkit::linear,
+		&netkit::step,
+		&netkit::sine,
+		&netkit::absolute
+	};
+
+	const char* const FUNCTION_NAMES[netkit::NUMBER_OF_ACTIVATION_FUNCTIONS] = {
+		"steepened_sigmoid", "sigmoid", "tanh", "relu", "gaussian", "identity", "step", "sine", "absolute"
+	};
+
+	const function_table& table_of(netkit::activation_function_t func) {
+		// built on first use, once for all the threads.
+		static const std::vector<function_table> tables = []() {
+			std::vector<function_table> result;
+			for (size_t f = 0; f < netkit::NUMBER_OF_ACTIVATION_FUNCTIONS; ++f) {
+				table_extension_t extension = CLAMPED_TABLE;
+				if (f == netkit::RELU_ACTIVATION || f == netkit::IDENTITY_ACTIVATION || f == netkit::ABSOLUTE_ACTIVATION) {
+					extension = EXTENDED_TABLE;
+				}
+
+				if (f == netkit::SINE_ACTIVATION) {
+					result.emplace_back(EXACT_FUNCTIONS[f], -PI, PI, PERIODIC_TABLE);
+				} else {
+					result.emplace_back(EXACT_FUNCTIONS[f], -16, 16, extension);
+				}
+			}
+			return result;
+		}();
+		return tables[func];
+	}
+
+	template <netkit::activation_function_t func>
+	neuron_value_t table_function(neuron_value_t input) {
+		return table_of(func)(input);
+	}
+
+	const raw_activation_func_t TABLE_FUNCTIONS[netkit::NUMBER_OF_ACTIVATION_FUNCTIONS] = {
+		&table_function<netkit::STEEPENED_SIGMOID_ACTIVATION>,
+		&table_function<netkit::SIGMOID_ACTIVATION>,
+		&table_function<netkit::TANH_ACTIVATION>,
+		&table_function<netkit::RELU_ACTIVATION>,
+		&table_function<netkit::GAUSSIAN_ACTIVATION>,
+		&table_function<netkit::IDENTITY_ACTIVATION>,
+		&table_function<netkit::STEP_ACTIVATION>,
+		&table_function<netkit::SINE_ACTIVATION>,
+		&table_function<netkit::ABSOLUTE_ACTIVATION>
+	};
+
+	template <neuron_value_t (*func)(neuron_value_t)>
+	void apply_function(const neuron_value_t* sums, neuron_value_t* values, size_t count) {
+		apply_by_blocks([](neuron_value_t x) { return func(x); }, sums, values, count);
+	}
+
+	template <table_extension_t extension>
+	void apply_table(const function_table& table, const neuron_value_t* sums, neuron_value_t* values, size_t count) {
+		apply_by_blocks([&table](neuron_value_t x) { return table.lookup<extension>(x); }, sums, values, count);
+	}
+}
+
 netkit::neuron_value_t netkit::sigmoid(neuron_value_t input) {
-	return 1 / (1 + std::exp(-input));
+	return sigmoid_of(input);
 }
 
 netkit::neuron_value_t netkit::steepened_sigmoid(neuron_value_t input) {
-	return 1 / (1 + std::exp(-4.9 * input));
+	return steepened_sigmoid_of(input);
+}
+
+netkit::neuron_value_t netkit::hyperbolic_tangent(neuron_value_t input) {
+	return tanh_of(input);
+}
+
+netkit::neuron_value_t netkit::relu(neuron_value_t input) {
+	return relu_of(input);
+}
+
+netkit::neuron_value_t netkit::step(neuron_value_t input) {
+	return step_of(input);
+}
+
+netkit::neuron_value_t netkit::gaussian(neuron_value_t input) {
+	return gaussian_of(input);
+}
+
+netkit::neuron_value_t netkit::sine(neuron_value_t input) {
+	return sine_of(input);
+}
+
+netkit::neuron_value_t netkit::absolute(neuron_value_t input) {
+	return absolute_of(input);
+}
+
+netkit::neuron_value_t netkit::linear(neuron_value_t input) {
+	return identity_of(input);
+}
+
+netkit::neuron_value_t netkit::sigmoid_derivative(neuron_value_t output) {
+	return output * (1 - output);
+}
+
+netkit::neuron_value_t netkit::steepened_sigmoid_derivative(neuron_value_t output) {
+	return 4.9 * output * (1 - output);
+}
+
+netkit::neuron_value_t netkit::hyperbolic_tangent_derivative(neuron_value_t output) {
+	return 1 - output * output;
+}
+
+netkit::neuron_value_t netkit::relu_derivative(neuron_value_t output) {
+	return output > 0 ? 1 : 0;
+}
+
+netkit::neuron_value_t netkit::linear_derivative(neuron_value_t) {
+	return 1;
+}
+
+netkit::raw_activation_func_t netkit::activation_function(activation_function_t func, bool lookup_table) {
+	return lookup_table ? TABLE_FUNCTIONS[func] : EXACT_FUNCTIONS[func];
+}
+
+const char* netkit::activation_function_name(activation_function_t func) {
+	return FUNCTION_NAMES[func];
+}
+
+netkit::raw_activation_func_t netkit::activation_derivative(activation_function_t func) {
+	switch (func) {
+	case STEEPENED_SIGMOID_ACTIVATION:
+		return &steepened_sigmoid_derivative;
+	case SIGMOID_ACTIVATION:
+		return &sigmoid_derivative;
+	case TANH_ACTIVATION:
+		return &hyperbolic_tangent_derivative;
+	case RELU_ACTIVATION:
+		return &relu_derivative;
+	case IDENTITY_ACTIVATION:
+		return &linear_derivative;
+	default:
+		return nullptr;
+	}
+}
+
+bool netkit::identify_activation_function(raw_activation_func_t raw, activation_function_t& func,
+										  bool& lookup_table) {
+	for (size_t f = 0; f < NUMBER_OF_ACTIVATION_FUNCTIONS; ++f) {
+		if (raw == EXACT_FUNCTIONS[f] || raw == TABLE_FUNCTIONS[f]) {
+			func = static_cast<activation_function_t>(f);
+			lookup_table = raw == TABLE_FUNCTIONS[f];
+			return true;
+		}
+	}
+	return false;
+}
+
+void netkit::apply_activation(activation_function_t func, bool lookup_table, const neuron_value_t* sums,
+							  neuron_value_t* values, size_t count) {
+	if (lookup_table) {
+		const function_table& table = table_of(func);
+		switch (table.extension()) {
+		case EXTENDED_TABLE:
+			apply_table<EXTENDED_TABLE>(table, sums, values, count);
+			break;
+		case PERIODIC_TABLE:
+			apply_table<PERIODIC_TABLE>(table, sums, values, count);
+			break;
+		default:
+			apply_table<CLAMPED_TABLE>(table, sums, values, count);
+			break;
+		}
+		return;
+	}
+
+	switch (func) {
+	case STEEPENED_SIGMOID_ACTIVATION:
+		apply_function<&steepened_sigmoid_of>(sums, values, count);
+		break;
+	case SIGMOID_ACTIVATION:
+		apply_function<&sigmoid_of>(sums, values, count);
+		break;
+	case TANH_ACTIVATION:
+		apply_function<&tanh_of>(sums, values, count);
+		break;
+	case RELU_ACTIVATION:
+		apply_function<&relu_of>(sums, values, count);
+		break;
+	case GAUSSIAN_ACTIVATION:
+		apply_function<&gaussian_of>(sums, values, count);
+		break;
+	case IDENTITY_ACTIVATION:
+		apply_function<&identity_of>(sums, values, count);
+		break;
+	case STEP_ACTIVATION:
+		apply_function<&step_of>(sums, values, count);
+		break;
+	case SINE_ACTIVATION:
+		apply_function<&sine_of>(sums, values, count);
+		break;
+	case ABSOLUTE_ACTIVATION:
+		apply_function<&absolute_of>(sums, values, count);
+		break;
+	default: // should not happen
+		break;
+	}
 }
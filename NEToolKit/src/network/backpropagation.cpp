@@ -0,0 +1,98 @@
+#include <algorithm> // std::fill
+#include <cmath> // std::fpclassify
+#include <stdexcept> // std::invalid_argument
+
+#include "netkit/network/backpropagation.h"
+
+namespace {
+	// forward pass of one sample, returns its summed squared error.
+	double forward(const netkit::compiled_network& net, const netkit::neuron_value_t* weights,
+				   const netkit::training_sample& sample, std::vector<netkit::neuron_value_t>& values,
+				   std::vector<netkit::neuron_value_t>& outputs) {
+		if (sample.targets.size() != net.number_of_outputs()) {
+			throw std::invalid_argument("Incorrect number of targets.");
+		}
+
+		net.flush(values);
+		net.load_inputs(values, sample.inputs);
+		net.activate_feed_forward(weights, values);
+		net.get_outputs(values, outputs);
+
+		double error = 0;
+		for (size_t o = 0; o < outputs.size(); ++o) {
+			error += (outputs[o] - sample.targets[o]) * (outputs[o] - sample.targets[o]);
+		}
+		return error;
+	}
+}
+
+double netkit::mean_squared_error(const compiled_network& net, const neuron_value_t* weights,
+								  const std::vector<training_sample>& samples) {
+	if (samples.empty()) {
+		return 0;
+	}
+
+	std::vector<neuron_value_t> values;
+	std::vector<neuron_value_t> outputs;
+	double error = 0;
+	for (const training_sample& sample : samples) {
+		error += forward(net, weights, sample, values, outputs);
+	}
+	return error / static_cast<double>(samples.size());
+}
+
+double netkit::backpropagate(const compiled_network& net, neuron_value_t* weights,
+							 const std::vector<training_sample>& samples, unsigned int steps,
+							 double learning_rate, const neuron_value_t* mask) {
+	if (!net.is_differentiable()) {
+		throw std::invalid_argument("the network isn't differentiable (recurrent or unknown activation derivative).");
+	}
+	if (samples.empty()) {
+		return 0;
+	}
+
+	// scratch buffers, allocated once for all the steps: the function can run in parallel on different weights.
+	std::vector<neuron_value_t> values;
+	std::vector<neuron_value_t> outputs;
+	std::vector<neuron_value_t> value_gradients(net.number_of_neurons());
+	std::vector<neuron_value_t> weight_gradients(net.number_of_links());
+
+	const std::vector<neuron_id_t>& order = net.get_topological_order();
+	const std::vector<neuron_id_t>& output_ids = net.get_output_ids();
+	const double scale = 2.0 / static_cast<double>(samples.size()); // derivative of the mean of the squares
+
+	for (unsigned int step = 0; step < steps; ++step) {
+		std::fill(weight_gradients.begin(), weight_gradients.end(), 0);
+
+		for (const training_sample& sample : samples) {
+			forward(net, weights, sample, values, outputs);
+
+			std::fill(value_gradients.begin(), value_gradients.end(), 0);
+			for (size_t o = 0; o < output_ids.size(); ++o) {
+				value_gradients[output_ids[o]] += scale * (outputs[o] - sample.targets[o]);
+			}
+
+			// reverse topological order: a neuron's gradient is complete once all the neurons it feeds are done.
+			for (auto it = order.rbegin(); it != order.rend(); ++it) {
+				neuron_id_t nid = *it;
+				neuron_value_t delta = value_gradients[nid] * net.derivative(nid, values[nid]);
+				// exactly zero (a saturated relu or a neuron which doesn't reach the outputs): its links would get
+				// nothing, skipping them is exact. A tolerance would drop small but real gradients.
+				if (std::fpclassify(delta) == FP_ZERO) {
+					continue;
+				}
+				for (size_t i = net.incoming_begin(nid); i < net.incoming_end(nid); ++i) {
+					weight_gradients[i] += delta * values[net.source(i)];
+					value_gradients[net.source(i)] += delta * weights[i];
+				}
+			}
+		}
+
+		for (size_t i = 0; i < weight_gradients.size(); ++i) {
+			neuron_value_t update = learning_rate * weight_gradients[i];
+			weights[i] -= mask != nullptr ? update * mask[i] : update;
+		}
+	}
+
+	return mean_squared_error(net, weights, samples);
+}
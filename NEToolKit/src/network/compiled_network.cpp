@@ -0,0 +1,542 @@
+#include <algorithm> // std::fill, std::stable_sort, std::max, std::min, std::copy, std::lower_bound, std::upper_bound
+#include <stdexcept> // std::invalid_argument
+
+#include "netkit/network/compiled_network.h"
+
+const size_t netkit::compiled_network::PARALLEL_LINKS_PER_TASK = 4096;
+
+netkit::compiled_network::compiled_network(const network& net)
+	: m_offsets()
+	, m_sources()
+	, m_weights()
+	, m_link_ids()
+	, m_fed_neurons()
+	, m_activations()
+	, m_raw_activations()
+	, m_functions()
+	, m_lookup_tables()
+	, m_derivatives()
+	, m_feed_forward(false)
+	, m_topological_order()
+	, m_level_offsets()
+	, m_cumulative_links()
+	, m_groups()
+	, m_largest_level(0)
+	, m_input_ids(net.get_input_ids())
+	, m_output_ids(net.get_output_ids())
+	, m_depth(net.max_depth()) {
+	const std::vector<neuron>& neurons = net.get_neurons();
+	const std::vector<link>& links = net.get_links();
+
+	m_offsets.reserve(neurons.size() + 1);
+	m_sources.reserve(links.size());
+	m_weights.reserve(links.size());
+	m_link_ids.reserve(links.size());
+	m_activations.reserve(neurons.size());
+	m_raw_activations.reserve(neurons.size());
+	m_functions.reserve(neurons.size());
+	m_derivatives.reserve(neurons.size());
+
+	m_offsets.push_back(0);
+	for (neuron_id_t nid = 0; nid < neurons.size(); ++nid) {
+		const neuron& n = neurons[nid];
+		for (link_id_t lid : n.incoming_links_ids()) {
+			m_sources.push_back(links[lid].from);
+			m_weights.push_back(links[lid].weight);
+			m_link_ids.push_back(lid);
+		}
+		m_offsets.push_back(m_sources.size());
+
+		if (!n.incoming_links_ids().empty()) {
+			m_fed_neurons.push_back(nid);
+		}
+
+		helper_add_activation(n.get_activation_func());
+	}
+
+	helper_sort_by_levels();
+}
+
+netkit::compiled_network::compiled_network(const std::vector<link>& links, std::vector<activation_func_t> activations,
+										   std::vector<neuron_id_t> input_ids, std::vector<neuron_id_t> output_ids)
+	: m_offsets(activations.size() + 1, 0)
+	, m_sources(links.size())
+	, m_weights(links.size())
+	, m_link_ids(links.size())
+	, m_fed_neurons()
+	, m_activations()
+	, m_raw_activations()
+	, m_functions()
+	, m_lookup_tables()
+	, m_derivatives()
+	, m_feed_forward(false)
+	, m_topological_order()
+	, m_level_offsets()
+	, m_cumulative_links()
+	, m_groups()
+	, m_largest_level(0)
+	, m_input_ids(std::move(input_ids))
+	, m_output_ids(std::move(output_ids))
+	, m_depth(0) {
+	const size_t number_of_neurons = activations.size();
+	for (const link& l : links) {
+		if (l.from >= number_of_neurons || l.to >= number_of_neurons) {
+			throw std::invalid_argument("a link refers to an unknown neuron.");
+		}
+		++m_offsets[l.to + 1];
+	}
+	for (neuron_id_t nid : m_input_ids) {
+		if (nid >= number_of_neurons) {
+			throw std::invalid_argument("an input refers to an unknown neuron.");
+		}
+	}
+	for (neuron_id_t nid : m_output_ids) {
+		if (nid >= number_of_neurons) {
+			throw std::invalid_argument("an output refers to an unknown neuron.");
+		}
+	}
+
+	// counting sort of the links by target, stable so that the sums are in the order of the links.
+	for (size_t nid = 0; nid < number_of_neurons; ++nid) {
+		m_offsets[nid + 1] += m_offsets[nid];
+	}
+	std::vector<size_t> next(m_offsets.begin(), m_offsets.end() - 1);
+	for (link_id_t lid = 0; lid < links.size(); ++lid) {
+		size_t i = next[links[lid].to]++;
+		m_sources[i] = links[lid].from;
+		m_weights[i] = links[lid].weight;
+		m_link_ids[i] = lid;
+	}
+
+	m_activations.reserve(number_of_neurons);
+	m_raw_activations.reserve(number_of_neurons);
+	m_functions.reserve(number_of_neurons);
+	m_derivatives.reserve(number_of_neurons);
+	for (neuron_id_t nid = 0; nid < number_of_neurons; ++nid) {
+		if (m_offsets[nid + 1] != m_offsets[nid]) {
+			m_fed_neurons.push_back(nid);
+		}
+		helper_add_activation(activations[nid]);
+	}
+
+	helper_sort_by_levels();
+	if (!m_feed_forward) {
+		throw std::invalid_argument("the links have a cycle.");
+	}
+	// a feed-forward network relaxes in as many activations as it has levels.
+	m_depth = static_cast<int>(number_of_levels());
+}
+
+bool netkit::compiled_network::is_differentiable() const {
+	if (!m_feed_forward) {
+		return false;
+	}
+	for (neuron_id_t nid : m_fed_neurons) {
+		if (m_derivatives[nid] == nullptr) {
+			return false;
+		}
+	}
+	return true;
+}
+
+std::vector<netkit::neuron_value_t> netkit::compiled_network::to_compiled_order(
+	const std::vector<neuron_value_t>& link_weights) const {
+	if (link_weights.size() != m_link_ids.size()) {
+		throw std::invalid_argument("the number of weights doesn't match the number of links.");
+	}
+
+	std::vector<neuron_value_t> weights(m_link_ids.size());
+	for (size_t i = 0; i < m_link_ids.size(); ++i) {
+		weights[i] = link_weights[m_link_ids[i]];
+	}
+	return weights;
+}
+
+std::vector<netkit::neuron_value_t> netkit::compiled_network::to_link_order(const neuron_value_t* weights) const {
+	std::vector<neuron_value_t> link_weights(m_link_ids.size());
+	for (size_t i = 0; i < m_link_ids.size(); ++i) {
+		link_weights[m_link_ids[i]] = weights[i];
+	}
+	return link_weights;
+}
+
+void netkit::compiled_network::flush(std::vector<neuron_value_t>& values) const {
+	values.assign(number_of_neurons() + m_largest_level, 0);
+	values[network::BIAS_ID] = 1;
+}
+
+void netkit::compiled_network::load_inputs(std::vector<neuron_value_t>& values,
+										   const std::vector<neuron_value_t>& inputs) const {
+	if (inputs.size() != m_input_ids.size()) {
+		throw std::invalid_argument("Incorrect number of neural network inputs.");
+	}
+
+	for (size_t i = 0; i < inputs.size(); ++i) {
+		values[m_input_ids[i]] = inputs[i];
+	}
+}
+
+void netkit::compiled_network::activate(const neuron_value_t* weights, std::vector<neuron_value_t>& values) const {
+	// in place, in the neuron order: a neuron sees the values already updated by this activation (like network).
+	for (neuron_id_t nid : m_fed_neurons) {
+		neuron_value_t sum = 0;
+		for (size_t i = m_offsets[nid]; i < m_offsets[nid + 1]; ++i) {
+			sum += values[m_sources[i]] * weights[i];
+		}
+		values[nid] = helper_activate(nid, sum);
+	}
+}
+
+void netkit::compiled_network::activate_until_relaxation(const neuron_value_t* weights,
+														 std::vector<neuron_value_t>& values) const {
+	for (int i = m_depth; i--;) {
+		activate(weights, values);
+	}
+}
+
+void netkit::compiled_network::activate_feed_forward(const neuron_value_t* weights,
+													 std::vector<neuron_value_t>& values) const {
+	if (!m_feed_forward) {
+		throw std::invalid_argument("the network isn't feed-forward.");
+	}
+
+	if (values.size() < number_of_neurons() + m_largest_level) {
+		values.resize(number_of_neurons() + m_largest_level);
+	}
+
+	for (size_t l = 0; l + 1 < m_level_offsets.size(); ++l) {
+		helper_activate_feed_forward(weights, values.data(), m_level_offsets[l], m_level_offsets[l],
+									 m_level_offsets[l + 1]);
+	}
+}
+
+void netkit::compiled_network::activate_feed_forward(const neuron_value_t* weights,
+													 std::vector<neuron_value_t>& values, thread_pool& pool) const {
+	if (!m_feed_forward) {
+		throw std::invalid_argument("the network isn't feed-forward.");
+	}
+
+	if (values.size() < number_of_neurons() + m_largest_level) {
+		values.resize(number_of_neurons() + m_largest_level);
+	}
+
+	neuron_value_t* values_data = values.data();
+	std::vector<size_t> bounds(pool.size() * 4 + 1);
+	for (size_t l = 0; l + 1 < m_level_offsets.size(); ++l) {
+		const size_t level_begin = m_level_offsets[l];
+		const size_t level_end = m_level_offsets[l + 1];
+		const size_t level_links = m_cumulative_links[level_end] - m_cumulative_links[level_begin];
+		const size_t number_of_tasks = helper_number_of_tasks(level_links, pool);
+		if (number_of_tasks <= 1) {
+			helper_activate_feed_forward(weights, values_data, level_begin, level_begin, level_end);
+			continue;
+		}
+
+		// split where a task has its share of the links of the level.
+		bounds[0] = level_begin;
+		bounds[number_of_tasks] = level_end;
+		for (size_t t = 1; t < number_of_tasks; ++t) {
+			const size_t first_link = m_cumulative_links[level_begin] + level_links * t / number_of_tasks;
+			bounds[t] = static_cast<size_t>(std::lower_bound(m_cumulative_links.begin() + level_begin,
+											m_cumulative_links.begin() + level_end, first_link)
+											- m_cumulative_links.begin());
+		}
+
+		// parallel_for waits for all its chunks: the barrier before the next level.
+		pool.parallel_for(number_of_tasks, [&](size_t t) {
+			helper_activate_feed_forward(weights, values_data, level_begin, bounds[t], bounds[t + 1]);
+		});
+	}
+}
+
+void netkit::compiled_network::activate_synchronous(const neuron_value_t* weights,
+													const std::vector<neuron_value_t>& previous,
+													std::vector<neuron_value_t>& next) const {
+	next.resize(previous.size());
+	std::copy(previous.begin(), previous.end(), next.begin()); // the bias, the inputs and the unfed neurons
+	helper_activate_synchronous(weights, previous.data(), next.data(), 0, m_fed_neurons.size());
+}
+
+void netkit::compiled_network::activate_synchronous(const neuron_value_t* weights,
+													const std::vector<neuron_value_t>& previous,
+													std::vector<neuron_value_t>& next, thread_pool& pool) const {
+	const size_t number_of_tasks = helper_number_of_tasks(m_sources.size(), pool);
+	if (number_of_tasks <= 1) {
+		activate_synchronous(weights, previous, next);
+		return;
+	}
+
+	next.resize(previous.size());
+	std::copy(previous.begin(), previous.end(), next.begin());
+
+	// the fed neurons are sorted by id, so their first link is increasing: split where a task has its share.
+	std::vector<size_t> bounds;
+	bounds.reserve(number_of_tasks + 1);
+	bounds.push_back(0);
+	for (size_t t = 1; t < number_of_tasks; ++t) {
+		const size_t first_link = m_sources.size() * t / number_of_tasks;
+		bounds.push_back(static_cast<size_t>(std::lower_bound(m_fed_neurons.begin(), m_fed_neurons.end(), first_link,
+		[this](neuron_id_t nid, size_t link) {
+			return m_offsets[nid] < link;
+		}) - m_fed_neurons.begin()));
+	}
+	bounds.push_back(m_fed_neurons.size());
+
+	const neuron_value_t* previous_values = previous.data();
+	neuron_value_t* next_values = next.data();
+	pool.parallel_for(number_of_tasks, [&](size_t t) {
+		helper_activate_synchronous(weights, previous_values, next_values, bounds[t], bounds[t + 1]);
+	});
+}
+
+void netkit::compiled_network::get_outputs(const std::vector<neuron_value_t>& values,
+										   std::vector<neuron_value_t>& outputs) const {
+	outputs.resize(m_output_ids.size());
+	for (size_t i = 0; i < m_output_ids.size(); ++i) {
+		outputs[i] = values[m_output_ids[i]];
+	}
+}
+
+std::vector<netkit::neuron_value_t> netkit::compiled_network::evaluate(const neuron_value_t* weights,
+																	   const std::vector<neuron_value_t>& inputs,
+																	   std::vector<neuron_value_t>& values) const {
+	flush(values);
+	load_inputs(values, inputs);
+	activate_until_relaxation(weights, values);
+
+	std::vector<neuron_value_t> outputs;
+	get_outputs(values, outputs);
+	return outputs;
+}
+
+std::vector<netkit::neuron_value_t> netkit::compiled_network::evaluate(const neuron_value_t* weights,
+																	   const std::vector<neuron_value_t>& inputs,
+																	   std::vector<neuron_value_t>& values,
+																	   thread_pool& pool) const {
+	if (!m_feed_forward) {
+		return evaluate(weights, inputs, values);
+	}
+
+	flush(values);
+	load_inputs(values, inputs);
+	activate_feed_forward(weights, values, pool);
+
+	std::vector<neuron_value_t> outputs;
+	get_outputs(values, outputs);
+	return outputs;
+}
+
+void netkit::compiled_network::evaluate_batch(const neuron_value_t* weights, const neuron_value_t* inputs,
+											  size_t batch_size, neuron_value_t* outputs,
+											  std::vector<neuron_value_t>& values) const {
+	// one row of batch_size values per neuron, plus a row of sums.
+	values.assign((number_of_neurons() + 1) * batch_size, 0);
+	neuron_value_t* sums = values.data() + number_of_neurons() * batch_size;
+	std::fill(values.begin() + network::BIAS_ID * batch_size, values.begin() + (network::BIAS_ID + 1) * batch_size, 1);
+
+	for (size_t i = 0; i < m_input_ids.size(); ++i) {
+		neuron_value_t* row = values.data() + m_input_ids[i] * batch_size;
+		for (size_t b = 0; b < batch_size; ++b) {
+			row[b] = inputs[b * m_input_ids.size() + i];
+		}
+	}
+
+	// the passes of activate_until_relaxation (the network depth can be lower than the number of levels).
+	for (int pass = m_depth; pass--;) {
+		for (neuron_id_t nid : m_fed_neurons) {
+			helper_activate_batch(nid, weights, batch_size, values.data(), sums);
+		}
+	}
+
+	for (size_t o = 0; o < m_output_ids.size(); ++o) {
+		const neuron_value_t* row = values.data() + m_output_ids[o] * batch_size;
+		for (size_t b = 0; b < batch_size; ++b) {
+			outputs[b * m_output_ids.size() + o] = row[b];
+		}
+	}
+}
+
+netkit::memory_report netkit::compiled_network::memory_usage() const {
+	memory_report report = vector_memory(m_sources) + vector_memory(m_weights) + vector_memory(m_offsets);
+	report += vector_overhead(m_link_ids) + vector_overhead(m_fed_neurons);
+	report += vector_memory(m_activations) + vector_memory(m_raw_activations) + vector_memory(m_derivatives);
+	report += vector_overhead(m_functions) + vector_overhead(m_lookup_tables) + vector_overhead(m_groups);
+	report += vector_overhead(m_topological_order) + vector_overhead(m_level_offsets);
+	report += vector_overhead(m_cumulative_links);
+	report += vector_overhead(m_input_ids) + vector_overhead(m_output_ids);
+	return report;
+}
+
+void netkit::compiled_network::helper_add_activation(const activation_func_t& func) {
+	m_activations.push_back(func);
+	const raw_activation_t* raw = func.target<raw_activation_t>();
+	m_raw_activations.push_back(raw != nullptr ? *raw : nullptr);
+
+	activation_function_t function = NUMBER_OF_ACTIVATION_FUNCTIONS;
+	bool lookup_table = false;
+	if (raw == nullptr || !identify_activation_function(*raw, function, lookup_table)) {
+		function = NUMBER_OF_ACTIVATION_FUNCTIONS;
+	}
+	m_functions.push_back(function);
+	m_lookup_tables.push_back(lookup_table);
+	m_derivatives.push_back(function != NUMBER_OF_ACTIVATION_FUNCTIONS ? activation_derivative(function) : nullptr);
+}
+
+size_t netkit::compiled_network::helper_number_of_tasks(size_t links, const thread_pool& pool) {
+	// a single worker would only make the calling thread wait.
+	if (pool.size() < 2) {
+		return 1;
+	}
+	// a few tasks per worker to even out their durations, as parallel_for does.
+	return std::min(pool.size() * 4, links / PARALLEL_LINKS_PER_TASK);
+}
+
+void netkit::compiled_network::helper_activate_feed_forward(const neuron_value_t* weights, neuron_value_t* values,
+															 size_t level_begin, size_t begin, size_t end) const {
+	// the scratch space after the neurons, indexed by the position in the level: the ranges of a level don't overlap.
+	neuron_value_t* scratch = values + number_of_neurons() - level_begin;
+
+	// the groups overlapping the range.
+	auto group = std::upper_bound(m_groups.begin(), m_groups.end(), begin,
+	[](size_t position, const activation_group& g) {
+		return position < g.end;
+	});
+	for (; group != m_groups.end() && group->begin < end; ++group) {
+		const size_t group_begin = std::max(group->begin, begin);
+		const size_t size = std::min(group->end, end) - group_begin;
+		const neuron_id_t* ids = m_topological_order.data() + group_begin;
+		neuron_value_t* sums = scratch + group_begin;
+
+		for (size_t k = 0; k < size; ++k) {
+			neuron_value_t sum = 0;
+			for (size_t i = m_offsets[ids[k]]; i < m_offsets[ids[k] + 1]; ++i) {
+				sum += values[m_sources[i]] * weights[i];
+			}
+			sums[k] = sum;
+		}
+
+		if (group->function != NUMBER_OF_ACTIVATION_FUNCTIONS) {
+			apply_activation(group->function, group->lookup_table, sums, sums, size);
+		} else {
+			for (size_t k = 0; k < size; ++k) {
+				sums[k] = helper_activate(ids[k], sums[k]);
+			}
+		}
+
+		for (size_t k = 0; k < size; ++k) {
+			values[ids[k]] = sums[k];
+		}
+	}
+}
+
+void netkit::compiled_network::helper_activate_synchronous(const neuron_value_t* weights,
+														   const neuron_value_t* previous, neuron_value_t* next,
+														   size_t begin, size_t end) const {
+	for (size_t f = begin; f < end; ++f) {
+		const neuron_id_t nid = m_fed_neurons[f];
+		neuron_value_t sum = 0;
+		for (size_t i = m_offsets[nid]; i < m_offsets[nid + 1]; ++i) {
+			sum += previous[m_sources[i]] * weights[i];
+		}
+		next[nid] = helper_activate(nid, sum);
+	}
+}
+
+void netkit::compiled_network::helper_activate_batch(neuron_id_t nid, const neuron_value_t* weights,
+													 size_t batch_size, neuron_value_t* values,
+													 neuron_value_t* sums) const {
+	std::fill(sums, sums + batch_size, 0);
+	for (size_t i = m_offsets[nid]; i < m_offsets[nid + 1]; ++i) {
+		const neuron_value_t weight = weights[i];
+		const neuron_value_t* source = values + m_sources[i] * batch_size;
+		for (size_t b = 0; b < batch_size; ++b) {
+			sums[b] += source[b] * weight;
+		}
+	}
+
+	neuron_value_t* row = values + nid * batch_size;
+	if (m_functions[nid] != NUMBER_OF_ACTIVATION_FUNCTIONS) {
+		apply_activation(m_functions[nid], m_lookup_tables[nid], sums, row, batch_size);
+	} else {
+		for (size_t b = 0; b < batch_size; ++b) {
+			row[b] = m_activations[nid](sums[b]);
+		}
+	}
+}
+
+void netkit::compiled_network::helper_sort_by_levels() {
+	// Kahn's algorithm, one level at a time.
+	std::vector<size_t> missing_inputs(number_of_neurons());
+	std::vector<std::vector<neuron_id_t>> targets(number_of_neurons());
+	for (neuron_id_t nid = 0; nid < number_of_neurons(); ++nid) {
+		missing_inputs[nid] = m_offsets[nid + 1] - m_offsets[nid];
+		for (size_t i = m_offsets[nid]; i < m_offsets[nid + 1]; ++i) {
+			targets[m_sources[i]].push_back(nid);
+		}
+	}
+
+	std::vector<neuron_id_t> current_level;
+	for (neuron_id_t nid = 0; nid < number_of_neurons(); ++nid) {
+		if (missing_inputs[nid] == 0) {
+			current_level.push_back(nid);
+		}
+	}
+
+	m_level_offsets.push_back(0);
+	std::vector<neuron_id_t> next_level;
+	while (!current_level.empty()) {
+		next_level.clear();
+		for (neuron_id_t nid : current_level) {
+			for (neuron_id_t target : targets[nid]) {
+				if (--missing_inputs[target] == 0) {
+					next_level.push_back(target);
+				}
+			}
+		}
+		if (next_level.empty()) {
+			break;
+		}
+
+		m_topological_order.insert(m_topological_order.end(), next_level.begin(), next_level.end());
+		m_level_offsets.push_back(m_topological_order.size());
+		std::swap(current_level, next_level);
+	}
+
+	m_feed_forward = m_topological_order.size() == m_fed_neurons.size();
+	if (!m_feed_forward) {
+		// the neurons on a cycle (or after one) never get all their inputs.
+		m_topological_order.clear();
+		m_level_offsets.clear();
+		return;
+	}
+
+	// group the neurons of each level by activation function.
+	auto group_key = [this](neuron_id_t nid) {
+		return 2 * static_cast<int>(m_functions[nid]) + (m_lookup_tables[nid] ? 1 : 0);
+	};
+	for (size_t l = 0; l + 1 < m_level_offsets.size(); ++l) {
+		auto level_begin = m_topological_order.begin() + m_level_offsets[l];
+		auto level_end = m_topological_order.begin() + m_level_offsets[l + 1];
+		std::stable_sort(level_begin, level_end, [&](neuron_id_t a, neuron_id_t b) {
+			return group_key(a) < group_key(b);
+		});
+
+		for (size_t begin = m_level_offsets[l]; begin < m_level_offsets[l + 1];) {
+			size_t end = begin + 1;
+			while (end < m_level_offsets[l + 1]
+					&& group_key(m_topological_order[end]) == group_key(m_topological_order[begin])) {
+				++end;
+			}
+			neuron_id_t first = m_topological_order[begin];
+			m_groups.push_back({begin, end, m_functions[first], m_lookup_tables[first]});
+			begin = end;
+		}
+		m_largest_level = std::max(m_largest_level, m_level_offsets[l + 1] - m_level_offsets[l]);
+	}
+
+	m_cumulative_links.reserve(m_topological_order.size() + 1);
+	m_cumulative_links.push_back(0);
+	for (neuron_id_t nid : m_topological_order) {
+		m_cumulative_links.push_back(m_cumulative_links.back() + m_offsets[nid + 1] - m_offsets[nid]);
+	}
+}
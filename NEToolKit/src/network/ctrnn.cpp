@@ -0,0 +1,347 @@
+#include <algorithm> // std::stable_sort, std::copy, std::fill
+#include <functional> // std::equal_to
+#include <stdexcept> // std::invalid_argument
+
+#include "netkit/network/ctrnn.h"
+#include "netkit/network/activation_functions.h"
+
+namespace {
+	using netkit::neuron_value_t;
+
+	// the loops work on blocks of a fixed size written to a local buffer: no alias between the inputs and the
+	// outputs and a known trip count, which is what the vectorizer needs at -O2 (see apply_activation).
+	const size_t BLOCK_SIZE = 16;
+
+	// out[i] = func(i) for the count values (func may read out[i]).
+	template <typename func_t>
+	void compute_by_blocks(neuron_value_t* out, size_t count, const func_t& func) {
+		size_t i = 0;
+		for (; i + BLOCK_SIZE <= count; i += BLOCK_SIZE) {
+			neuron_value_t block[BLOCK_SIZE];
+			for (size_t k = 0; k < BLOCK_SIZE; ++k) {
+				block[k] = func(i + k);
+			}
+			for (size_t k = 0; k < BLOCK_SIZE; ++k) {
+				out[i + k] = block[k];
+			}
+		}
+		for (; i < count; ++i) {
+			out[i] = func(i);
+		}
+	}
+
+	struct state_neuron {
+		netkit::neuron_id_t nid;
+		netkit::activation_function_t function; // NUMBER_OF_ACTIVATION_FUNCTIONS if unknown
+		bool lookup_table;
+	};
+}
+
+netkit::ctrnn::ctrnn(const network& net, const std::vector<neuron_value_t>& time_constants,
+					 const std::vector<neuron_value_t>& biases, neuron_value_t time_step,
+					 ctrnn_integration_t integration)
+	: m_slots(net.number_of_neurons(), 0)
+	, m_number_of_inputs(net.get_input_ids().size())
+	, m_first_state(net.get_input_ids().size() + 1)
+	, m_output_slots()
+	, m_offsets()
+	, m_sources()
+	, m_weights()
+	, m_biases()
+	, m_inverse_time_constants()
+	, m_activations()
+	, m_groups()
+	, m_time_step(time_step)
+	, m_integration(integration)
+	, m_values()
+	, m_scratch() {
+	const std::vector<neuron>& neurons = net.get_neurons();
+	const std::vector<link>& links = net.get_links();
+	if (time_constants.size() != neurons.size() || biases.size() != neurons.size()) {
+		throw std::invalid_argument("a CTRNN needs a time constant and a bias per neuron.");
+	}
+	if (!(time_step > 0)) {
+		throw std::invalid_argument("the time step must be positive.");
+	}
+
+	// the bias and the inputs have no state.
+	std::vector<bool> has_state(neurons.size(), true);
+	has_state[network::BIAS_ID] = false;
+	m_slots[network::BIAS_ID] = 0;
+	for (size_t i = 0; i < m_number_of_inputs; ++i) {
+		m_slots[net.get_input_ids()[i]] = i + 1;
+		has_state[net.get_input_ids()[i]] = false;
+	}
+
+	// the states, grouped by activation function (in the network order within a group).
+	std::vector<state_neuron> states;
+	for (neuron_id_t nid = 0; nid < neurons.size(); ++nid) {
+		if (!has_state[nid]) {
+			continue;
+		}
+		if (!(time_constants[nid] > 0)) {
+			throw std::invalid_argument("the time constants must be positive.");
+		}
+
+		state_neuron state = {nid, NUMBER_OF_ACTIVATION_FUNCTIONS, false};
+		const raw_activation_func_t* raw = neurons[nid].get_activation_func().target<raw_activation_func_t>();
+		if (raw == nullptr || !identify_activation_function(*raw, state.function, state.lookup_table)) {
+			state.function = NUMBER_OF_ACTIVATION_FUNCTIONS;
+			state.lookup_table = false;
+		}
+		states.push_back(state);
+	}
+	std::stable_sort(states.begin(), states.end(), [](const state_neuron& lhs, const state_neuron& rhs) {
+		return 2 * lhs.function + lhs.lookup_table < 2 * rhs.function + rhs.lookup_table;
+	});
+
+	for (size_t k = 0; k < states.size(); ++k) {
+		const state_neuron& state = states[k];
+		m_slots[state.nid] = m_first_state + k;
+		m_biases.push_back(biases[state.nid]);
+		m_inverse_time_constants.push_back(1 / time_constants[state.nid]);
+		m_activations.push_back(neurons[state.nid].get_activation_func());
+
+		if (m_groups.empty() || m_groups.back().function != state.function
+				|| m_groups.back().lookup_table != state.lookup_table) {
+			m_groups.push_back({k, k + 1, state.function, state.lookup_table});
+		} else {
+			++m_groups.back().end;
+		}
+	}
+
+	// the incoming links of every state, once all the slots are known.
+	m_offsets.push_back(0);
+	for (const state_neuron& state : states) {
+		for (link_id_t lid : neurons[state.nid].incoming_links_ids()) {
+			m_sources.push_back(m_slots[links[lid].from]);
+			m_weights.push_back(links[lid].weight);
+		}
+		m_offsets.push_back(m_sources.size());
+	}
+
+	for (neuron_id_t onid : net.get_output_ids()) {
+		m_output_slots.push_back(m_slots[onid]);
+	}
+
+	m_values.resize(m_first_state + states.size());
+	m_scratch.resize(3 * states.size());
+	flush();
+}
+
+void netkit::ctrnn::flush() {
+	std::fill(m_values.begin(), m_values.end(), 0);
+	m_values[0] = 1; // the bias
+}
+
+void netkit::ctrnn::load_inputs(const std::vector<neuron_value_t>& inputs) {
+	if (inputs.size() != m_number_of_inputs) {
+		throw std::invalid_argument("Incorrect number of neural network inputs.");
+	}
+	std::copy(inputs.begin(), inputs.end(), m_values.begin() + 1);
+}
+
+void netkit::ctrnn::step() {
+	helper_step(helper_view());
+}
+
+void netkit::ctrnn::advance(unsigned int steps) {
+	const agents_view view = helper_view();
+	for (unsigned int s = 0; s < steps; ++s) {
+		helper_step(view);
+	}
+}
+
+std::vector<netkit::neuron_value_t> netkit::ctrnn::get_outputs() const {
+	std::vector<neuron_value_t> outputs;
+	outputs.reserve(m_output_slots.size());
+	for (size_t slot : m_output_slots) {
+		outputs.push_back(m_values[slot]);
+	}
+	return outputs;
+}
+
+netkit::memory_report netkit::ctrnn::memory_usage() const {
+	memory_report report = vector_memory(m_sources) + vector_memory(m_weights) + vector_memory(m_offsets);
+	report += vector_memory(m_biases) + vector_memory(m_inverse_time_constants) + vector_memory(m_activations);
+	report += vector_memory(m_values) + vector_overhead(m_scratch);
+	report += vector_overhead(m_slots) + vector_overhead(m_output_slots) + vector_overhead(m_groups);
+	return report;
+}
+
+void netkit::ctrnn::helper_step(const agents_view& view) const {
+	const size_t count = number_of_neurons() * view.agents;
+	neuron_value_t* states = view.values + m_first_state * view.agents;
+	neuron_value_t* derivatives = view.scratch + count;
+	const neuron_value_t dt = m_time_step;
+
+	helper_derivatives(view, derivatives);
+	if (m_integration == RK2_INTEGRATION) {
+		// Heun: the mean of the derivatives at the start and at the end of the Euler step.
+		neuron_value_t* initial_states = view.scratch + 2 * count;
+		neuron_value_t* end_derivatives = view.scratch;
+		std::copy(states, states + count, initial_states);
+		compute_by_blocks(states, count, [&](size_t i) { return initial_states[i] + dt * derivatives[i]; });
+		helper_derivatives(view, end_derivatives);
+		compute_by_blocks(states, count, [&](size_t i) {
+			return initial_states[i] + dt / 2 * (derivatives[i] + end_derivatives[i]);
+		});
+	} else {
+		compute_by_blocks(states, count, [&](size_t i) { return states[i] + dt * derivatives[i]; });
+	}
+}
+
+void netkit::ctrnn::helper_derivatives(const agents_view& view, neuron_value_t* derivatives) const {
+	const size_t agents = view.agents;
+	neuron_value_t* sums = view.scratch; // may be the derivatives
+
+	// the sums of all the states first: the derivatives only depend on the states at the beginning of the step.
+	for (size_t k = 0; k < number_of_neurons(); ++k) {
+		neuron_value_t* sum = sums + k * agents;
+		const neuron_value_t* bias = view.biases + k * agents;
+
+		size_t a = 0;
+		for (; a + BLOCK_SIZE <= agents; a += BLOCK_SIZE) {
+			neuron_value_t block[BLOCK_SIZE];
+			for (size_t b = 0; b < BLOCK_SIZE; ++b) {
+				block[b] = bias[a + b];
+			}
+			for (size_t i = m_offsets[k]; i < m_offsets[k + 1]; ++i) {
+				const neuron_value_t* weight = view.weights + i * agents + a;
+				const neuron_value_t* source = view.values + m_sources[i] * agents + a;
+				for (size_t b = 0; b < BLOCK_SIZE; ++b) {
+					block[b] += weight[b] * source[b];
+				}
+			}
+			for (size_t b = 0; b < BLOCK_SIZE; ++b) {
+				sum[a + b] = block[b];
+			}
+		}
+		for (; a < agents; ++a) {
+			neuron_value_t value = bias[a];
+			for (size_t i = m_offsets[k]; i < m_offsets[k + 1]; ++i) {
+				value += view.weights[i * agents + a] * view.values[m_sources[i] * agents + a];
+			}
+			sum[a] = value;
+		}
+	}
+
+	for (const activation_group& group : m_groups) {
+		neuron_value_t* begin = sums + group.begin * agents;
+		const size_t count = (group.end - group.begin) * agents;
+		if (group.function != NUMBER_OF_ACTIVATION_FUNCTIONS) {
+			apply_activation(group.function, group.lookup_table, begin, begin, count);
+		} else {
+			for (size_t i = 0; i < count; ++i) {
+				begin[i] = m_activations[group.begin + i / agents](begin[i]);
+			}
+		}
+	}
+
+	const neuron_value_t* states = view.values + m_first_state * agents;
+	compute_by_blocks(derivatives, number_of_neurons() * agents, [&](size_t i) {
+		return (sums[i] - states[i]) * view.inverse_time_constants[i];
+	});
+}
+
+netkit::ctrnn::agents_view netkit::ctrnn::helper_view() {
+	return {1, m_weights.data(), m_biases.data(), m_inverse_time_constants.data(), m_values.data(), m_scratch.data()};
+}
+
+bool netkit::ctrnn::helper_same_topology(const ctrnn& other) const {
+	if (m_groups.size() != other.m_groups.size()) {
+		return false;
+	}
+	for (size_t g = 0; g < m_groups.size(); ++g) {
+		if (m_groups[g].end != other.m_groups[g].end || m_groups[g].function != other.m_groups[g].function
+				|| m_groups[g].lookup_table != other.m_groups[g].lookup_table) {
+			return false;
+		}
+	}
+
+	// the exact same time step on purpose: the agents of a batch share one integration, a close step isn't it.
+	return m_number_of_inputs == other.m_number_of_inputs && m_output_slots == other.m_output_slots
+		   && m_offsets == other.m_offsets && m_sources == other.m_sources
+		   && std::equal_to<neuron_value_t>()(m_time_step, other.m_time_step) && m_integration == other.m_integration;
+}
+
+netkit::ctrnn_batch::ctrnn_batch(const ctrnn& controller, size_t number_of_agents)
+	: m_topology(controller)
+	, m_agents(number_of_agents)
+	, m_weights(controller.number_of_links() * number_of_agents)
+	, m_biases(controller.number_of_neurons() * number_of_agents)
+	, m_inverse_time_constants(controller.number_of_neurons() * number_of_agents)
+	, m_values(controller.m_values.size() * number_of_agents)
+	, m_scratch(controller.m_scratch.size() * number_of_agents) {
+	if (number_of_agents == 0) {
+		throw std::invalid_argument("a batch needs at least one agent.");
+	}
+
+	for (size_t agent = 0; agent < m_agents; ++agent) {
+		set_controller(agent, controller);
+	}
+	flush();
+}
+
+void netkit::ctrnn_batch::set_controller(size_t agent, const ctrnn& controller) {
+	if (agent >= m_agents) {
+		throw std::invalid_argument("unknown agent.");
+	}
+	if (!m_topology.helper_same_topology(controller)) {
+		throw std::invalid_argument("the controller doesn't have the topology of the batch.");
+	}
+
+	for (size_t i = 0; i < controller.m_weights.size(); ++i) {
+		m_weights[i * m_agents + agent] = controller.m_weights[i];
+	}
+	for (size_t k = 0; k < controller.m_biases.size(); ++k) {
+		m_biases[k * m_agents + agent] = controller.m_biases[k];
+		m_inverse_time_constants[k * m_agents + agent] = controller.m_inverse_time_constants[k];
+	}
+}
+
+void netkit::ctrnn_batch::flush() {
+	std::fill(m_values.begin(), m_values.end(), 0);
+	std::fill(m_values.begin(), m_values.begin() + m_agents, 1); // the bias
+}
+
+void netkit::ctrnn_batch::load_inputs(const neuron_value_t* inputs) {
+	const size_t number_of_inputs = m_topology.number_of_inputs();
+	for (size_t a = 0; a < m_agents; ++a) {
+		for (size_t i = 0; i < number_of_inputs; ++i) {
+			m_values[(i + 1) * m_agents + a] = inputs[a * number_of_inputs + i];
+		}
+	}
+}
+
+void netkit::ctrnn_batch::step() {
+	m_topology.helper_step(helper_view());
+}
+
+void netkit::ctrnn_batch::advance(unsigned int steps) {
+	const ctrnn::agents_view view = helper_view();
+	for (unsigned int s = 0; s < steps; ++s) {
+		m_topology.helper_step(view);
+	}
+}
+
+void netkit::ctrnn_batch::get_outputs(neuron_value_t* outputs) const {
+	const std::vector<size_t>& output_slots = m_topology.m_output_slots;
+	for (size_t a = 0; a < m_agents; ++a) {
+		for (size_t o = 0; o < output_slots.size(); ++o) {
+			outputs[a * output_slots.size() + o] = m_values[output_slots[o] * m_agents + a];
+		}
+	}
+}
+
+netkit::memory_report netkit::ctrnn_batch::memory_usage() const {
+	memory_report report = m_topology.memory_usage();
+	report += vector_memory(m_weights) + vector_memory(m_biases) + vector_memory(m_inverse_time_constants);
+	report += vector_memory(m_values) + vector_overhead(m_scratch);
+	return report;
+}
+
+netkit::ctrnn::agents_view netkit::ctrnn_batch::helper_view() {
+	return {m_agents, m_weights.data(), m_biases.data(), m_inverse_time_constants.data(), m_values.data(),
+			m_scratch.data()};
+}
@@ -66,6 +66,23 @@ void netkit::network::activate() {
 	}
 }
 
+void netkit::network::activate_synchronous() {
+	// all the sums first, from the values of the previous activation.
+	std::vector<neuron_value_t> sums(m_all_neurons.size(), 0);
+	for (size_t nid = 0; nid < m_all_neurons.size(); ++nid) {
+		for (link_id_t lid : m_all_neurons[nid].incoming_links_ids()) {
+			const link& incoming = m_links[lid];
+			sums[nid] += m_all_neurons[incoming.from].get_value() * incoming.weight;
+		}
+	}
+
+	for (size_t nid = 0; nid < m_all_neurons.size(); ++nid) {
+		if (!m_all_neurons[nid].incoming_links_ids().empty()) {
+			m_all_neurons[nid].feed(sums[nid]);
+		}
+	}
+}
+
 void netkit::network::activate_until_relaxation() {
 	for (int i = max_depth(); i--;) {
 		activate();
@@ -183,6 +200,15 @@ int netkit::network::max_depth() const {
 	return m_max_depth;
 }
 
+netkit::memory_report netkit::network::memory_usage() const {
+	memory_report report = vector_memory(m_links) + vector_memory(m_all_neurons);
+	for (const neuron& n : m_all_neurons) {
+		report += vector_overhead(n.incoming_links_ids()) + vector_overhead(n.outgoing_links_ids());
+	}
+	report += vector_overhead(m_input_neuron_ids) + vector_overhead(m_output_neuron_ids);
+	return report;
+}
+
 std::ostream& netkit::operator<<(std::ostream& os, const network& net) {
 	os << "<network:" << std::endl;
 
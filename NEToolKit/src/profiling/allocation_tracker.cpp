@@ -0,0 +1,100 @@
+#include <array>
+#include <atomic>
+
+#include "netkit/profiling/allocation_tracker.h"
+
+namespace {
+	std::atomic<bool> hooks_installed(false);
+
+	// plain data without destructor: usable by the hooks at any time, even while the thread exits.
+	thread_local netkit::allocation_counts thread_counts;
+
+	struct atomic_counts {
+		std::atomic<uint64_t> allocations{0};
+		std::atomic<uint64_t> bytes{0};
+		std::atomic<uint64_t> deallocations{0};
+	};
+
+	std::array<atomic_counts, netkit::NUMBER_OF_ALLOC_SUBSYSTEMS> subsystem_counts;
+}
+
+netkit::allocation_counts& netkit::allocation_counts::operator+=(const allocation_counts& other) {
+	allocations += other.allocations;
+	bytes += other.bytes;
+	deallocations += other.deallocations;
+	return *this;
+}
+
+netkit::allocation_counts netkit::allocation_counts::operator-(const allocation_counts& other) const {
+	allocation_counts result;
+	result.allocations = allocations - other.allocations;
+	result.bytes = bytes - other.bytes;
+	result.deallocations = deallocations - other.deallocations;
+	return result;
+}
+
+const char* netkit::alloc_subsystem_name(alloc_subsystem_t subsystem) {
+	switch (subsystem) {
+	case ALLOC_GENERATE_NETWORK:
+		return "generate_network";
+	case ALLOC_SERIALIZATION:
+		return "serialization";
+	default:
+		return "unknown";
+	}
+}
+
+bool netkit::allocation_hooks_installed() {
+	return hooks_installed.load(std::memory_order_relaxed);
+}
+
+void netkit::mark_allocation_hooks_installed() {
+	hooks_installed.store(true, std::memory_order_relaxed);
+}
+
+void netkit::record_allocation(size_t bytes) {
+	++thread_counts.allocations;
+	thread_counts.bytes += bytes;
+}
+
+void netkit::record_deallocation() {
+	++thread_counts.deallocations;
+}
+
+netkit::allocation_counts netkit::thread_allocation_counts() {
+	return thread_counts;
+}
+
+netkit::allocation_counts netkit::get_allocation_counts(alloc_subsystem_t subsystem) {
+	allocation_counts result;
+	result.allocations = subsystem_counts[subsystem].allocations.load(std::memory_order_relaxed);
+	result.bytes = subsystem_counts[subsystem].bytes.load(std::memory_order_relaxed);
+	result.deallocations = subsystem_counts[subsystem].deallocations.load(std::memory_order_relaxed);
+	return result;
+}
+
+void netkit::reset_allocation_counts() {
+	for (atomic_counts& counts : subsystem_counts) {
+		counts.allocations.store(0);
+		counts.bytes.store(0);
+		counts.deallocations.store(0);
+	}
+}
+
+netkit::allocation_scope::allocation_scope(alloc_subsystem_t subsystem)
+	: m_subsystem(subsystem)
+	, m_tracking(allocation_hooks_installed())
+	, m_start() {
+	if (m_tracking) {
+		m_start = thread_counts;
+	}
+}
+
+netkit::allocation_scope::~allocation_scope() {
+	if (m_tracking) {
+		allocation_counts delta = thread_counts - m_start;
+		subsystem_counts[m_subsystem].allocations.fetch_add(delta.allocations, std::memory_order_relaxed);
+		subsystem_counts[m_subsystem].bytes.fetch_add(delta.bytes, std::memory_order_relaxed);
+		subsystem_counts[m_subsystem].deallocations.fetch_add(delta.deallocations, std::memory_order_relaxed);
+	}
+}
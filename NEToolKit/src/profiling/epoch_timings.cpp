@@ -0,0 +1,26 @@
+#include "netkit/profiling/epoch_timings.h"
+
+const char* netkit::phase_name(phase_t phase) {
+	switch (phase) {
+	case SPECIES_STATS:
+		return "species_stats";
+	case OFFSPRING_ALLOCATION:
+		return "offspring_allocation";
+	case REPRODUCTION:
+		return "reproduction";
+	case CROSSOVER:
+		return "crossover";
+	case MUTATION:
+		return "mutation";
+	case INNOVATION_LOOKUP:
+		return "innovation_lookup";
+	case RESPECIATION:
+		return "respeciation";
+	case EXTINCTION:
+		return "extinction";
+	case THRESHOLD_ADJUSTMENT:
+		return "threshold_adjustment";
+	default:
+		return "unknown";
+	}
+}
@@ -0,0 +1,39 @@
+#include "netkit/profiling/memory_report.h"
+
+netkit::memory_report& netkit::memory_report::operator+=(const memory_report& other) {
+	used += other.used;
+	reserved += other.reserved;
+	overhead += other.overhead;
+	mapped += other.mapped;
+	return *this;
+}
+
+netkit::memory_report netkit::operator+(memory_report lhs, const memory_report& rhs) {
+	lhs += rhs;
+	return lhs;
+}
+
+std::ostream& netkit::operator<<(std::ostream& os, const memory_report& report) {
+	os << report.total() << " bytes (used: " << report.used << ", slack: " << report.slack()
+	   << ", overhead: " << report.overhead;
+	if (report.mapped > 0) {
+		os << ", mapped: " << report.mapped;
+	}
+	os << ")";
+	return os;
+}
+
+netkit::memory_report netkit::neat_memory_report::total() const {
+	return population + organisms + species + innovation_pool + best_genomes;
+}
+
+std::ostream& netkit::operator<<(std::ostream& os, const neat_memory_report& report) {
+	os << "total: " << report.total() << "\n";
+	os << "population (" << report.number_of_genomes << " genomes, " << report.number_of_genes << " genes): "
+	   << report.population << "\n";
+	os << "organisms: " << report.organisms << "\n";
+	os << "species: " << report.species << "\n";
+	os << "innovation pool (" << report.number_of_innovations << " innovations): " << report.innovation_pool << "\n";
+	os << "best genomes: " << report.best_genomes << "\n";
+	return os;
+}
@@ -0,0 +1,318 @@
+#include <sstream>
+#include <fstream>
+#include <cmath> // std::isnan
+#include <limits>
+#include <algorithm> // std::min
+#include <cstdio> // std::rename
+#include <stdexcept> // std::runtime_error
+
+#if defined(__unix__) || defined(__APPLE__)
+#define NETKIT_HAS_SOCKETS
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+#include "netkit/profiling/metrics_exporter.h"
+#include "netkit/neat/base_neat.h"
+#include "netkit/neat/base_population.h"
+
+namespace {
+	const double UNSET = std::numeric_limits<double>::quiet_NaN();
+
+	// sleep for the given duration, but wake up regularly to check the stop flag.
+	void interruptible_sleep(std::chrono::milliseconds duration, const std::atomic<bool>& stop) {
+		const std::chrono::milliseconds slice(50);
+		auto deadline = std::chrono::steady_clock::now() + duration;
+		while (!stop.load() && std::chrono::steady_clock::now() < deadline) {
+			std::this_thread::sleep_for(std::min(slice, std::chrono::duration_cast<std::chrono::milliseconds>(
+													 deadline - std::chrono::steady_clock::now())));
+		}
+	}
+
+	void write_metric_header(std::ostream& os, const char* name, const char* type, const char* help) {
+		os << "# HELP " << name << " " << help << "\n";
+		os << "# TYPE " << name << " " << type << "\n";
+	}
+
+	void write_metric(std::ostream& os, const char* name, const char* type, const char* help, double value) {
+		if (std::isnan(value)) {
+			return;
+		}
+		write_metric_header(os, name, type, help);
+		os << name << " " << value << "\n";
+	}
+}
+
+netkit::metrics_exporter::metrics_exporter()
+	: m_gauges()
+	, m_phase_seconds()
+	, m_epochs(0)
+	, m_evaluations(0)
+	, m_evaluations_at_last_publish(0)
+	, m_last_publish(std::chrono::steady_clock::now())
+	, m_stop(false)
+	, m_file_writer()
+	, m_file_error_mutex()
+	, m_last_file_error()
+	, m_failed_writes(0)
+	, m_http_server()
+	, m_listen_fd(-1)
+	, m_port(0) {
+	for (auto& gauge : m_gauges) {
+		gauge.store(UNSET);
+	}
+	for (auto& phase : m_phase_seconds) {
+		phase.store(UNSET);
+	}
+}
+
+netkit::metrics_exporter::~metrics_exporter() {
+	stop();
+}
+
+void netkit::metrics_exporter::publish(const base_neat& neat, double epoch_seconds) {
+	auto now = std::chrono::steady_clock::now();
+	uint64_t evaluations = m_evaluations.load(std::memory_order_relaxed);
+	double elapsed = std::chrono::duration<double>(now - m_last_publish).count();
+	if (elapsed > 0) {
+		set(EVALUATIONS_PER_SECOND, static_cast<double>(evaluations - m_evaluations_at_last_publish) / elapsed);
+	}
+	m_evaluations_at_last_publish = evaluations;
+	m_last_publish = now;
+
+	m_epochs.fetch_add(1, std::memory_order_relaxed);
+	set(EPOCH_SECONDS, epoch_seconds);
+	set(POPULATION_SIZE, static_cast<double>(neat.pop()->size()));
+	set(NUMBER_OF_SPECIES, static_cast<double>(neat.get_all_species().size()));
+	set(INNOVATIONS, static_cast<double>(neat.innov_pool.number_of_innovations()));
+
+	if (neat.params.record_epoch_timings) {
+		const epoch_timings& timings = neat.get_last_epoch_timings();
+		for (size_t phase = 0; phase < NUMBER_OF_PHASES; ++phase) {
+			m_phase_seconds[phase].store(timings.seconds[phase], std::memory_order_relaxed);
+		}
+	}
+
+	if (neat.params.record_memory_usage) {
+		const neat_memory_report& memory = neat.get_last_memory_usage();
+		set(POPULATION_MEMORY, static_cast<double>(memory.population.total()));
+		set(TOTAL_MEMORY, static_cast<double>(memory.total().total()));
+	}
+
+	if (!neat.get_stats_history().empty()) {
+		const generation_stats& row = neat.get_stats_history().back();
+		set(GENERATION_BEST_FITNESS, row.best_fitness);
+		set(GENERATION_AVG_FITNESS, row.avg_fitness);
+	}
+
+	if (neat.has_best_genome_ever()) {
+		set(BEST_FITNESS_EVER, neat.get_best_fitness_ever());
+	}
+}
+
+void netkit::metrics_exporter::add_evaluations(uint64_t number_of_evaluations) {
+	m_evaluations.fetch_add(number_of_evaluations, std::memory_order_relaxed);
+}
+
+std::string netkit::metrics_exporter::render() const {
+	std::ostringstream os;
+	os.precision(12);
+
+	auto gauge = [this](gauge_t g) {
+		return m_gauges[g].load(std::memory_order_relaxed);
+	};
+
+	write_metric_header(os, "netkit_epochs_total", "counter", "Number of epochs performed.");
+	os << "netkit_epochs_total " << m_epochs.load(std::memory_order_relaxed) << "\n";
+	write_metric_header(os, "netkit_evaluations_total", "counter", "Number of organisms handed out for evaluation.");
+	os << "netkit_evaluations_total " << m_evaluations.load(std::memory_order_relaxed) << "\n";
+	write_metric(os, "netkit_evaluations_per_second", "gauge",
+				 "Evaluations per second between the last two epochs.", gauge(EVALUATIONS_PER_SECOND));
+	write_metric(os, "netkit_epoch_seconds", "gauge", "Duration of the last epoch.", gauge(EPOCH_SECONDS));
+
+	bool has_phases = false;
+	for (const auto& phase : m_phase_seconds) {
+		has_phases = has_phases || !std::isnan(phase.load(std::memory_order_relaxed));
+	}
+	if (has_phases) {
+		write_metric_header(os, "netkit_epoch_phase_seconds", "gauge",
+							"Duration of each phase of the last epoch (nested phases are included in their parent).");
+		for (size_t phase = 0; phase < NUMBER_OF_PHASES; ++phase) {
+			os << "netkit_epoch_phase_seconds{phase=\"" << phase_name(static_cast<phase_t>(phase)) << "\"} "
+			   << m_phase_seconds[phase].load(std::memory_order_relaxed) << "\n";
+		}
+	}
+
+	write_metric(os, "netkit_population_size", "gauge", "Number of genomes.", gauge(POPULATION_SIZE));
+	write_metric(os, "netkit_species", "gauge", "Number of species.", gauge(NUMBER_OF_SPECIES));
+	write_metric(os, "netkit_innovations", "gauge", "Size of the innovation pool.", gauge(INNOVATIONS));
+	write_metric(os, "netkit_population_memory_bytes", "gauge", "Heap memory of the population.",
+				 gauge(POPULATION_MEMORY));
+	write_metric(os, "netkit_memory_bytes", "gauge", "Heap memory of the whole instance.", gauge(TOTAL_MEMORY));
+	write_metric(os, "netkit_best_fitness_ever", "gauge", "Fitness of the best genome ever.", gauge(BEST_FITNESS_EVER));
+	write_metric(os, "netkit_generation_best_fitness", "gauge", "Best fitness of the last rated generation.",
+				 gauge(GENERATION_BEST_FITNESS));
+	write_metric(os, "netkit_generation_avg_fitness", "gauge", "Average fitness of the last rated generation.",
+				 gauge(GENERATION_AVG_FITNESS));
+
+	return os.str();
+}
+
+void netkit::metrics_exporter::write_to_file(const std::string& path) const {
+	std::string tmp_path = path + ".tmp";
+	{
+		std::ofstream file(tmp_path, std::ios::trunc);
+		if (!file) {
+			throw std::runtime_error("unable to open " + tmp_path + " to write the metrics.");
+		}
+		file << render();
+	}
+	if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+		throw std::runtime_error("unable to replace " + path + " with the new metrics.");
+	}
+}
+
+void netkit::metrics_exporter::start_file_writer(const std::string& path, std::chrono::milliseconds period) {
+	if (m_file_writer.joinable()) {
+		throw std::runtime_error("the metrics file writer is already running.");
+	}
+	m_stop.store(false);
+	m_file_writer = std::thread(&metrics_exporter::helper_file_writer_loop, this, path, period);
+}
+
+std::string netkit::metrics_exporter::get_last_file_error() const {
+	std::lock_guard<std::mutex> lock(m_file_error_mutex);
+	return m_last_file_error;
+}
+
+void netkit::metrics_exporter::start_http_server(uint16_t port) {
+	if (m_http_server.joinable()) {
+		throw std::runtime_error("the metrics HTTP server is already running.");
+	}
+
+#ifdef NETKIT_HAS_SOCKETS
+	m_listen_fd = ::socket(AF_INET, SOCK_STREAM, 0);
+	if (m_listen_fd < 0) {
+		throw std::runtime_error("unable to create the metrics socket.");
+	}
+
+	int reuse = 1;
+	::setsockopt(m_listen_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+	sockaddr_in address{};
+	address.sin_family = AF_INET;
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK); // local only
+	address.sin_port = htons(port);
+	socklen_t address_size = sizeof(address);
+	if (::bind(m_listen_fd, reinterpret_cast<sockaddr*>(&address), address_size) != 0
+		|| ::listen(m_listen_fd, 16) != 0
+		|| ::getsockname(m_listen_fd, reinterpret_cast<sockaddr*>(&address), &address_size) != 0) {
+		::close(m_listen_fd);
+		m_listen_fd = -1;
+		throw std::runtime_error("unable to listen on 127.0.0.1:" + std::to_string(port) + " for the metrics.");
+	}
+	m_port = ntohs(address.sin_port);
+
+	m_stop.store(false);
+	m_http_server = std::thread(&metrics_exporter::helper_http_server_loop, this);
+#else
+	throw std::runtime_error("the metrics HTTP server is only available on POSIX systems.");
+#endif
+}
+
+void netkit::metrics_exporter::stop() {
+	m_stop.store(true);
+	if (m_file_writer.joinable()) {
+		m_file_writer.join();
+	}
+	if (m_http_server.joinable()) {
+		m_http_server.join();
+	}
+#ifdef NETKIT_HAS_SOCKETS
+	if (m_listen_fd >= 0) {
+		::close(m_listen_fd);
+		m_listen_fd = -1;
+	}
+#endif
+}
+
+void netkit::metrics_exporter::helper_file_writer_loop(std::string path, std::chrono::milliseconds period) {
+	while (!m_stop.load()) {
+		helper_try_write_to_file(path);
+		interruptible_sleep(period, m_stop);
+	}
+	helper_try_write_to_file(path); // the final values
+}
+
+void netkit::metrics_exporter::helper_try_write_to_file(const std::string& path) {
+	// an exception escaping the writer thread would terminate the whole evolution.
+	try {
+		write_to_file(path);
+	} catch (const std::exception& e) {
+		std::lock_guard<std::mutex> lock(m_file_error_mutex);
+		m_last_file_error = e.what();
+		++m_failed_writes;
+	}
+}
+
+void netkit::metrics_exporter::helper_http_server_loop() {
+#ifdef NETKIT_HAS_SOCKETS
+	while (!m_stop.load()) {
+		pollfd listener{m_listen_fd, POLLIN, 0};
+		if (::poll(&listener, 1, 100) <= 0) {
+			continue; // timeout (check the stop flag) or interrupted
+		}
+
+		int client_fd = ::accept(m_listen_fd, nullptr, nullptr);
+		if (client_fd < 0) {
+			continue;
+		}
+
+		// read the request line (the headers and the body, if any, are ignored).
+		std::string request;
+		char buffer[1024];
+		while (request.find("\r\n") == std::string::npos && request.size() < 8192) {
+			pollfd client{client_fd, POLLIN, 0};
+			if (::poll(&client, 1, 1000) <= 0) {
+				break;
+			}
+			ssize_t received = ::recv(client_fd, buffer, sizeof(buffer), 0);
+			if (received <= 0) {
+				break;
+			}
+			request.append(buffer, static_cast<size_t>(received));
+		}
+
+		std::string status = "200 OK";
+		std::string body;
+		if (request.rfind("GET /metrics ", 0) == 0 || request.rfind("GET / ", 0) == 0) {
+			body = render();
+		} else {
+			status = "404 Not Found";
+			body = "try GET /metrics\n";
+		}
+
+		std::string response = "HTTP/1.0 " + status + "\r\n"
+							   "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+							   "Content-Length: " + std::to_string(body.size()) + "\r\n"
+							   "Connection: close\r\n\r\n" + body;
+
+		int flags = 0;
+#ifdef MSG_NOSIGNAL
+		flags = MSG_NOSIGNAL; // a client closing early must not kill the process
+#endif
+		size_t sent = 0;
+		while (sent < response.size()) {
+			ssize_t written = ::send(client_fd, response.data() + sent, response.size() - sent, flags);
+			if (written <= 0) {
+				break;
+			}
+			sent += static_cast<size_t>(written);
+		}
+		::close(client_fd);
+	}
+#endif
+}
@@ -0,0 +1,118 @@
+#include "netkit/profiling/perf_counters.h"
+
+#ifdef __linux__
+#include <cstring> // std::memset
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+namespace {
+	int open_counter(uint64_t config, int group_fd) {
+		perf_event_attr attr;
+		std::memset(&attr, 0, sizeof(attr));
+		attr.size = sizeof(attr);
+		attr.type = PERF_TYPE_HARDWARE;
+		attr.config = config;
+		attr.disabled = group_fd == -1 ? 1 : 0; // the whole group is enabled through the leader
+		attr.exclude_kernel = 1; // allowed with a restrictive perf_event_paranoid
+		attr.exclude_hv = 1;
+		attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+		return static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, group_fd, 0));
+	}
+}
+#endif
+
+const char* netkit::counter_name(counter_t counter) {
+	switch (counter) {
+	case CYCLES:
+		return "cycles";
+	case INSTRUCTIONS:
+		return "instructions";
+	case CACHE_MISSES:
+		return "cache_misses";
+	case BRANCH_MISSES:
+		return "branch_misses";
+	default:
+		return "unknown";
+	}
+}
+
+netkit::counter_values& netkit::counter_values::operator+=(const counter_values& other) {
+	for (size_t i = 0; i < values.size(); ++i) {
+		values[i] += other.values[i];
+	}
+	return *this;
+}
+
+netkit::counter_values netkit::counter_values::operator-(const counter_values& other) const {
+	counter_values result;
+	for (size_t i = 0; i < values.size(); ++i) {
+		result.values[i] = values[i] - other.values[i];
+	}
+	return result;
+}
+
+netkit::perf_counters::perf_counters()
+	: m_fds()
+	, m_available(false) {
+	m_fds.fill(-1);
+
+#ifdef __linux__
+	const uint64_t configs[NUMBER_OF_COUNTERS] = {
+		PERF_COUNT_HW_CPU_CYCLES,
+		PERF_COUNT_HW_INSTRUCTIONS,
+		PERF_COUNT_HW_CACHE_MISSES,
+		PERF_COUNT_HW_BRANCH_MISSES
+	};
+
+	for (size_t i = 0; i < NUMBER_OF_COUNTERS; ++i) {
+		m_fds[i] = open_counter(configs[i], i == 0 ? -1 : m_fds[0]);
+		if (m_fds[i] < 0) {
+			return; // degrade to no counters at all (the destructor closes the opened ones).
+		}
+	}
+
+	ioctl(m_fds[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+	ioctl(m_fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+	m_available = true;
+#endif
+}
+
+netkit::perf_counters::~perf_counters() {
+#ifdef __linux__
+	for (int fd : m_fds) {
+		if (fd >= 0) {
+			close(fd);
+		}
+	}
+#endif
+}
+
+netkit::counter_values netkit::perf_counters::read() const {
+	counter_values result;
+
+#ifdef __linux__
+	if (!m_available) {
+		return result;
+	}
+
+	// nr, time_enabled, time_running, then one value per counter.
+	uint64_t buffer[3 + NUMBER_OF_COUNTERS];
+	if (::read(m_fds[0], buffer, sizeof(buffer)) != static_cast<ssize_t>(sizeof(buffer)) || buffer[0] != NUMBER_OF_COUNTERS) {
+		return result;
+	}
+
+	uint64_t enabled = buffer[1];
+	uint64_t running = buffer[2];
+	for (size_t i = 0; i < NUMBER_OF_COUNTERS; ++i) {
+		result.values[i] = running == 0 || running == enabled
+						   ? buffer[3 + i]
+						   : static_cast<uint64_t>(static_cast<double>(buffer[3 + i]) * static_cast<double>(enabled)
+												   / static_cast<double>(running));
+	}
+#endif
+
+	return result;
+}
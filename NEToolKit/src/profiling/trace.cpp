@@ -0,0 +1,103 @@
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip> // std::setprecision
+
+#include "netkit/profiling/trace.h"
+
+namespace {
+	const size_t EVENTS_PER_THREAD = 1 << 16;
+
+	struct trace_event {
+		const char* name;
+		uint64_t start_ns;
+		uint64_t end_ns;
+	};
+
+	// single producer (the owner thread): the event is written, then the head is published.
+	struct thread_buffer {
+		explicit thread_buffer(uint32_t tid_) : tid(tid_), head(0), events(EVENTS_PER_THREAD) {}
+
+		uint32_t tid;
+		std::atomic<uint64_t> head; // number of events ever recorded
+		std::vector<trace_event> events;
+	};
+
+	// the buffers outlive their thread so the events of finished threads can still be written.
+	std::mutex registry_mutex;
+	std::vector<std::shared_ptr<thread_buffer>> registry;
+
+	thread_buffer& local_buffer() {
+		thread_local std::shared_ptr<thread_buffer> buffer = []() {
+			std::lock_guard<std::mutex> lock(registry_mutex); // once per thread
+			auto b = std::make_shared<thread_buffer>(static_cast<uint32_t>(registry.size() + 1));
+			registry.push_back(b);
+			return b;
+		}();
+		return *buffer;
+	}
+
+	const std::chrono::steady_clock::time_point origin = std::chrono::steady_clock::now();
+}
+
+uint64_t netkit::trace_now_ns() {
+	return static_cast<uint64_t>(
+		std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - origin).count()
+	);
+}
+
+void netkit::trace_record(const char* name, uint64_t start_ns, uint64_t end_ns) {
+	thread_buffer& buffer = local_buffer();
+	uint64_t head = buffer.head.load(std::memory_order_relaxed);
+	buffer.events[head % EVENTS_PER_THREAD] = {name, start_ns, end_ns};
+	buffer.head.store(head + 1, std::memory_order_release);
+}
+
+bool netkit::write_chrome_trace(const std::string& filename) {
+	std::ofstream file(filename);
+	if (!file) {
+		return false;
+	}
+
+	file << std::fixed << std::setprecision(3); // microseconds with nanoseconds precision
+	file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+	bool first = true;
+
+	std::lock_guard<std::mutex> lock(registry_mutex);
+	for (const auto& buffer : registry) {
+		uint64_t head = buffer->head.load(std::memory_order_acquire);
+		uint64_t oldest = head > EVENTS_PER_THREAD ? head - EVENTS_PER_THREAD : 0;
+
+		file << (first ? "" : ",") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->tid
+			 << ",\"args\":{\"name\":\"thread " << buffer->tid << "\"}}";
+		first = false;
+
+		for (uint64_t i = oldest; i < head; ++i) {
+			const trace_event& e = buffer->events[i % EVENTS_PER_THREAD];
+			file << ",{\"name\":\"" << e.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->tid
+				 << ",\"ts\":" << static_cast<double>(e.start_ns) / 1000.0
+				 << ",\"dur\":" << static_cast<double>(e.end_ns - e.start_ns) / 1000.0 << "}";
+		}
+	}
+	file << "]}" << std::endl;
+
+	return static_cast<bool>(file);
+}
+
+void netkit::trace_clear() {
+	std::lock_guard<std::mutex> lock(registry_mutex);
+	for (const auto& buffer : registry) {
+		buffer->head.store(0, std::memory_order_release);
+	}
+}
+
+bool netkit::trace_enabled() {
+#ifdef NETKIT_WITH_TRACING
+	return true;
+#else
+	return false;
+#endif
+}
@@ -0,0 +1,115 @@
+#include <stdexcept> // std::runtime_error
+#include <utility> // std::swap
+
+#if defined(__unix__) || defined(__APPLE__)
+#define NETKIT_HAS_MMAP
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "netkit/utils/mapped_file.h"
+
+netkit::mapped_file::mapped_file()
+	: m_path()
+	, m_data(nullptr)
+	, m_size(0)
+	, m_fd(-1)
+	, m_reopened(false) {}
+
+netkit::mapped_file::mapped_file(const std::string& path, size_t size)
+	: m_path(path)
+	, m_data(nullptr)
+	, m_size(size)
+	, m_fd(-1)
+	, m_reopened(false) {
+#ifdef NETKIT_HAS_MMAP
+	m_fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+	if (m_fd < 0) {
+		throw std::runtime_error("unable to open the file to map: " + path);
+	}
+
+	struct stat file_stat {};
+	if (::fstat(m_fd, &file_stat) != 0) {
+		::close(m_fd);
+		throw std::runtime_error("unable to stat the file to map: " + path);
+	}
+	m_reopened = static_cast<size_t>(file_stat.st_size) == size && size > 0;
+
+	if (!m_reopened && ::ftruncate(m_fd, static_cast<off_t>(size)) != 0) {
+		::close(m_fd);
+		throw std::runtime_error("unable to resize the file to map: " + path);
+	}
+
+	if (size > 0) {
+		void* addr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+		if (addr == MAP_FAILED) {
+			::close(m_fd);
+			throw std::runtime_error("unable to map the file: " + path);
+		}
+		m_data = addr;
+	}
+#else
+	throw std::runtime_error("memory-mapped files are not supported on this platform.");
+#endif
+}
+
+netkit::mapped_file::mapped_file(mapped_file&& other) noexcept
+	: m_path(std::move(other.m_path))
+	, m_data(other.m_data)
+	, m_size(other.m_size)
+	, m_fd(other.m_fd)
+	, m_reopened(other.m_reopened) {
+	other.m_data = nullptr;
+	other.m_size = 0;
+	other.m_fd = -1;
+}
+
+netkit::mapped_file& netkit::mapped_file::operator=(mapped_file&& other) noexcept {
+	std::swap(m_path, other.m_path);
+	std::swap(m_data, other.m_data);
+	std::swap(m_size, other.m_size);
+	std::swap(m_fd, other.m_fd);
+	std::swap(m_reopened, other.m_reopened);
+
+	return *this; // the previous mapping is released by other.
+}
+
+netkit::mapped_file::~mapped_file() {
+	helper_unmap();
+}
+
+void netkit::mapped_file::flush() const {
+#ifdef NETKIT_HAS_MMAP
+	if (m_data != nullptr && ::msync(m_data, m_size, MS_SYNC) != 0) {
+		throw std::runtime_error("unable to flush the mapped file: " + m_path);
+	}
+#endif
+}
+
+int64_t netkit::mapped_file::size_on_disk(const std::string& path) {
+#ifdef NETKIT_HAS_MMAP
+	struct stat file_stat {};
+	if (::stat(path.c_str(), &file_stat) != 0) {
+		return -1;
+	}
+	return file_stat.st_size;
+#else
+	(void) path;
+	return -1;
+#endif
+}
+
+void netkit::mapped_file::helper_unmap() {
+#ifdef NETKIT_HAS_MMAP
+	if (m_data != nullptr) {
+		::munmap(m_data, m_size);
+	}
+	if (m_fd >= 0) {
+		::close(m_fd);
+	}
+#endif
+	m_data = nullptr;
+	m_fd = -1;
+}
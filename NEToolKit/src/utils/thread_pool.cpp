@@ -0,0 +1,84 @@
+#include <utility> // std::move
+#include <algorithm> // std::max
+
+#include "netkit/utils/thread_pool.h"
+
+netkit::thread_pool::thread_pool(size_t number_of_threads)
+	: m_workers()
+	, m_tasks()
+	, m_mutex()
+	, m_task_available()
+	, m_all_done()
+	, m_unfinished_tasks(0)
+	, m_stop(false)
+	, m_first_error() {
+	if (number_of_threads == 0) {
+		number_of_threads = std::max(1u, std::thread::hardware_concurrency());
+	}
+
+	m_workers.reserve(number_of_threads);
+	for (size_t i = 0; i < number_of_threads; ++i) {
+		m_workers.emplace_back(&thread_pool::helper_worker_loop, this);
+	}
+}
+
+netkit::thread_pool::~thread_pool() {
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stop = true;
+	}
+	m_task_available.notify_all();
+	for (std::thread& worker : m_workers) {
+		worker.join();
+	}
+}
+
+void netkit::thread_pool::submit(std::function<void()> task) {
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_tasks.push_back(std::move(task));
+		++m_unfinished_tasks;
+	}
+	m_task_available.notify_one();
+}
+
+void netkit::thread_pool::wait() {
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_all_done.wait(lock, [this]() { return m_unfinished_tasks == 0; });
+
+	if (m_first_error) {
+		std::exception_ptr error = m_first_error;
+		m_first_error = nullptr;
+		std::rethrow_exception(error);
+	}
+}
+
+void netkit::thread_pool::helper_worker_loop() {
+	while (true) {
+		std::function<void()> task;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_task_available.wait(lock, [this]() { return m_stop || !m_tasks.empty(); });
+			if (m_tasks.empty()) {
+				return; // stopping, and nothing left to do
+			}
+			task = std::move(m_tasks.front());
+			m_tasks.pop_front();
+		}
+
+		std::exception_ptr error;
+		try {
+			task();
+		} catch (...) {
+			error = std::current_exception();
+		}
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (error && !m_first_error) {
+			m_first_error = error;
+		}
+		if (--m_unfinished_tasks == 0) {
+			m_all_done.notify_all();
+		}
+	}
+}
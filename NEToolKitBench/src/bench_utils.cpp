@@ -0,0 +1,134 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <algorithm> // std::sort
+#include <cmath> // std::ceil
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+#include "bench_utils.h"
+
+namespace {
+	volatile double sink = 0;
+}
+
+bench_report::bench_report(const std::string& filename)
+	: m_ser(filename, ",") {
+	m_ser.append("suite");
+	m_ser.append("case");
+	m_ser.append("backend");
+	m_ser.append("size");
+	m_ser.append("dimension");
+	m_ser.append("k");
+	m_ser.append("iterations");
+	m_ser.append("seconds");
+	m_ser.append("ns_per_iteration");
+	m_ser.append("iterations_per_second");
+	m_ser.append("extra");
+	for (size_t c = 0; c < netkit::NUMBER_OF_COUNTERS; ++c) {
+		m_ser.append(netkit::counter_name(static_cast<netkit::counter_t>(c)));
+	}
+	m_ser.append("allocations_per_iteration");
+	m_ser.append("bytes_per_iteration");
+	m_ser.new_line();
+}
+
+void bench_report::add(const std::string& suite, const std::string& name, const std::string& backend,
+					   size_t size, size_t dimension, size_t k, size_t iterations, double seconds, double extra,
+					   const netkit::counter_values& counters, const netkit::allocation_counts& allocations) {
+	double ns_per_iteration = iterations > 0 ? seconds * 1e9 / static_cast<double>(iterations) : 0;
+	double iterations_per_second = seconds > 0 ? static_cast<double>(iterations) / seconds : 0;
+	auto per_iteration = [iterations](uint64_t value) {
+		return iterations > 0 ? static_cast<double>(value) / static_cast<double>(iterations) : 0;
+	};
+
+	m_ser.append(suite);
+	m_ser.append(name);
+	m_ser.append(backend);
+	m_ser.append(size);
+	m_ser.append(dimension);
+	m_ser.append(k);
+	m_ser.append(iterations);
+	m_ser.append(seconds);
+	m_ser.append(ns_per_iteration);
+	m_ser.append(iterations_per_second);
+	m_ser.append(extra);
+	for (uint64_t value : counters.values) {
+		m_ser.append(per_iteration(value));
+	}
+	m_ser.append(per_iteration(allocations.allocations));
+	m_ser.append(per_iteration(allocations.bytes));
+	m_ser.new_line();
+
+	std::cout << suite << "/" << name << "/" << backend
+			  << " size = " << size << ", dim = " << dimension << ", k = " << k
+			  << ": " << ns_per_iteration << " ns/it (" << iterations_per_second << " it/s)";
+	if (extra > 0) { // the extras are counts, ratios or quantiles: 0 means there is none.
+		std::cout << ", extra = " << extra;
+	}
+	std::cout << std::endl;
+}
+
+void bench_report::close() {
+	m_ser.close();
+}
+
+double quantile(std::vector<double> values, double q) {
+	if (values.empty()) {
+		return 0;
+	}
+
+	std::sort(values.begin(), values.end());
+	size_t rank = static_cast<size_t>(std::ceil(q * static_cast<double>(values.size())));
+	return values[rank == 0 ? 0 : rank - 1];
+}
+
+const netkit::perf_counters& bench_counters() {
+	static netkit::perf_counters counters;
+	return counters;
+}
+
+bool reset_peak_rss() {
+#ifdef __linux__
+	// "5" resets the VmHWM of the process (Linux 4.0+).
+	std::ofstream clear_refs("/proc/self/clear_refs");
+	clear_refs << "5";
+	clear_refs.flush();
+	return static_cast<bool>(clear_refs);
+#else
+	return false;
+#endif
+}
+
+size_t peak_rss_kb() {
+#ifdef __linux__
+	// VmHWM follows the resets, unlike ru_maxrss.
+	std::ifstream status("/proc/self/status");
+	std::string line;
+	while (std::getline(status, line)) {
+		if (line.compare(0, 6, "VmHWM:") == 0) {
+			size_t kb = 0;
+			std::istringstream(line.substr(6)) >> kb;
+			return kb;
+		}
+	}
+#endif
+#if defined(__unix__) || defined(__APPLE__)
+	rusage usage{};
+	getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+	return static_cast<size_t>(usage.ru_maxrss) / 1024; // bytes on macOS
+#else
+	return static_cast<size_t>(usage.ru_maxrss);
+#endif
+#else
+	return 0;
+#endif
+}
+
+void do_not_optimize(double value) {
+	sink = sink + value;
+}
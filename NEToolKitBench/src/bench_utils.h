@@ -0,0 +1,91 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <chrono>
+
+#include <netkit/csv/serializer.h>
+#include <netkit/profiling/perf_counters.h>
+#include <netkit/profiling/allocation_tracker.h>
+
+struct bench_options {
+	std::string output = "netkit_bench.csv"; // machine-readable results (CSV)
+	std::string suite = "all"; // run only this suite
+	bool quick = false; // smaller grids, for a smoke run
+	double min_seconds = 0.2; // minimum measuring time of a single case
+	size_t max_memory_mb = 1024; // cases which would need more memory than that are skipped
+	std::string trace; // Chrome trace output (needs a library built with NETKIT_WITH_TRACING)
+};
+
+// one line per measured case. The columns are the same for all the suites so the results of several
+// library versions can be concatenated and compared with any CSV tool:
+// suite, case, backend, size, dimension, k, iterations, seconds, ns_per_iteration, iterations_per_second, extra,
+// then the hardware counters per iteration (cycles, instructions, cache_misses, branch_misses), 0 if unavailable,
+// and the heap allocations per iteration (allocations_per_iteration, bytes_per_iteration).
+class bench_report {
+  public:
+	explicit bench_report(const std::string& filename);
+
+	void add(const std::string& suite, const std::string& name, const std::string& backend,
+			 size_t size, size_t dimension, size_t k, size_t iterations, double seconds, double extra = 0,
+			 const netkit::counter_values& counters = {}, const netkit::allocation_counts& allocations = {});
+
+	void close();
+
+  private:
+	netkit::serializer m_ser;
+};
+
+class stopwatch {
+  public:
+	stopwatch() : m_start(std::chrono::steady_clock::now()) {}
+
+	void restart() { m_start = std::chrono::steady_clock::now(); }
+	double elapsed_seconds() const {
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count();
+	}
+
+  private:
+	std::chrono::steady_clock::time_point m_start;
+};
+
+struct measure {
+	size_t iterations;
+	double seconds;
+	netkit::counter_values counters; // totals over all the iterations
+	netkit::allocation_counts allocations; // totals over all the iterations (the benchmark installs the hooks)
+};
+
+// the hardware counters of the benchmarking thread (see netkit::perf_counters).
+const netkit::perf_counters& bench_counters();
+
+// calls func (which performs one iteration) until at least min_seconds have elapsed.
+template<typename func_t>
+measure run_for(double min_seconds, func_t func) {
+	measure m{0, 0.0, {}, {}};
+	const netkit::perf_counters& counters = bench_counters();
+	netkit::counter_values start = counters.read();
+	netkit::allocation_counts start_allocations = netkit::thread_allocation_counts();
+	stopwatch sw;
+	do {
+		func();
+		++m.iterations;
+		m.seconds = sw.elapsed_seconds();
+	} while (m.seconds < min_seconds);
+	m.counters = counters.read() - start;
+	m.allocations = netkit::thread_allocation_counts() - start_allocations;
+	return m;
+}
+
+// nearest-rank quantile (q in [0, 1]) of the values, 0 if there is none.
+double quantile(std::vector<double> values, double q);
+
+// resets the peak resident set size to the current one, so that peak_rss_kb only covers what runs next.
+// Returns false where it isn't possible (Linux only): peak_rss_kb is then the peak of the whole process.
+bool reset_peak_rss();
+
+// peak resident set size since the last reset_peak_rss (or the start of the process), in kB (0 if unknown).
+size_t peak_rss_kb();
+
+// prevents the compiler from optimizing away a computed value.
+void do_not_optimize(double value);
@@ -0,0 +1,133 @@
+#include <array>
+#include <memory>
+#include <vector>
+#include <iostream>
+
+#include <netkit/neat/neat.h>
+#include <netkit/profiling/trace.h>
+
+#include "e2e_bench.h"
+#include "workloads.h"
+
+namespace {
+	struct run_result {
+		size_t generations;
+		size_t evaluations;
+		double seconds;
+		bool solved;
+		size_t epochs;
+		std::array<netkit::allocation_counts, netkit::NUMBER_OF_PHASES> allocations; // summed over the epochs
+	};
+
+	run_result evolve(const workload& task, size_t population_size, size_t max_generations, unsigned int seed) {
+		netkit::parameters params;
+		params.number_of_inputs = task.number_of_inputs();
+		params.number_of_outputs = task.number_of_outputs();
+		params.initial_population_size = population_size;
+		params.record_epoch_timings = true;
+		params.record_allocations = true;
+
+		netkit::neat neat(params);
+		neat.rand_engine.seed(seed); // the only source of randomness of the algorithm.
+		neat.init();
+
+		run_result result{0, 0, 0.0, false, 0, {}};
+		stopwatch sw;
+		while (result.generations < max_generations && !result.solved) {
+			++result.generations;
+
+			std::vector<netkit::organism> organisms = neat.generate_and_get_all_organisms();
+			for (netkit::organism& org : organisms) {
+				NETKIT_TRACE_SCOPE("evaluate");
+				evaluation_result eval = task.evaluate(org.get_network());
+				org.set_fitness(eval.fitness);
+				++result.evaluations;
+				result.solved = result.solved || eval.solved;
+			}
+
+			if (!result.solved) {
+				neat.update_best_genome_ever();
+				neat.epoch();
+				++result.epochs;
+				for (size_t phase = 0; phase < netkit::NUMBER_OF_PHASES; ++phase) {
+					result.allocations[phase] += neat.get_last_epoch_timings().allocations[phase];
+				}
+			}
+		}
+		result.seconds = sw.elapsed_seconds();
+
+		return result;
+	}
+
+	void bench_workload(bench_report& report, const workload& task, size_t population_size, size_t max_generations,
+						unsigned int number_of_runs) {
+		const unsigned int base_seed = 42;
+		const bool own_peak_rss = reset_peak_rss();
+
+		size_t total_generations = 0;
+		size_t total_evaluations = 0;
+		double total_seconds = 0;
+		size_t total_epochs = 0;
+		std::array<netkit::allocation_counts, netkit::NUMBER_OF_PHASES> total_allocations{};
+		std::vector<double> seconds_to_solution;
+		std::vector<double> generations_to_solution;
+
+		for (unsigned int run = 0; run < number_of_runs; ++run) {
+			run_result result = evolve(task, population_size, max_generations, base_seed + run);
+			total_generations += result.generations;
+			total_evaluations += result.evaluations;
+			total_seconds += result.seconds;
+			total_epochs += result.epochs;
+			for (size_t phase = 0; phase < netkit::NUMBER_OF_PHASES; ++phase) {
+				total_allocations[phase] += result.allocations[phase];
+			}
+			if (result.solved) {
+				seconds_to_solution.push_back(result.seconds);
+				generations_to_solution.push_back(static_cast<double>(result.generations));
+			}
+		}
+
+		auto add = [&](const std::string& metric, size_t iterations, double seconds, double extra,
+					   const netkit::allocation_counts& allocations = {}) {
+			report.add("e2e", task.name(), metric, population_size, task.number_of_inputs(), number_of_runs,
+					   iterations, seconds, extra, {}, allocations);
+		};
+
+		add("generations", total_generations, total_seconds, 0);
+		add("evaluations", total_evaluations, total_seconds, 0);
+		add("success_rate", seconds_to_solution.size(), 0,
+			static_cast<double>(seconds_to_solution.size()) / number_of_runs);
+		// time to solution of the solved runs: seconds, and the number of generations as extra.
+		for (double q : {0.0, 0.5, 0.9, 1.0}) {
+			add("time_to_solution_p" + std::to_string(static_cast<int>(q * 100)), 1,
+				quantile(seconds_to_solution, q), quantile(generations_to_solution, q));
+		}
+		// heap allocations of each phase of the epochs (one iteration per epoch).
+		for (size_t phase = 0; phase < netkit::NUMBER_OF_PHASES; ++phase) {
+			add(std::string("allocations_") + netkit::phase_name(static_cast<netkit::phase_t>(phase)), total_epochs,
+				0, 0, total_allocations[phase]);
+		}
+		// the peak of this workload in kB, or of the whole process so far where it can't be reset.
+		add(own_peak_rss ? "peak_rss_kb" : "process_peak_rss_kb", 0, 0, static_cast<double>(peak_rss_kb()));
+	}
+}
+
+void run_e2e_bench(const bench_options& options, bench_report& report) {
+	const size_t population_size = 150;
+	const size_t max_generations = options.quick ? 20 : 200;
+	const unsigned int number_of_runs = options.quick ? 2 : 10;
+	const unsigned int max_steps = options.quick ? 1000 : 10000;
+
+	std::vector<std::unique_ptr<workload>> workloads;
+	workloads.push_back(std::make_unique<single_pole_balancing>(true, max_steps, 10, 42));
+	workloads.push_back(std::make_unique<single_pole_balancing>(false, max_steps, 10, 42));
+	workloads.push_back(std::make_unique<double_pole_balancing>(true, max_steps));
+	workloads.push_back(std::make_unique<double_pole_balancing>(false, max_steps));
+	workloads.push_back(std::make_unique<sequence_recall>(1, 8, 10, 42));
+	workloads.push_back(std::make_unique<high_dimensional_regression>(32, 100, 42));
+
+	for (const auto& task : workloads) {
+		std::cout << "e2e: " << task->name() << "..." << std::endl;
+		bench_workload(report, *task, population_size, max_generations, number_of_runs);
+	}
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+#include "bench_utils.h"
+
+// whole evolutions on tasks bigger than xor: pole balancing (single and double, with and without velocities),
+// a recurrent sequence task and a high dimensional regression. Deterministic for a given seed.
+// In the report, "size" is the population size, "dimension" the number of inputs and "k" the number of runs.
+void run_e2e_bench(const bench_options& options, bench_report& report);
@@ -0,0 +1,73 @@
+#include <iostream>
+#include <string>
+#include <stdexcept>
+
+#include <netkit/profiling/trace.h>
+#include <netkit/profiling/allocation_hooks.h> // counts the allocations of the benchmarks (only included here)
+
+#include "bench_utils.h"
+#include "novelty_bench.h"
+#include "micro_bench.h"
+#include "e2e_bench.h"
+
+namespace {
+	void print_usage() {
+		std::cout << "usage: NEToolKitBench [--suite all|novelty|micro|e2e] [--output file.csv] [--quick]\n"
+				  << "                      [--min-seconds s] [--max-memory-mb mb] [--trace file.json]" << std::endl;
+	}
+
+	bool selected(const bench_options& options, const std::string& suite) {
+		return options.suite == "all" || options.suite == suite;
+	}
+}
+
+int main(int argc, char** argv) {
+	bench_options options;
+
+	for (int i = 1; i < argc; ++i) {
+		std::string arg = argv[i];
+		bool has_value = i + 1 < argc;
+		if (arg == "--quick") {
+			options.quick = true;
+		} else if (arg == "--suite" && has_value) {
+			options.suite = argv[++i];
+		} else if (arg == "--output" && has_value) {
+			options.output = argv[++i];
+		} else if (arg == "--min-seconds" && has_value) {
+			options.min_seconds = std::stod(argv[++i]);
+		} else if (arg == "--trace" && has_value) {
+			options.trace = argv[++i];
+		} else if (arg == "--max-memory-mb" && has_value) {
+			options.max_memory_mb = std::stoul(argv[++i]);
+		} else {
+			print_usage();
+			return arg == "--help" ? 0 : 1;
+		}
+	}
+
+	std::cout << "    NEToolKit benchmarks" << std::endl;
+	std::cout << "~~------==========------~~" << std::endl;
+
+	bench_report report(options.output);
+	if (selected(options, "novelty")) {
+		run_novelty_bench(options, report);
+	}
+	if (selected(options, "micro")) {
+		run_micro_bench(options, report);
+	}
+	if (selected(options, "e2e")) {
+		run_e2e_bench(options, report);
+	}
+	report.close();
+
+	if (!options.trace.empty()) {
+		if (!netkit::trace_enabled()) {
+			std::cout << "no trace written: the library has been built without NETKIT_WITH_TRACING." << std::endl;
+		} else if (netkit::write_chrome_trace(options.trace)) {
+			std::cout << "trace written to " << options.trace << std::endl;
+		}
+	}
+
+	std::cout << "results written to " << options.output << std::endl;
+	return 0;
+}
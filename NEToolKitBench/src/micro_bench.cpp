@@ -0,0 +1,437 @@
+#include <vector>
+#include <random>
+#include <string>
+#include <algorithm> // std::max_element
+
+#include <netkit/neat/neat.h>
+#include <netkit/neat/substrate.h>
+#include <netkit/network/network.h>
+#include <netkit/network/activation_functions.h>
+#include <netkit/network/ctrnn.h>
+#include <netkit/utils/thread_pool.h>
+
+#include "micro_bench.h"
+
+namespace {
+	const unsigned int NUMBER_OF_INPUTS = 8;
+	const unsigned int NUMBER_OF_OUTPUTS = 2;
+
+	// gives access to the protected parts of the algorithm.
+	class bench_neat : public netkit::neat {
+	  public:
+		using netkit::neat::neat;
+
+		// speciate the whole population again, as epoch does.
+		void speciate_again() {
+			for (netkit::species& spec : m_all_species) {
+				spec.init_for_next_gen(spec.get_representant());
+			}
+			helper_speciate_all_population();
+		}
+	};
+
+	netkit::parameters bench_parameters() {
+		netkit::parameters params;
+		params.number_of_inputs = NUMBER_OF_INPUTS;
+		params.number_of_outputs = NUMBER_OF_OUTPUTS;
+		return params;
+	}
+
+	// the default initial genome (see base_neat::init), grown with new neurons and links up to number_of_genes.
+	netkit::genome grown_genome(netkit::neat& neat, size_t number_of_genes) {
+		netkit::genome geno(&neat);
+		const netkit::neuron_id_t starting_idx_outputs = 1 + neat.params.number_of_inputs;
+		for (netkit::neuron_id_t j = 0; j <= neat.params.number_of_inputs; j++) { // bias and inputs
+			for (netkit::neuron_id_t i = 0; i < neat.params.number_of_outputs; i++) {
+				geno.add_gene({neat.innov_pool.next_innovation(), j, starting_idx_outputs + i});
+			}
+		}
+
+		size_t remaining_tries = 100 * number_of_genes;
+		while (geno.get_genes().size() < number_of_genes && remaining_tries--) {
+			if (geno.get_genes().size() % 3 == 0) {
+				geno.mutate_add_neuron();
+			} else {
+				geno.mutate_add_link();
+			}
+		}
+
+		return geno;
+	}
+
+	void rate_randomly(netkit::neat& neat, std::mt19937& rng) {
+		std::uniform_real_distribution<double> fitness(0.1, 10.0);
+		for (netkit::genome_id_t i = 0; i < neat.pop()->size(); ++i) {
+			neat.pop()->get_genome(i).set_fitness(fitness(rng));
+		}
+	}
+
+	std::vector<netkit::neuron_value_t> random_inputs(std::mt19937& rng) {
+		std::uniform_real_distribution<netkit::neuron_value_t> value(-1.0, 1.0);
+		std::vector<netkit::neuron_value_t> inputs(NUMBER_OF_INPUTS);
+		for (auto& v : inputs) {
+			v = value(rng);
+		}
+		return inputs;
+	}
+
+	// the benchmarks that only depend on the genome size.
+	void bench_genome(const bench_options& options, bench_report& report, size_t number_of_genes) {
+		auto add = [&](const std::string& name, const measure& m, double extra = 0) {
+			report.add("micro", name, "-", 1, number_of_genes, 0, m.iterations, m.seconds, extra,
+					   m.counters, m.allocations);
+		};
+
+		bench_neat neat(bench_parameters());
+		neat.rand_engine.seed(42);
+		std::mt19937 rng(42);
+
+		netkit::genome geno = grown_genome(neat, number_of_genes);
+		netkit::genome other = geno;
+		for (int i = 0; i < 5; ++i) {
+			other.mutate_weights();
+			other.mutate_add_link();
+		}
+		geno.set_fitness(1.0);
+		other.set_fitness(2.0);
+
+		// network
+		add("generate_network", run_for(options.min_seconds, [&]() {
+			do_not_optimize(static_cast<double>(geno.generate_network().number_of_links()));
+		}));
+
+		netkit::network net = geno.generate_network();
+		std::vector<netkit::neuron_value_t> inputs = random_inputs(rng);
+		add("network::activate", run_for(options.min_seconds, [&]() {
+			net.load_inputs(inputs);
+			net.activate();
+		}), static_cast<double>(net.number_of_neurons()));
+		add("network::activate_until_relaxation", run_for(options.min_seconds, [&]() {
+			net.flush();
+			net.load_inputs(inputs);
+			net.activate_until_relaxation();
+		}), static_cast<double>(net.number_of_neurons()));
+
+		// genome
+		add("genome::distance_to", run_for(options.min_seconds, [&]() {
+			do_not_optimize(geno.distance_to(other));
+		}));
+		add("genome::random_crossover", run_for(options.min_seconds, [&]() {
+			do_not_optimize(static_cast<double>(geno.random_crossover(other).get_genes().size()));
+		}));
+
+		// innovation pool: look up the genes of the genome. Done before the mutations, which keep filling the pool.
+		const std::vector<netkit::gene>& genes = geno.get_genes();
+		size_t i = 0;
+		add("innovation_pool::find_gene(from, to)", run_for(options.min_seconds, [&]() {
+			const netkit::gene& g = genes[i++ % genes.size()];
+			do_not_optimize(neat.innov_pool.find_gene(g.from, g.to).has_value() ? 1.0 : 0.0);
+		}));
+		add("innovation_pool::find_gene(innov_num)", run_for(options.min_seconds, [&]() {
+			do_not_optimize(neat.innov_pool.find_gene(genes[i++ % genes.size()].innov_num).has_value() ? 1.0 : 0.0);
+		}));
+		add("innovation_pool::find_innovation(type, from, to)", run_for(options.min_seconds, [&]() {
+			const netkit::gene& g = genes[i++ % genes.size()];
+			do_not_optimize(neat.innov_pool.find_innovation(netkit::NEW_LINK, g.from, g.to).has_value() ? 1.0 : 0.0);
+		}));
+		add("innovation_pool::find_innovation(innov_num)", run_for(options.min_seconds, [&]() {
+			do_not_optimize(neat.innov_pool.find_innovation(genes[i++ % genes.size()].innov_num).has_value() ? 1.0 : 0.0);
+		}));
+
+		// every mutation is applied to a fresh copy so the genome size stays the same: "genome::copy" is the baseline.
+		add("genome::copy", run_for(options.min_seconds, [&]() {
+			netkit::genome copy(geno);
+			do_not_optimize(static_cast<double>(copy.get_genes().size()));
+		}));
+
+		using mutation_fn = bool (netkit::genome::*)();
+		const std::vector<std::pair<std::string, mutation_fn>> mutations = {
+			{"genome::mutate_add_link", &netkit::genome::mutate_add_link},
+			{"genome::mutate_add_neuron", &netkit::genome::mutate_add_neuron},
+			{"genome::mutate_add_cascade", &netkit::genome::mutate_add_cascade},
+			{"genome::mutate_remove_neuron", &netkit::genome::mutate_remove_neuron},
+			{"genome::mutate_reenable_gene", &netkit::genome::mutate_reenable_gene},
+			{"genome::mutate_toggle_enable", &netkit::genome::mutate_toggle_enable},
+			{"genome::mutate_weights", &netkit::genome::mutate_weights},
+			{"genome::mutate_reset_weights", &netkit::genome::mutate_reset_weights},
+			{"genome::mutate_remove_gene", &netkit::genome::mutate_remove_gene},
+		};
+		for (const auto& mutation : mutations) {
+			add(mutation.first, run_for(options.min_seconds, [&]() {
+				netkit::genome copy(geno);
+				do_not_optimize((copy.*mutation.second)() ? 1.0 : 0.0);
+			}));
+		}
+	}
+
+	// the benchmarks that depend on the population size too.
+	void bench_population(const bench_options& options, bench_report& report,
+						  size_t population_size, size_t number_of_genes) {
+		auto add = [&](const std::string& name, const measure& m, double extra = 0) {
+			report.add("micro", name, "-", population_size, number_of_genes, 0, m.iterations, m.seconds, extra,
+					   m.counters, m.allocations);
+		};
+
+		netkit::parameters params = bench_parameters();
+		params.initial_population_size = population_size;
+		bench_neat neat(params);
+		neat.rand_engine.seed(42);
+		std::mt19937 rng(42);
+
+		neat.init(grown_genome(neat, number_of_genes));
+		rate_randomly(neat, rng);
+
+		add("base_neat::helper_speciate_all_population", run_for(options.min_seconds, [&]() {
+			neat.speciate_again();
+		}), static_cast<double>(neat.get_all_species().size()));
+
+		for (netkit::species& spec : neat.get_all_species()) {
+			spec.sort_by_fitness();
+			spec.update_stats();
+		}
+		netkit::species& biggest = *std::max_element(
+			neat.get_all_species().begin(), neat.get_all_species().end(),
+		[](const netkit::species & s1, const netkit::species & s2) {
+			return s1.number_of_members() < s2.number_of_members();
+		});
+		add("species::select_one_genitor", run_for(options.min_seconds, [&]() {
+			do_not_optimize(static_cast<double>(biggest.select_one_genitor()));
+		}), static_cast<double>(biggest.number_of_members()));
+
+		// one iteration is a full generation: rating (random fitness) and epoch.
+		add("neat::epoch", run_for(options.min_seconds, [&]() {
+			rate_randomly(neat, rng);
+			neat.epoch();
+		}), static_cast<double>(neat.get_all_species().size()));
+	}
+
+	// one iteration applies an activation function to a layer of count sums (see compiled_network groups).
+	void bench_activations(const bench_options& options, bench_report& report, size_t count) {
+		std::mt19937 rng(42);
+		std::uniform_real_distribution<netkit::neuron_value_t> value(-4.0, 4.0);
+		std::vector<netkit::neuron_value_t> sums(count);
+		for (auto& v : sums) {
+			v = value(rng);
+		}
+		std::vector<netkit::neuron_value_t> values(count);
+
+		for (size_t f = 0; f < netkit::NUMBER_OF_ACTIVATION_FUNCTIONS; ++f) {
+			auto func = static_cast<netkit::activation_function_t>(f);
+			for (bool lookup_table : {false, true}) {
+				measure m = run_for(options.min_seconds, [&]() {
+					netkit::apply_activation(func, lookup_table, sums.data(), values.data(), count);
+					do_not_optimize(values[0]);
+				});
+				report.add("micro", std::string("apply_activation(") + netkit::activation_function_name(func) + ")",
+						   lookup_table ? "lookup_table" : "exact", count, 0, 0, m.iterations, m.seconds, 0,
+						   m.counters, m.allocations);
+			}
+		}
+	}
+
+	// one integration step of the CTRNN of a grown genome, then of number_of_agents controllers of its topology
+	// (perturbed weights, time constants and biases), one by one or as a batch.
+	void bench_ctrnn(const bench_options& options, bench_report& report, size_t number_of_genes,
+					 size_t number_of_agents) {
+		netkit::neat neat(bench_parameters());
+		neat.rand_engine.seed(42);
+		netkit::genome geno = grown_genome(neat, number_of_genes);
+		const std::vector<netkit::neuron_value_t> inputs(NUMBER_OF_INPUTS, 0.5);
+
+		for (netkit::ctrnn_integration_t integration : {netkit::EULER_INTEGRATION, netkit::RK2_INTEGRATION}) {
+			neat.params.ctrnn_integration = integration;
+			netkit::ctrnn net = geno.generate_ctrnn();
+			net.load_inputs(inputs);
+			measure m = run_for(options.min_seconds, [&]() {
+				net.step();
+				do_not_optimize(net.get_state(netkit::network::BIAS_ID + NUMBER_OF_INPUTS + 1));
+			});
+			report.add("micro", "ctrnn::step", integration == netkit::EULER_INTEGRATION ? "euler" : "rk2",
+					   net.number_of_neurons(), number_of_genes, 0, m.iterations, m.seconds, 0, m.counters,
+					   m.allocations);
+		}
+
+		neat.params.ctrnn_integration = netkit::EULER_INTEGRATION;
+		std::vector<netkit::ctrnn> controllers;
+		for (size_t a = 0; a < number_of_agents; ++a) {
+			netkit::genome controller(geno);
+			controller.mutate_weights();
+			controller.mutate_neuron_params();
+			controllers.push_back(controller.generate_ctrnn());
+			controllers.back().load_inputs(inputs);
+		}
+		netkit::ctrnn_batch batch(controllers.front(), number_of_agents);
+		std::vector<netkit::neuron_value_t> batch_inputs;
+		for (size_t a = 0; a < number_of_agents; ++a) {
+			batch.set_controller(a, controllers[a]);
+			batch_inputs.insert(batch_inputs.end(), inputs.begin(), inputs.end());
+		}
+		batch.load_inputs(batch_inputs.data());
+		std::vector<netkit::neuron_value_t> outputs(number_of_agents * NUMBER_OF_OUTPUTS);
+
+		auto add = [&](const std::string& backend, const measure& m) {
+			report.add("micro", "ctrnn agents step", backend, number_of_agents, number_of_genes, 0, m.iterations,
+					   m.seconds, 0, m.counters, m.allocations);
+		};
+		add("one_by_one", run_for(options.min_seconds, [&]() {
+			for (netkit::ctrnn& controller : controllers) {
+				controller.step();
+			}
+			do_not_optimize(controllers.back().get_state(netkit::network::BIAS_ID + NUMBER_OF_INPUTS + 1));
+		}));
+		add("batch", run_for(options.min_seconds, [&]() {
+			batch.step();
+			batch.get_outputs(outputs.data());
+			do_not_optimize(outputs.back());
+		}));
+	}
+
+	// a single query on a large feed-forward network (layers of width neurons, a third of the links of two
+	// consecutive layers): relaxation passes, one pass level by level, and the levels split over a pool.
+	void bench_large_network(const bench_options& options, bench_report& report, size_t width) {
+		std::mt19937 rng(42);
+		std::uniform_real_distribution<netkit::neuron_value_t> weight(-1.0, 1.0);
+		const std::vector<size_t> layers = {NUMBER_OF_INPUTS, width, width, width, NUMBER_OF_OUTPUTS};
+
+		std::vector<netkit::link> links;
+		std::vector<netkit::neuron_id_t> input_ids;
+		std::vector<netkit::neuron_id_t> output_ids;
+		netkit::neuron_id_t first = netkit::network::BIAS_ID + 1;
+		for (size_t l = 0; l + 1 < layers.size(); ++l) {
+			netkit::neuron_id_t next_first = first + static_cast<netkit::neuron_id_t>(layers[l]);
+			for (size_t t = 0; t < layers[l + 1]; ++t) {
+				for (size_t s = 0; s < layers[l]; ++s) {
+					if (l == 0 || rng() % 3 == 0) {
+						links.emplace_back(first + s, next_first + t, weight(rng));
+					}
+				}
+			}
+			first = next_first;
+		}
+		for (netkit::neuron_id_t i = 0; i < NUMBER_OF_INPUTS; ++i) {
+			input_ids.push_back(netkit::network::BIAS_ID + 1 + i);
+		}
+		for (netkit::neuron_id_t i = 0; i < NUMBER_OF_OUTPUTS; ++i) {
+			output_ids.push_back(first + i);
+		}
+		std::vector<netkit::activation_func_t> activations(first + NUMBER_OF_OUTPUTS, &netkit::steepened_sigmoid);
+		netkit::compiled_network net(links, std::move(activations), std::move(input_ids), std::move(output_ids));
+
+		const std::vector<netkit::neuron_value_t> inputs(NUMBER_OF_INPUTS, 0.5);
+		std::vector<netkit::neuron_value_t> values;
+		netkit::thread_pool pool;
+		auto add = [&](const std::string& backend, const measure& m) {
+			report.add("micro", "compiled_network::evaluate", backend, net.number_of_links(), width, pool.size(),
+					   m.iterations, m.seconds, 0, m.counters, m.allocations);
+		};
+		add("relaxation", run_for(options.min_seconds, [&]() {
+			do_not_optimize(net.evaluate(net.get_weights().data(), inputs, values)[0]);
+		}));
+		add("levels", run_for(options.min_seconds, [&]() {
+			net.flush(values);
+			net.load_inputs(values, inputs);
+			net.activate_feed_forward(net.get_weights().data(), values);
+			do_not_optimize(values[net.get_output_ids()[0]]);
+		}));
+		add("levels_thread_pool", run_for(options.min_seconds, [&]() {
+			do_not_optimize(net.evaluate(net.get_weights().data(), inputs, values, pool)[0]);
+		}));
+	}
+
+	// HyperNEAT substrate construction: three layers of side x side neurons, fully connected layer to layer
+	// (2 * side^4 candidate links), painted by a grown CPPN.
+	void bench_substrate(const bench_options& options, bench_report& report, size_t side, size_t number_of_genes) {
+		netkit::parameters params = netkit::substrate::cppn_parameters(netkit::parameters());
+		netkit::neat neat(params);
+		neat.rand_engine.seed(42);
+		netkit::genome cppn = grown_genome(neat, number_of_genes);
+
+		std::vector<std::vector<netkit::substrate_point>> layers(3);
+		for (std::vector<netkit::substrate_point>& layer : layers) {
+			for (size_t x = 0; x < side; ++x) {
+				for (size_t y = 0; y < side; ++y) {
+					layer.push_back({2.0 * static_cast<double>(x) / static_cast<double>(side - 1) - 1,
+									2.0 * static_cast<double>(y) / static_cast<double>(side - 1) - 1});
+				}
+			}
+		}
+		netkit::substrate sub(layers);
+
+		auto add = [&](const std::string& backend, const measure& m) {
+			report.add("micro", "substrate::build", backend, side * side, number_of_genes, 0, m.iterations, m.seconds,
+					   static_cast<double>(sub.number_of_candidate_links()), m.counters, m.allocations);
+		};
+		add("batched", run_for(options.min_seconds, [&]() {
+			do_not_optimize(static_cast<double>(sub.build(cppn, params).number_of_links()));
+		}));
+		add("unbatched", run_for(options.min_seconds, [&]() {
+			do_not_optimize(static_cast<double>(sub.build_unbatched(cppn, params).number_of_links()));
+		}));
+
+		// a synchronous activation of the substrate network, by the calling thread or split over a pool.
+		netkit::compiled_network net = sub.build(cppn, params);
+		std::vector<netkit::neuron_value_t> previous;
+		std::vector<netkit::neuron_value_t> next;
+		net.flush(previous);
+		net.load_inputs(previous, std::vector<netkit::neuron_value_t>(net.number_of_inputs(), 0.5));
+		netkit::thread_pool pool;
+		auto add_activation = [&](const std::string& backend, const measure& m) {
+			report.add("micro", "compiled_network::activate_synchronous", backend, side * side, number_of_genes,
+					   pool.size(), m.iterations, m.seconds, static_cast<double>(net.number_of_links()), m.counters,
+					   m.allocations);
+		};
+		add_activation("calling_thread", run_for(options.min_seconds, [&]() {
+			net.activate_synchronous(net.get_weights().data(), previous, next);
+			do_not_optimize(next.back());
+		}));
+		add_activation("thread_pool", run_for(options.min_seconds, [&]() {
+			net.activate_synchronous(net.get_weights().data(), previous, next, pool);
+			do_not_optimize(next.back());
+		}));
+	}
+}
+
+void run_micro_bench(const bench_options& options, bench_report& report) {
+	std::vector<size_t> genome_sizes = {20, 100, 500};
+	std::vector<size_t> population_sizes = {150, 1000, 5000};
+	if (options.quick) {
+		genome_sizes = {20, 100};
+		population_sizes = {150};
+	}
+
+	for (size_t number_of_genes : genome_sizes) {
+		bench_genome(options, report, number_of_genes);
+	}
+
+	for (size_t population_size : population_sizes) {
+		for (size_t number_of_genes : genome_sizes) {
+			bench_population(options, report, population_size, number_of_genes);
+		}
+	}
+
+	bench_activations(options, report, 1024);
+
+	std::vector<size_t> agents_counts = {64, 1024};
+	if (options.quick) {
+		agents_counts = {64};
+	}
+	for (size_t number_of_agents : agents_counts) {
+		bench_ctrnn(options, report, 100, number_of_agents);
+	}
+
+	std::vector<size_t> network_widths = {100, 300, 1000};
+	if (options.quick) {
+		network_widths = {100, 300};
+	}
+	for (size_t width : network_widths) {
+		bench_large_network(options, report, width);
+	}
+
+	std::vector<size_t> substrate_sides = {8, 16, 32};
+	if (options.quick) {
+		substrate_sides = {8, 16};
+	}
+	for (size_t side : substrate_sides) {
+		bench_substrate(options, report, side, 20);
+	}
+}
@@ -0,0 +1,7 @@
+#pragma once
+
+#include "bench_utils.h"
+
+// microbenchmarks of the hot paths, parameterized by the population size and the genome size.
+// In the report, "size" is the population size and "dimension" the number of genes of the genomes.
+void run_micro_bench(const bench_options& options, bench_report& report);
@@ -0,0 +1,145 @@
+#include <vector>
+#include <random>
+#include <limits>
+#include <filesystem>
+#include <iostream>
+
+#include <netkit/neat/novelbank.h>
+#include <netkit/neat/novelpos.h>
+
+#include "novelty_bench.h"
+
+namespace {
+	const double NEVER_ARCHIVE = std::numeric_limits<double>::infinity(); // keep the archive size constant
+	const size_t NUMBER_OF_QUERIES = 256;
+	const size_t POPULATION_SIZE = 100;
+	const size_t REPLACED_PER_GENERATION = 10; // the rest of the population is kept (elites)
+
+	template<size_t dim>
+	netkit::novelpos<dim> random_pos(std::mt19937& rng) {
+		std::uniform_real_distribution<double> value(0.0, 1.0);
+		netkit::novelpos<dim> pos;
+		for (double& v : pos.values) {
+			v = value(rng);
+		}
+		return pos;
+	}
+
+	// the evaluation of genomes which aren't registered: a full scan of the archive each time.
+	template<typename bank_t, size_t dim>
+	measure bench_queries(bank_t& bank, const std::vector<netkit::novelpos<dim>>& queries, double min_seconds) {
+		size_t i = 0;
+		return run_for(min_seconds, [&]() {
+			netkit::novelgenome<netkit::novelpos<dim>> ng(0, queries[i++ % queries.size()]);
+			do_not_optimize(bank.evaluate(ng));
+		});
+	}
+
+	// one iteration is a generation: a few members are replaced, then the whole population is evaluated.
+	// Members whose neighbourhood didn't change are evaluated without scanning the archive.
+	template<typename bank_t, size_t dim>
+	measure bench_generations(bank_t& bank, std::mt19937& rng, double min_seconds) {
+		for (netkit::genome_id_t id = 0; id < POPULATION_SIZE; ++id) {
+			bank.pop_register({id, random_pos<dim>(rng)});
+		}
+
+		std::uniform_int_distribution<netkit::genome_id_t> member(0, POPULATION_SIZE - 1);
+		auto generation = [&]() {
+			for (size_t i = 0; i < REPLACED_PER_GENERATION; ++i) {
+				bank.pop_register({member(rng), random_pos<dim>(rng)});
+			}
+			for (netkit::genome_id_t id = 0; id < POPULATION_SIZE; ++id) {
+				do_not_optimize(bank.evaluate(netkit::novelgenome<netkit::novelpos<dim>>(id)));
+			}
+		};
+
+		generation(); // warm up: every neighbourhood is computed once.
+		measure m = run_for(min_seconds, generation);
+		m.iterations *= POPULATION_SIZE; // report per evaluation
+		return m;
+	}
+
+	template<size_t dim>
+	void bench_dimension(const bench_options& options, bench_report& report,
+						 const std::vector<size_t>& sizes, const std::vector<unsigned int>& ks) {
+		using pos_t = netkit::novelpos<dim>;
+		std::mt19937 rng(42);
+
+		std::vector<pos_t> queries;
+		for (size_t i = 0; i < NUMBER_OF_QUERIES; ++i) {
+			queries.push_back(random_pos<dim>(rng));
+		}
+
+		for (size_t size : sizes) {
+			// the in-memory archive is copied for each bank.
+			size_t needed_mb = 2 * size * sizeof(pos_t) / (1024 * 1024);
+			if (needed_mb > options.max_memory_mb) {
+				std::cout << "novelty: skipping size = " << size << ", dim = " << dim
+						  << " (needs " << needed_mb << " MB, see --max-memory-mb)" << std::endl;
+				continue;
+			}
+
+			netkit::ring_buffer<pos_t> archive(size);
+			for (size_t i = 0; i < size; ++i) {
+				archive.push_back(random_pos<dim>(rng));
+			}
+
+			std::string path = (std::filesystem::temp_directory_path() / "netkit_bench_archive").string();
+			std::filesystem::remove(path);
+			std::filesystem::remove(path + ".idx");
+			{
+				netkit::mapped_ring_buffer<pos_t> mapped_archive(path, size);
+				for (const pos_t& pos : archive) {
+					mapped_archive.push_back(pos);
+				}
+			}
+
+			for (unsigned int k : ks) {
+				measure m;
+				{
+					netkit::novelbank<pos_t> bank(archive, NEVER_ARCHIVE, k);
+					m = bench_queries(bank, queries, options.min_seconds);
+				}
+				report.add("novelty", "evaluate", "naive", size, dim, k, m.iterations, m.seconds, 0,
+						   m.counters, m.allocations);
+
+				{
+					netkit::novelbank<pos_t> bank(archive, NEVER_ARCHIVE, k);
+					m = bench_generations<netkit::novelbank<pos_t>, dim>(bank, rng, options.min_seconds);
+				}
+				report.add("novelty", "evaluate", "incremental", size, dim, k, m.iterations, m.seconds, 0,
+						   m.counters, m.allocations);
+
+				{
+					netkit::mapped_novelbank<pos_t> bank(netkit::mapped_ring_buffer<pos_t>(path, size), NEVER_ARCHIVE, k);
+					m = bench_queries(bank, queries, options.min_seconds);
+				}
+				report.add("novelty", "evaluate", "mapped", size, dim, k, m.iterations, m.seconds, 0,
+						   m.counters, m.allocations);
+			}
+
+			std::filesystem::remove(path);
+			std::filesystem::remove(path + ".idx");
+		}
+	}
+}
+
+void run_novelty_bench(const bench_options& options, bench_report& report) {
+	std::vector<size_t> sizes = {1000, 10000, 100000, 1000000};
+	std::vector<unsigned int> ks = {1, 15, 50};
+	if (options.quick) {
+		sizes = {1000, 10000};
+		ks = {15};
+	}
+
+	// by increasing dimension, the quick run only keeps 2 and 32.
+	bench_dimension<2>(options, report, sizes, ks);
+	if (!options.quick) {
+		bench_dimension<8>(options, report, sizes, ks);
+	}
+	bench_dimension<32>(options, report, sizes, ks);
+	if (!options.quick) {
+		bench_dimension<128>(options, report, sizes, ks);
+		bench_dimension<256>(options, report, sizes, ks);
+	}
+}
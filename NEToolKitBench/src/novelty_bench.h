@@ -0,0 +1,6 @@
+#pragma once
+
+#include "bench_utils.h"
+
+// novelbank::evaluate throughput against the archive size, the descriptor dimension, k and the archive backend.
+void run_novelty_bench(const bench_options& options, bench_report& report);
@@ -0,0 +1,244 @@
+#include <cmath>
+#include <array>
+
+#include "workloads.h"
+
+namespace {
+	const double PI = 3.14159265358979323846;
+	const double GRAVITY = 9.8;
+	const double CART_MASS = 1.0;
+	const double TRACK_LIMIT = 2.4;
+	const double FORCE_MAG = 10.0;
+
+	double output_of(netkit::network& net, std::vector<netkit::neuron_value_t> inputs) {
+		net.load_inputs(std::move(inputs));
+		net.activate_until_relaxation();
+		return net.get_outputs()[0];
+	}
+}
+
+// === single pole ===
+
+single_pole_balancing::single_pole_balancing(bool with_velocities, unsigned int max_steps,
+											 unsigned int number_of_starts, unsigned int seed)
+	: m_with_velocities(with_velocities)
+	, m_max_steps(max_steps)
+	, m_starts() {
+	m_starts.push_back({0, 0, 0.07, 0});
+	std::mt19937 rng(seed);
+	std::uniform_real_distribution<double> unit(-1.0, 1.0);
+	for (unsigned int i = 1; i < number_of_starts; ++i) {
+		m_starts.push_back({2.0 * unit(rng), unit(rng), 0.15 * unit(rng), unit(rng)});
+	}
+}
+
+std::string single_pole_balancing::name() const {
+	return m_with_velocities ? "single_pole" : "single_pole_no_velocities";
+}
+
+evaluation_result single_pole_balancing::evaluate(netkit::network& net) const {
+	const double pole_mass = 0.1;
+	const double total_mass = CART_MASS + pole_mass;
+	const double half_length = 0.5;
+	const double pole_mass_length = pole_mass * half_length;
+	const double tau = 0.02;
+	const double max_angle = 12 * PI / 180;
+
+	unsigned int total_steps = 0;
+	bool all_balanced = true;
+	for (const std::vector<double>& start : m_starts) {
+		double x = start[0], x_dot = start[1], theta = start[2], theta_dot = start[3];
+		net.flush();
+
+		unsigned int steps = 0;
+		while (steps < m_max_steps) {
+			double out = m_with_velocities
+						 ? output_of(net, {x / TRACK_LIMIT, x_dot / 1.5, theta / max_angle, theta_dot / 2.0})
+						 : output_of(net, {x / TRACK_LIMIT, theta / max_angle});
+			double force = out > 0.5 ? FORCE_MAG : -FORCE_MAG;
+
+			double cos_theta = std::cos(theta);
+			double sin_theta = std::sin(theta);
+			double temp = (force + pole_mass_length * theta_dot * theta_dot * sin_theta) / total_mass;
+			double theta_acc = (GRAVITY * sin_theta - cos_theta * temp)
+							   / (half_length * (4.0 / 3.0 - pole_mass * cos_theta * cos_theta / total_mass));
+			double x_acc = temp - pole_mass_length * theta_acc * cos_theta / total_mass;
+
+			x += tau * x_dot;
+			x_dot += tau * x_acc;
+			theta += tau * theta_dot;
+			theta_dot += tau * theta_acc;
+
+			if (std::abs(x) > TRACK_LIMIT || std::abs(theta) > max_angle) {
+				break;
+			}
+			++steps;
+		}
+
+		total_steps += steps;
+		all_balanced = all_balanced && steps == m_max_steps;
+	}
+
+	return {1.0 + static_cast<double>(total_steps) / static_cast<double>(m_starts.size()), all_balanced};
+}
+
+// === double pole ===
+
+double_pole_balancing::double_pole_balancing(bool with_velocities, unsigned int max_steps)
+	: m_with_velocities(with_velocities)
+	, m_max_steps(max_steps) {}
+
+std::string double_pole_balancing::name() const {
+	return m_with_velocities ? "double_pole" : "double_pole_no_velocities";
+}
+
+evaluation_result double_pole_balancing::evaluate(netkit::network& net) const {
+	using state_t = std::array<double, 6>; // x, x_dot, theta1, theta1_dot, theta2, theta2_dot
+	const double pole_masses[2] = {0.1, 0.01};
+	const double half_lengths[2] = {0.5, 0.05};
+	const double pole_friction = 0.000002;
+	const double tau = 0.01;
+	const double max_angle = 36 * PI / 180;
+
+	auto derivative = [&](const state_t& s, double force) -> state_t {
+		double forces = force;
+		double masses = CART_MASS;
+		double temps[2], coss[2], gsins[2];
+		for (int i = 0; i < 2; ++i) {
+			double theta = s[2 + 2 * i];
+			double theta_dot = s[3 + 2 * i];
+			double ml = pole_masses[i] * half_lengths[i];
+			coss[i] = std::cos(theta);
+			gsins[i] = GRAVITY * std::sin(theta);
+			temps[i] = pole_friction * theta_dot / ml;
+			forces += ml * theta_dot * theta_dot * std::sin(theta) + 0.75 * pole_masses[i] * coss[i] * (temps[i] + gsins[i]);
+			masses += pole_masses[i] * (1 - 0.75 * coss[i] * coss[i]);
+		}
+
+		double x_acc = forces / masses;
+		state_t d;
+		d[0] = s[1];
+		d[1] = x_acc;
+		for (int i = 0; i < 2; ++i) {
+			d[2 + 2 * i] = s[3 + 2 * i];
+			d[3 + 2 * i] = -0.75 * (x_acc * coss[i] + gsins[i] + temps[i]) / half_lengths[i];
+		}
+		return d;
+	};
+
+	auto add_scaled = [](const state_t& s, const state_t& d, double h) {
+		state_t r;
+		for (size_t i = 0; i < r.size(); ++i) {
+			r[i] = s[i] + h * d[i];
+		}
+		return r;
+	};
+
+	state_t s = {0, 0, 4 * PI / 180, 0, 0, 0};
+	net.flush();
+
+	unsigned int steps = 0;
+	while (steps < m_max_steps) {
+		double out = m_with_velocities
+					 ? output_of(net, {s[0] / 4.8, s[1] / 2.0, s[2] / 0.52, s[3] / 2.0, s[4] / 0.52, s[5] / 2.0})
+					 : output_of(net, {s[0] / 4.8, s[2] / 0.52, s[4] / 0.52});
+		double force = (out - 0.5) * 2 * FORCE_MAG;
+
+		// runge-kutta 4
+		state_t k1 = derivative(s, force);
+		state_t k2 = derivative(add_scaled(s, k1, tau / 2), force);
+		state_t k3 = derivative(add_scaled(s, k2, tau / 2), force);
+		state_t k4 = derivative(add_scaled(s, k3, tau), force);
+		for (size_t i = 0; i < s.size(); ++i) {
+			s[i] += tau / 6 * (k1[i] + 2 * k2[i] + 2 * k3[i] + k4[i]);
+		}
+
+		if (std::abs(s[0]) > TRACK_LIMIT || std::abs(s[2]) > max_angle || std::abs(s[4]) > max_angle) {
+			break;
+		}
+		++steps;
+	}
+
+	return {1.0 + steps, steps == m_max_steps};
+}
+
+// === sequence recall ===
+
+sequence_recall::sequence_recall(unsigned int delay, unsigned int number_of_sequences,
+								 unsigned int sequence_length, unsigned int seed)
+	: m_delay(delay)
+	, m_sequences() {
+	std::mt19937 rng(seed);
+	std::bernoulli_distribution bit(0.5);
+	for (unsigned int i = 0; i < number_of_sequences; ++i) {
+		std::vector<int> sequence(sequence_length);
+		for (int& b : sequence) {
+			b = bit(rng) ? 1 : 0;
+		}
+		m_sequences.push_back(std::move(sequence));
+	}
+}
+
+evaluation_result sequence_recall::evaluate(netkit::network& net) const {
+	double summed_error = 0;
+	unsigned int number_of_outputs = 0;
+	bool all_correct = true;
+
+	for (const std::vector<int>& sequence : m_sequences) {
+		net.flush();
+		for (size_t t = 0; t < sequence.size(); ++t) {
+			double out = output_of(net, {static_cast<netkit::neuron_value_t>(sequence[t])});
+			if (t < m_delay) {
+				continue; // nothing to recall yet
+			}
+
+			int expected = sequence[t - m_delay];
+			summed_error += std::abs(out - expected);
+			all_correct = all_correct && ((out > 0.5) == (expected == 1));
+			++number_of_outputs;
+		}
+	}
+
+	double score = number_of_outputs - summed_error;
+	return {score * score, all_correct};
+}
+
+// === high dimensional regression ===
+
+high_dimensional_regression::high_dimensional_regression(unsigned int dimension, unsigned int number_of_samples,
+														 unsigned int seed)
+	: m_dimension(dimension)
+	, m_samples()
+	, m_targets() {
+	std::mt19937 rng(seed);
+	std::uniform_real_distribution<netkit::neuron_value_t> input(-1.0, 1.0);
+	std::normal_distribution<double> coef(0.0, 1.0 / std::sqrt(static_cast<double>(dimension)));
+
+	std::vector<double> coefs(dimension);
+	for (double& c : coefs) {
+		c = coef(rng);
+	}
+
+	for (unsigned int i = 0; i < number_of_samples; ++i) {
+		std::vector<netkit::neuron_value_t> sample(dimension);
+		double sum = 0;
+		for (unsigned int d = 0; d < dimension; ++d) {
+			sample[d] = input(rng);
+			sum += coefs[d] * sample[d];
+		}
+		m_samples.push_back(std::move(sample));
+		m_targets.push_back(1 / (1 + std::exp(-4.9 * sum))); // reachable by a steepened sigmoid output
+	}
+}
+
+evaluation_result high_dimensional_regression::evaluate(netkit::network& net) const {
+	double mse = 0;
+	for (size_t i = 0; i < m_samples.size(); ++i) {
+		net.flush();
+		double error = output_of(net, m_samples[i]) - m_targets[i];
+		mse += error * error;
+	}
+	mse /= static_cast<double>(m_samples.size());
+
+	return {1 / (0.01 + mse), mse < 0.005};
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <random>
+
+#include <netkit/network/network.h>
+
+// end-to-end evolution tasks. Everything they need (physics, data sets) lives here, not in the library.
+struct evaluation_result {
+	double fitness; // always positive
+	bool solved;
+};
+
+class workload {
+  public:
+	virtual ~workload() = default;
+
+	virtual std::string name() const = 0;
+	virtual unsigned int number_of_inputs() const = 0;
+	virtual unsigned int number_of_outputs() const = 0;
+	virtual evaluation_result evaluate(netkit::network& net) const = 0;
+};
+
+// the classic cart and pole (Barto et al.), bang-bang control.
+// Without velocities, only the positions are given and the network needs recurrent connections.
+// The pole must be balanced from several random initial states (the first one is the classic start), which a
+// network that merely pushes back and forth in the classic start doesn't solve.
+class single_pole_balancing : public workload {
+  public:
+	single_pole_balancing(bool with_velocities, unsigned int max_steps, unsigned int number_of_starts, unsigned int seed);
+
+	std::string name() const override;
+	unsigned int number_of_inputs() const override { return m_with_velocities ? 4 : 2; }
+	unsigned int number_of_outputs() const override { return 1; }
+	evaluation_result evaluate(netkit::network& net) const override;
+
+  private:
+	bool m_with_velocities;
+	unsigned int m_max_steps;
+	std::vector<std::vector<double>> m_starts; // x, x_dot, theta, theta_dot
+};
+
+// two poles of different lengths on the same cart (Wieland's equations, RK4 integration), continuous control.
+class double_pole_balancing : public workload {
+  public:
+	double_pole_balancing(bool with_velocities, unsigned int max_steps);
+
+	std::string name() const override;
+	unsigned int number_of_inputs() const override { return m_with_velocities ? 6 : 3; }
+	unsigned int number_of_outputs() const override { return 1; }
+	evaluation_result evaluate(netkit::network& net) const override;
+
+  private:
+	bool m_with_velocities;
+	unsigned int m_max_steps;
+};
+
+// a bit is given at each step and the network must output the bit given "delay" steps earlier.
+// The network is never flushed within a sequence: it needs recurrent connections to remember.
+class sequence_recall : public workload {
+  public:
+	sequence_recall(unsigned int delay, unsigned int number_of_sequences, unsigned int sequence_length, unsigned int seed);
+
+	std::string name() const override { return "sequence_recall"; }
+	unsigned int number_of_inputs() const override { return 1; }
+	unsigned int number_of_outputs() const override { return 1; }
+	evaluation_result evaluate(netkit::network& net) const override;
+
+  private:
+	unsigned int m_delay;
+	std::vector<std::vector<int>> m_sequences;
+};
+
+// fit a random sigmoid of a linear combination of many inputs from a fixed set of samples.
+class high_dimensional_regression : public workload {
+  public:
+	high_dimensional_regression(unsigned int dimension, unsigned int number_of_samples, unsigned int seed);
+
+	std::string name() const override { return "regression_" + std::to_string(m_dimension) + "d"; }
+	unsigned int number_of_inputs() const override { return m_dimension; }
+	unsigned int number_of_outputs() const override { return 1; }
+	evaluation_result evaluate(netkit::network& net) const override;
+
+  private:
+	unsigned int m_dimension;
+	std::vector<std::vector<netkit::neuron_value_t>> m_samples;
+	std::vector<netkit::neuron_value_t> m_targets;
+};
@@ -0,0 +1,144 @@
+#include <algorithm> // std::max
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <netkit/neat/neat.h>
+#include <netkit/network/network.h>
+
+#include "complexity_tests.h"
+#include "utils.h"
+
+namespace {
+	// the cost of the genome, computed from its phenotype rather than by genome::get_complexity_cost.
+	double expected_cost(const netkit::genome& geno, const netkit::parameters& params,
+						 const std::map<netkit::genome_id_t, double>& evaluation_times, netkit::genome_id_t id) {
+		double enabled_links = 0;
+		for (const netkit::gene& g : geno.get_genes()) {
+			enabled_links += g.enabled ? 1 : 0;
+		}
+		netkit::network net = geno.generate_network();
+		switch (params.complexity_cost) {
+		case netkit::LINKS_COST:
+			return enabled_links;
+		case netkit::NEURONS_COST: // outputs and hidden neurons
+			return static_cast<double>(net.number_of_neurons() - params.number_of_inputs - 1);
+		case netkit::MACS_COST:
+			return enabled_links * net.max_depth();
+		case netkit::EVALUATION_TIME_COST: {
+			auto time = evaluation_times.find(id);
+			return time == evaluation_times.end() ? 0 : time->second; // unknown: 0
+		}
+		default:
+			return 0;
+		}
+	}
+
+	void run_penalty_tests(netkit::complexity_cost_t cost_model, const std::string& name) {
+		netkit::parameters params;
+		params.number_of_inputs = 2;
+		params.number_of_outputs = 1;
+		params.initial_population_size = 40;
+		params.mutation_probs[netkit::ADD_NEURON] = 0.2;
+		params.mutation_probs[netkit::ADD_LINK] = 0.3;
+		params.complexity_cost = cost_model;
+		params.complexity_penalty = 0.4;
+		netkit::neat neat(params);
+		neat.rand_engine.seed(3);
+		neat.init();
+
+		// some generations to grow different topologies.
+		std::mt19937 rand_engine(5);
+		std::uniform_real_distribution<double> value(0, 6);
+		for (int generation = 0; generation < 5; ++generation) {
+			for (netkit::organism& org : neat.generate_and_get_all_organisms()) {
+				org.set_fitness(value(rand_engine));
+			}
+			neat.epoch();
+		}
+
+		// the evaluation time of half the genomes only, the other ones being unknown.
+		std::map<netkit::genome_id_t, double> evaluation_times;
+		for (netkit::organism& org : neat.generate_and_get_all_organisms()) {
+			org.set_fitness(value(rand_engine));
+			if (org.get_genome_id() % 2 == 0) {
+				evaluation_times[org.get_genome_id()] = value(rand_engine);
+				org.set_evaluation_time(evaluation_times[org.get_genome_id()]);
+			}
+		}
+
+		bool penalized = true;
+		bool lowered = false;
+		bool floored = false;
+		for (const netkit::species& spec : neat.get_all_species()) {
+			spec.share_fitness();
+			const auto size = static_cast<double>(spec.number_of_members());
+			for (netkit::genome_id_t g : spec.get_members_ids()) {
+				const netkit::genome& geno = neat.pop()->get_genome(g);
+				const double cost = expected_cost(geno, params, evaluation_times, g);
+				const double penalized_fitness = geno.get_fitness() - params.complexity_penalty * cost;
+				penalized &= std::abs(geno.get_adjusted_fitness() - std::max(0., penalized_fitness) / size) < 1e-12;
+				lowered |= cost > 0 && penalized_fitness > 0;
+				floored |= penalized_fitness < 0;
+			}
+		}
+		check(penalized && lowered && floored,
+			  name + ": the adjusted fitness is lowered by complexity_penalty * cost, floored at 0");
+	}
+
+	void run_tie_break_tests() {
+		std::cout << "\nThe complexity tie-break ranks the cheaper genomes first among the same fitness:" << std::endl;
+
+		netkit::parameters params;
+		params.number_of_inputs = 2;
+		params.number_of_outputs = 1;
+		params.initial_population_size = 50;
+		params.complexity_tie_break = true;
+		netkit::neat neat(params);
+		neat.rand_engine.seed(3);
+		neat.init();
+
+		// a few distinct fitnesses only, so that the ties are common.
+		std::mt19937 rand_engine(5);
+		std::uniform_int_distribution<int> value(0, 3);
+		bool ordered = true;
+		bool ties_seen = false;
+		for (int generation = 0; generation < 10; ++generation) {
+			while (neat.has_more_organisms_to_process()) {
+				netkit::organism org = neat.generate_and_get_next_organism();
+				org.set_fitness(value(rand_engine));
+			}
+
+			for (netkit::species& spec : neat.get_all_species()) {
+				spec.sort_by_fitness();
+				const std::vector<netkit::genome_id_t>& members = spec.get_members_ids();
+				for (size_t i = 1; i < members.size(); ++i) {
+					const netkit::genome& previous = neat.pop()->get_genome(members[i - 1]);
+					const netkit::genome& current = neat.pop()->get_genome(members[i]);
+					ordered &= !current.is_fitter_than(previous);
+					ties_seen |= !(previous.get_fitness() > current.get_fitness()); // sorted, so the same fitness
+				}
+			}
+
+			neat.update_best_genome_ever();
+			neat.epoch();
+		}
+		check(ordered, "the members are sorted by fitness then cost");
+		check(ties_seen, "the run had ties to break");
+	}
+}
+
+void run_complexity_tests() {
+	std::cout << "Starting complexity tests..." << std::endl;
+
+	std::cout << "\nThe complexity penalty of every cost model:" << std::endl;
+	run_penalty_tests(netkit::LINKS_COST, "links");
+	run_penalty_tests(netkit::NEURONS_COST, "neurons");
+	run_penalty_tests(netkit::MACS_COST, "multiply-accumulates");
+	run_penalty_tests(netkit::EVALUATION_TIME_COST, "evaluation time");
+
+	run_tie_break_tests();
+}
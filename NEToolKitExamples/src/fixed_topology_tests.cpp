@@ -0,0 +1,154 @@
+#include <algorithm> // std::equal
+#include <cmath>
+#include <functional> // std::equal_to
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <netkit/neat/fixed_topology_population.h>
+#include <netkit/neat/genome.h>
+#include <netkit/neat/neat.h>
+#include <netkit/network/network.h>
+
+#include "fixed_topology_tests.h"
+#include "utils.h"
+
+namespace {
+	const std::vector<std::vector<netkit::neuron_value_t>> xor_inputs = {{0, 0}, {0, 1}, {1, 0}, {1, 1}};
+	const std::vector<netkit::neuron_value_t> xor_outputs = {0, 1, 1, 0};
+
+	// 4 minus the squared error on the xor table.
+	double xor_fitness(const netkit::compiled_network& topology, const netkit::neuron_value_t* weights) {
+		std::vector<netkit::neuron_value_t> values;
+		double fitness = 4;
+		for (size_t run = 0; run < xor_inputs.size(); ++run) {
+			double error = topology.evaluate(weights, xor_inputs[run], values)[0] - xor_outputs[run];
+			fitness -= error * error;
+		}
+		return fitness;
+	}
+
+	// bias 0, inputs 1 and 2, output 3 and two hidden neurons 4 and 5. The bias link of the output is frozen.
+	netkit::genome xor_champion(netkit::neat& neat, double frozen_weight) {
+		netkit::genome champion(&neat);
+		const std::vector<netkit::gene> genes = {
+			{neat.innov_pool.next_innovation(), 1, 4, 0.1}, {neat.innov_pool.next_innovation(), 2, 4, 0.1},
+			{neat.innov_pool.next_innovation(), 0, 4, 0.1}, {neat.innov_pool.next_innovation(), 1, 5, 0.1},
+			{neat.innov_pool.next_innovation(), 2, 5, 0.1}, {neat.innov_pool.next_innovation(), 0, 5, 0.1},
+			{neat.innov_pool.next_innovation(), 4, 3, 0.1}, {neat.innov_pool.next_innovation(), 5, 3, 0.1},
+			{neat.innov_pool.next_innovation(), 0, 3, frozen_weight}
+		};
+		for (netkit::gene g : genes) {
+			g.frozen = g.from == netkit::genome::BIAS_ID && g.to == 3;
+			champion.add_gene(g);
+		}
+		return champion;
+	}
+
+	// evolves the weights of the champion on xor, rows rated by the compiled topology.
+	struct search_outcome {
+		double champion_fitness;
+		double best_fitness;
+		bool frozen_kept; // the frozen weight of every row of every generation is the champion one
+		bool genomes_match; // every row rebuilt as a genome gives the outputs of the compiled topology
+		bool best_genome_matches; // the best genome ever has the best fitness ever
+	};
+
+	search_outcome run_search(const netkit::genome& champion, netkit::parameters params, netkit::weight_search_t search,
+							  double frozen_weight) {
+		params.weight_search = search;
+		netkit::fixed_topology_population pop(champion, params, 7);
+		const netkit::compiled_network& topology = pop.get_topology();
+
+		// the compiled index of the frozen link: the last enabled gene.
+		std::vector<netkit::neuron_value_t> frozen_mask(champion.get_genes().size(), 0);
+		frozen_mask.back() = 1;
+		frozen_mask = topology.to_compiled_order(frozen_mask);
+		size_t frozen_index = 0;
+		while (frozen_mask[frozen_index] < 0.5) {
+			++frozen_index;
+		}
+
+		search_outcome outcome = {xor_fitness(topology, topology.get_weights().data()), 0, true, true, true};
+		for (int generation = 0; generation < 100; ++generation) {
+			for (size_t i = 0; i < pop.size(); ++i) {
+				pop.set_fitness(i, xor_fitness(topology, pop.get_weights(i)));
+				outcome.frozen_kept &= std::equal_to<netkit::neuron_value_t>()(pop.get_weights(i)[frozen_index],
+																			  frozen_weight);
+			}
+
+			if (generation % 20 == 0) {
+				std::vector<netkit::neuron_value_t> values;
+				for (size_t i = 0; i < pop.size(); ++i) {
+					netkit::network net = pop.get_genome(i).generate_network();
+					for (const std::vector<netkit::neuron_value_t>& inputs : xor_inputs) {
+						net.flush();
+						net.load_inputs(inputs);
+						net.activate_until_relaxation();
+						double expected = topology.evaluate(pop.get_weights(i), inputs, values)[0];
+						outcome.genomes_match &= std::abs(net.get_outputs()[0] - expected) < 1e-12;
+					}
+				}
+			}
+
+			pop.epoch();
+		}
+
+		outcome.best_fitness = pop.get_best_fitness_ever();
+		netkit::genome best = pop.get_best_genome_ever();
+		netkit::compiled_network best_net(best.generate_network());
+		outcome.best_genome_matches = std::abs(xor_fitness(best_net, best_net.get_weights().data())
+											   - outcome.best_fitness) < 1e-12
+									  && std::abs(best.get_fitness() - outcome.best_fitness) < 1e-12;
+		return outcome;
+	}
+
+	void check_search(const search_outcome& outcome, const std::string& name) {
+		std::cout << "  " << name << ": " << outcome.champion_fitness << " -> " << outcome.best_fitness << std::endl;
+		check(outcome.frozen_kept, name + ": the frozen weight never moves");
+		check(outcome.genomes_match, name + ": get_genome(i) gives the outputs of the compiled topology");
+		check(outcome.best_genome_matches, name + ": the best genome ever has the best weights ever");
+		check(outcome.best_fitness > outcome.champion_fitness + 0.5, name + ": the fitness on xor improves");
+	}
+}
+
+void run_fixed_topology_tests() {
+	std::cout << "Starting fixed topology tests..." << std::endl;
+
+	netkit::parameters params;
+	params.number_of_inputs = 2;
+	params.number_of_outputs = 1;
+	params.initial_population_size = 40;
+	netkit::neat neat(params);
+	const double frozen_weight = -0.25;
+	netkit::genome champion = xor_champion(neat, frozen_weight);
+
+	std::cout << "\nGenetic search:" << std::endl;
+	check_search(run_search(champion, params, netkit::GENETIC_WEIGHT_SEARCH, frozen_weight), "genetic");
+
+	std::cout << "\nEvolution strategy:" << std::endl;
+	check_search(run_search(champion, params, netkit::EVOLUTION_STRATEGY, frozen_weight), "evolution strategy");
+
+	std::cout << "\nSeeding:" << std::endl;
+	for (netkit::weight_search_t search : {netkit::GENETIC_WEIGHT_SEARCH, netkit::EVOLUTION_STRATEGY}) {
+		params.weight_search = search;
+		netkit::fixed_topology_population first(champion, params, 3);
+		netkit::fixed_topology_population second(champion, params, 3);
+		bool same = true;
+		for (int generation = 0; generation < 5; ++generation) {
+			for (size_t i = 0; i < first.size(); ++i) {
+				first.set_fitness(i, xor_fitness(first.get_topology(), first.get_weights(i)));
+				second.set_fitness(i, xor_fitness(second.get_topology(), second.get_weights(i)));
+			}
+			first.epoch();
+			second.epoch();
+			same &= first.get_best_weights_ever() == second.get_best_weights_ever();
+			for (size_t i = 0; i < first.size(); ++i) {
+				same &= std::equal(first.get_weights(i), first.get_weights(i) + first.number_of_weights(),
+								   second.get_weights(i), std::equal_to<netkit::neuron_value_t>());
+			}
+		}
+		check(same, search == netkit::GENETIC_WEIGHT_SEARCH ? "the same seed replays the genetic search"
+															 : "the same seed replays the evolution strategy");
+	}
+}
@@ -0,0 +1,3 @@
+#pragma once
+
+void run_fixed_topology_tests();
@@ -1,4 +1,5 @@
 #include <iostream>
+#include <limits>
 
 #include "utils.h"
 #include "xor_experiment.h"
@@ -6,6 +7,13 @@
 #include "random_evolution.h"
 #include "serialization_tests.h"
 #include "novelty_tests.h"
+#include "ring_buffer_tests.h"
+#include "multiobjective_tests.h"
+#include "metrics_exporter_tests.h"
+#include "parallel_tests.h"
+#include "numerics_tests.h"
+#include "fixed_topology_tests.h"
+#include "complexity_tests.h"
 
 enum choice_t {
 	EXIT,
@@ -24,6 +32,13 @@ enum choice_t {
 	GEN_MUT_CROSS,
 	SERDES,
 	NOVELTY_TESTS,
+	RING_BUFFER_TESTS,
+	MULTIOBJECTIVE_TESTS,
+	METRICS_EXPORTER_TESTS,
+	PARALLEL_TESTS,
+	NUMERICS_TESTS,
+	FIXED_TOPOLOGY_TESTS,
+	COMPLEXITY_TESTS,
 
 	COFFEE
 };
@@ -52,6 +67,13 @@ int main() {
 		std::cout << "\t" << GEN_MUT_CROSS << ". run various mutations and crossover on simple genomes?" << std::endl;
 		std::cout << "\t" << SERDES << ". run the serialization tests?" << std::endl;
 		std::cout << "\t" << NOVELTY_TESTS << ". run the novelty tests?" << std::endl;
+		std::cout << "\t" << RING_BUFFER_TESTS << ". run the ring buffer tests?" << std::endl;
+		std::cout << "\t" << MULTIOBJECTIVE_TESTS << ". run the multi-objective tests?" << std::endl;
+		std::cout << "\t" << METRICS_EXPORTER_TESTS << ". run the metrics exporter tests?" << std::endl;
+		std::cout << "\t" << PARALLEL_TESTS << ". run the parallel tests?" << std::endl;
+		std::cout << "\t" << NUMERICS_TESTS << ". run the numerics tests?" << std::endl;
+		std::cout << "\t" << FIXED_TOPOLOGY_TESTS << ". run the fixed topology tests?" << std::endl;
+		std::cout << "\t" << COMPLEXITY_TESTS << ". run the complexity tests?" << std::endl;
 
 		std::cout << "\t" << COFFEE << ". get a cup of coffee?" << std::endl;
 
@@ -109,6 +131,27 @@ int main() {
 		case NOVELTY_TESTS:
 			run_novelty_tests();
 			break;
+		case RING_BUFFER_TESTS:
+			run_ring_buffer_tests();
+			break;
+		case MULTIOBJECTIVE_TESTS:
+			run_multiobjective_tests();
+			break;
+		case METRICS_EXPORTER_TESTS:
+			run_metrics_exporter_tests();
+			break;
+		case PARALLEL_TESTS:
+			run_parallel_tests();
+			break;
+		case NUMERICS_TESTS:
+			run_numerics_tests();
+			break;
+		case FIXED_TOPOLOGY_TESTS:
+			run_fixed_topology_tests();
+			break;
+		case COMPLEXITY_TESTS:
+			run_complexity_tests();
+			break;
 
 		case COFFEE:
 			std::cout << "I hope you will find one then." << std::endl;
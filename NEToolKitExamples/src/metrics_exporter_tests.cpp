@@ -0,0 +1,113 @@
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define HAS_SOCKETS
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#endif
+
+#include <netkit/neat/neat.h>
+#include <netkit/profiling/metrics_exporter.h>
+
+#include "metrics_exporter_tests.h"
+#include "utils.h"
+
+namespace {
+#ifdef HAS_SOCKETS
+	// the whole response of the exporter to a raw HTTP request, empty if the connection failed.
+	std::string http_request(uint16_t port, const std::string& request_line) {
+		int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+		if (fd < 0) {
+			return "";
+		}
+
+		sockaddr_in address{};
+		address.sin_family = AF_INET;
+		address.sin_port = htons(port);
+		address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		if (::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+			::close(fd);
+			return "";
+		}
+
+		std::string request = request_line + "\r\nHost: 127.0.0.1\r\n\r\n";
+		if (::send(fd, request.data(), request.size(), 0) != static_cast<ssize_t>(request.size())) {
+			::close(fd);
+			return "";
+		}
+
+		// the server closes the connection once the response is sent.
+		std::string response;
+		char buffer[1024];
+		ssize_t received;
+		while ((received = ::recv(fd, buffer, sizeof(buffer), 0)) > 0) {
+			response.append(buffer, static_cast<size_t>(received));
+		}
+		::close(fd);
+		return response;
+	}
+
+	std::string body_of(const std::string& response) {
+		size_t end_of_headers = response.find("\r\n\r\n");
+		return end_of_headers == std::string::npos ? "" : response.substr(end_of_headers + 4);
+	}
+#endif
+}
+
+void run_metrics_exporter_tests() {
+	std::cout << "Starting metrics exporter tests..." << std::endl;
+
+#ifdef HAS_SOCKETS
+	netkit::parameters params;
+	params.initial_population_size = 20;
+	params.record_generation_stats = true;
+	netkit::neat neat(params);
+	neat.rand_engine.seed(5);
+
+	netkit::metrics_exporter exporter;
+	neat.set_metrics_exporter(&exporter);
+	neat.init();
+	for (int generation = 0; generation < 3; ++generation) {
+		for (netkit::organism& org : neat.generate_and_get_all_organisms()) {
+			org.set_fitness(1.0 + generation);
+		}
+		neat.epoch();
+	}
+
+	exporter.start_http_server(0);
+	check(exporter.port() != 0, "the server is bound to a free port");
+
+	std::string response = http_request(exporter.port(), "GET /metrics HTTP/1.0");
+	std::string body = body_of(response);
+	check(response.rfind("HTTP/1.0 200 OK\r\n", 0) == 0, "GET /metrics answers 200");
+	check(response.find("Content-Type: text/plain; version=0.0.4") != std::string::npos, "Prometheus content type");
+	check(response.find("Content-Length: " + std::to_string(body.size()) + "\r\n") != std::string::npos,
+		  "the content length is the one of the body");
+	check(body == exporter.render(), "the body is the rendered metrics");
+	check(body.find("netkit_epochs_total 3\n") != std::string::npos
+		  && body.find("netkit_evaluations_total 60\n") != std::string::npos
+		  && body.find("netkit_population_size 20\n") != std::string::npos,
+		  "the epochs, the evaluations and the population size are published");
+
+	std::string not_found = http_request(exporter.port(), "GET /nothing HTTP/1.0");
+	check(not_found.rfind("HTTP/1.0 404 Not Found\r\n", 0) == 0, "another path answers 404");
+
+	exporter.stop();
+	check(http_request(exporter.port(), "GET /metrics HTTP/1.0").empty(), "the server is closed once stopped");
+#else
+	std::cout << "  the HTTP server needs POSIX sockets, skipped." << std::endl;
+#endif
+
+	// the writer thread must survive the failed writes (here a missing directory) and keep trying.
+	netkit::metrics_exporter failing_exporter;
+	failing_exporter.start_file_writer("missing_metrics_directory/metrics.prom", std::chrono::milliseconds(10));
+	std::this_thread::sleep_for(std::chrono::milliseconds(100));
+	failing_exporter.stop();
+	check(failing_exporter.get_number_of_failed_writes() > 1 && !failing_exporter.get_last_file_error().empty(),
+		  "a failed write is remembered and retried instead of terminating");
+}
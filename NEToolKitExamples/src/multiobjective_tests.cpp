@@ -0,0 +1,189 @@
+#include <algorithm> // std::sort, std::max
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include <netkit/neat/multiobjective.h>
+#include <netkit/neat/neat.h>
+
+#include "multiobjective_tests.h"
+#include "utils.h"
+
+namespace {
+	bool dominates(const std::vector<double>& objectives, size_t m, size_t a, size_t b) {
+		bool strictly_better = false;
+		for (size_t k = 0; k < m; ++k) {
+			if (objectives[a * m + k] < objectives[b * m + k]) {
+				return false;
+			}
+			strictly_better |= objectives[a * m + k] > objectives[b * m + k];
+		}
+		return strictly_better;
+	}
+
+	// the textbook sort: peel off the non-dominated individuals front by front.
+	std::vector<unsigned int> naive_fronts(const std::vector<double>& objectives, size_t m) {
+		const size_t n = objectives.size() / m;
+		std::vector<unsigned int> fronts(n, 0);
+		std::vector<bool> assigned(n, false);
+		size_t number_assigned = 0;
+		for (unsigned int front = 0; number_assigned < n; ++front) {
+			std::vector<size_t> current;
+			for (size_t i = 0; i < n; ++i) {
+				if (assigned[i]) {
+					continue;
+				}
+				bool dominated = false;
+				for (size_t j = 0; j < n && !dominated; ++j) {
+					dominated = !assigned[j] && dominates(objectives, m, j, i);
+				}
+				if (!dominated) {
+					current.push_back(i);
+				}
+			}
+			for (size_t i : current) {
+				fronts[i] = front;
+				assigned[i] = true;
+			}
+			number_assigned += current.size();
+		}
+		return fronts;
+	}
+
+	// with distinct values, so that the order of the ties doesn't matter.
+	std::vector<double> naive_crowding(const std::vector<double>& objectives, size_t m,
+									   const std::vector<unsigned int>& fronts) {
+		const size_t n = fronts.size();
+		const double infinity = std::numeric_limits<double>::infinity();
+		std::vector<double> distances(n, 0);
+		for (size_t i = 0; i < n; ++i) {
+			for (size_t k = 0; k < m; ++k) {
+				double value = objectives[i * m + k];
+				double lowest = value, highest = value;
+				double below = -infinity, above = infinity;
+				size_t front_size = 0;
+				for (size_t j = 0; j < n; ++j) {
+					if (fronts[j] != fronts[i]) {
+						continue;
+					}
+					++front_size;
+					double other = objectives[j * m + k];
+					lowest = std::min(lowest, other);
+					highest = std::max(highest, other);
+					if (other < value) {
+						below = std::max(below, other);
+					} else if (other > value) {
+						above = std::min(above, other);
+					}
+				}
+				if (front_size <= 2 || std::isinf(below) || std::isinf(above)) {
+					distances[i] = infinity;
+					break;
+				}
+				distances[i] += (above - below) / (highest - lowest);
+			}
+		}
+		return distances;
+	}
+
+	std::vector<double> random_objectives(std::mt19937& rand_engine, size_t n, size_t m, bool with_ties) {
+		std::uniform_real_distribution<double> value(0, 1);
+		std::uniform_int_distribution<int> level(0, 4);
+		std::vector<double> objectives(n * m);
+		for (double& o : objectives) {
+			o = with_ties ? level(rand_engine) : value(rand_engine);
+		}
+		return objectives;
+	}
+
+	void run_sort_tests() {
+		std::cout << "\nNon-dominated sort, crowding distances and scores against a naive implementation:" << std::endl;
+
+		std::mt19937 rand_engine(7);
+		bool same_fronts = true;
+		bool same_crowding = true;
+		bool consistent_scores = true;
+		for (size_t m : {2, 3, 4}) {
+			for (int trial = 0; trial < 20; ++trial) {
+				bool with_ties = trial % 2 == 0;
+				std::vector<double> objectives = random_objectives(rand_engine, 60, m, with_ties);
+
+				std::vector<unsigned int> fronts = netkit::non_dominated_sort(objectives, m);
+				same_fronts &= fronts == naive_fronts(objectives, m);
+
+				std::vector<double> distances = netkit::crowding_distances(objectives, m, fronts);
+				if (!with_ties) {
+					std::vector<double> expected = naive_crowding(objectives, m, fronts);
+					for (size_t i = 0; i < fronts.size(); ++i) {
+						same_crowding &= std::isinf(expected[i]) ? std::isinf(distances[i])
+										 : std::abs(expected[i] - distances[i]) < 1e-9;
+					}
+				}
+
+				// the crowded-comparison order: the front first, then the crowding distance.
+				// distances summed in another order may only differ by rounding, they are ties.
+				std::vector<double> scores = netkit::nsga2_scores(objectives, m);
+				for (size_t i = 0; i < fronts.size(); ++i) {
+					for (size_t j = 0; j < fronts.size(); ++j) {
+						bool better = fronts[i] < fronts[j] || (fronts[i] == fronts[j] && distances[i] > distances[j] + 1e-9);
+						if (better && !(scores[i] > scores[j])) {
+							consistent_scores = false;
+						}
+					}
+				}
+			}
+		}
+		check(same_fronts, "same fronts as the naive sort (2, 3 and 4 objectives, with and without ties)");
+		check(same_crowding, "same crowding distances as the naive computation");
+		check(consistent_scores, "the scores follow the crowded-comparison order");
+		check(netkit::nsga2_scores({}, 2).empty(), "no individual");
+	}
+
+	void run_raw_fitness_tests() {
+		std::cout << "\nRanking by objectives keeps the raw fitness for the champions and the stats:" << std::endl;
+
+		netkit::parameters params;
+		params.number_of_inputs = 2;
+		params.number_of_outputs = 1;
+		params.initial_population_size = 50;
+		params.multiobjective_ranking = true;
+		params.number_of_objectives = 2;
+		params.record_generation_stats = true;
+		netkit::neat neat(params);
+		neat.rand_engine.seed(3);
+		neat.init();
+
+		std::mt19937 rand_engine(5);
+		std::uniform_real_distribution<double> value(0, 100);
+		double best_raw_fitness = 0;
+		bool raw_stats = true;
+		for (int generation = 0; generation < 10; ++generation) {
+			double generation_best = 0;
+			while (neat.has_more_organisms_to_process()) {
+				netkit::organism org = neat.generate_and_get_next_organism();
+				double fitness = value(rand_engine);
+				org.set_fitness(fitness);
+				org.set_objectives({fitness, value(rand_engine)});
+				generation_best = std::max(generation_best, fitness);
+			}
+			best_raw_fitness = std::max(best_raw_fitness, generation_best);
+			neat.update_best_genome_ever();
+			neat.epoch();
+
+			raw_stats &= std::abs(neat.get_stats_history().back().best_fitness - generation_best) < 1e-12;
+		}
+		check(std::abs(neat.get_best_fitness_ever() - best_raw_fitness) < 1e-12,
+			  "the best genome ever has the best raw fitness");
+		check(raw_stats, "the stats rows have the raw fitnesses");
+	}
+
+}
+
+void run_multiobjective_tests() {
+	std::cout << "Starting multi-objective tests..." << std::endl;
+
+	run_sort_tests();
+	run_raw_fitness_tests();
+}
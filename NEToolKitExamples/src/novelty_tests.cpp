@@ -1,4 +1,7 @@
+#include <algorithm> // std::sort, std::min
 #include <cmath>
+#include <random>
+#include <vector>
 
 #include <netkit/neat/genome.h>
 #include <netkit/neat/novelgenome.h>
@@ -6,6 +9,7 @@
 #include <netkit/neat/neat.h>
 
 #include "novelty_tests.h"
+#include "utils.h"
 
 struct novelty_position {
 	novelty_position(double a_, double b_) : a(a_), b(b_) {}
@@ -19,6 +23,97 @@ struct novelty_position {
 	double a, b;
 };
 
+namespace {
+	// sparseness of a registered member computed from scratch: mean distance to its nb_neighbours closest
+	// records of the archive or other members.
+	double brute_force_sparseness(const netkit::novelbank<novelty_position>& bank,
+								  const std::vector<netkit::novelgenome<novelty_position>>& members, size_t member,
+								  unsigned int nb_neighbours) {
+		std::vector<double> distances;
+		for (const novelty_position& pos : bank.bank()) {
+			distances.push_back(members[member].get_pos().novelty_distance(pos));
+		}
+		for (size_t other = 0; other < members.size(); ++other) {
+			if (other != member) {
+				distances.push_back(members[member].distance(members[other]));
+			}
+		}
+		std::sort(distances.begin(), distances.end());
+
+		double summed_distance = 0;
+		for (size_t i = 0; i < std::min<size_t>(nb_neighbours, distances.size()); ++i) {
+			summed_distance += distances[i];
+		}
+		return summed_distance / nb_neighbours;
+	}
+
+	// evaluate every member and compare with the brute force, returns the greatest difference.
+	double evaluate_and_compare(netkit::novelbank<novelty_position>& bank,
+								const std::vector<netkit::novelgenome<novelty_position>>& members,
+								unsigned int nb_neighbours) {
+		double max_difference = 0;
+		for (size_t i = 0; i < members.size(); ++i) {
+			double expected = brute_force_sparseness(bank, members, i, nb_neighbours);
+			max_difference = std::max(max_difference, std::abs(bank.evaluate(members[i]) - expected));
+		}
+		return max_difference;
+	}
+
+	void run_incremental_neighbourhoods_tests() {
+		std::cout << "\nIncremental neighbourhoods against a brute force search:" << std::endl;
+
+		const unsigned int nb_neighbours = 4;
+		std::mt19937 rand_engine(42);
+		std::uniform_real_distribution<double> coordinate(0, 10);
+		auto random_position = [&]() { return novelty_position(coordinate(rand_engine), coordinate(rand_engine)); };
+
+		// a small archive so that it wraps around several times.
+		netkit::novelbank<novelty_position> bank(12, 3, nb_neighbours);
+		std::vector<netkit::novelgenome<novelty_position>> members;
+		netkit::genome_id_t next_id = 0;
+		for (int i = 0; i < 20; ++i) {
+			members.emplace_back(next_id++, random_position());
+			bank.pop_register(members.back());
+		}
+
+		double max_difference = 0;
+		for (int generation = 0; generation < 30; ++generation) {
+			max_difference = std::max(max_difference, evaluate_and_compare(bank, members, nb_neighbours));
+			bank.bank_update();
+
+			// the elites stay, some members move, some are replaced by new ones.
+			for (size_t i = 0; i < members.size(); ++i) {
+				std::uniform_int_distribution<int> fate(0, 3);
+				int f = fate(rand_engine);
+				if (f == 1) {
+					members[i].set_pos(random_position());
+					bank.pop_register(members[i]);
+				} else if (f == 2) {
+					bank.pop_remove(members[i].get_genome_id());
+					members[i] = netkit::novelgenome<novelty_position>(next_id++, random_position());
+					bank.pop_register(members[i]);
+				}
+			}
+			max_difference = std::max(max_difference, evaluate_and_compare(bank, members, nb_neighbours));
+		}
+
+		check(bank.bank().full(), "the archive wrapped around");
+		check(max_difference < 1e-9, "same sparseness as the brute force (max difference = "
+			  + std::to_string(max_difference) + ")");
+
+		bank.bank_clear();
+		check(evaluate_and_compare(bank, members, nb_neighbours) < 1e-9, "same sparseness after clearing the archive");
+
+		// less candidates than neighbours.
+		netkit::novelbank<novelty_position> small_bank(5, 1e9, nb_neighbours);
+		std::vector<netkit::novelgenome<novelty_position>> few_members(members.begin(), members.begin() + 3);
+		for (const auto& ng : few_members) {
+			small_bank.pop_register(ng);
+		}
+		check(evaluate_and_compare(small_bank, few_members, nb_neighbours) < 1e-9, "less candidates than neighbours");
+	}
+}
+
 void run_novelty_tests() {
 	std::cout << "Starting novelty tests..." << std::endl;
 
@@ -41,4 +136,6 @@ void run_novelty_tests() {
 	std::cout << "dist 0->1 : " << all_ng[0].distance(all_ng[1]) << std::endl;
 
 	std::cout << "sparseness of 0: " << novelbank.evaluate(all_ng[0]) << std::endl;
+
+	run_incremental_neighbourhoods_tests();
 }
@@ -0,0 +1,316 @@
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <vector>
+
+#include <netkit/network/activation_functions.h>
+#include <netkit/network/backpropagation.h>
+#include <netkit/network/compiled_network.h>
+#include <netkit/network/ctrnn.h>
+#include <netkit/network/link.h>
+#include <netkit/neat/genome.h>
+#include <netkit/neat/neat.h>
+#include <netkit/neat/substrate.h>
+
+#include "numerics_tests.h"
+#include "utils.h"
+
+namespace {
+	bool close_to(double value, double expected, double tolerance) {
+		return std::abs(value - expected) <= tolerance * (1 + std::abs(expected));
+	}
+
+	// bias 0, inputs 1 and 2, output 3 (sigmoid), hidden 4 (tanh) and 5 (relu, never active on the samples).
+	netkit::compiled_network gradient_check_network() {
+		std::vector<netkit::link> links = {
+			{0, 4, 0.1}, {1, 4, 0.8}, {2, 4, -0.6},
+			{0, 5, -5.0}, {1, 5, 0.3}, {2, 5, 0.2},
+			{4, 3, 1.2}, {5, 3, -0.7}, {0, 3, -0.2}, {1, 3, 0.5}
+		};
+		std::vector<netkit::activation_func_t> activations = {
+			netkit::linear, netkit::linear, netkit::linear, netkit::sigmoid, netkit::hyperbolic_tangent, netkit::relu
+		};
+		return netkit::compiled_network(links, activations, {1, 2}, {3});
+	}
+
+	void run_backpropagation_tests() {
+		std::cout << "\nBackpropagation tests:" << std::endl;
+
+		netkit::compiled_network net = gradient_check_network();
+		std::vector<netkit::training_sample> samples = {
+			{{0, 0}, {0}}, {{0, 1}, {1}}, {{1, 0}, {1}}, {{1, 1}, {0}}, {{0.3, -0.4}, {0.6}}
+		};
+		check(net.is_differentiable(), "the network is differentiable");
+
+		// one step of gradient descent: the update divided by the learning rate is the gradient.
+		const std::vector<netkit::neuron_value_t> weights = net.get_weights();
+		const double learning_rate = 1e-3;
+		std::vector<netkit::neuron_value_t> stepped = weights;
+		netkit::backpropagate(net, stepped.data(), samples, 1, learning_rate);
+
+		// central finite differences of the mean squared error.
+		const double h = 1e-6;
+		bool same_gradients = true;
+		bool inactive_relu = true;
+		for (size_t i = 0; i < weights.size(); ++i) {
+			std::vector<netkit::neuron_value_t> plus = weights;
+			std::vector<netkit::neuron_value_t> minus = weights;
+			plus[i] += h;
+			minus[i] -= h;
+			double numerical = (netkit::mean_squared_error(net, plus.data(), samples)
+								- netkit::mean_squared_error(net, minus.data(), samples)) / (2 * h);
+			double analytical = (weights[i] - stepped[i]) / learning_rate;
+			same_gradients &= close_to(analytical, numerical, 1e-5);
+			if (net.source(i) == 5 || (i >= net.incoming_begin(5) && i < net.incoming_end(5))) {
+				inactive_relu &= std::abs(weights[i] - stepped[i]) < 1e-15;
+			}
+		}
+		check(same_gradients, "the gradients match the central finite differences");
+		check(inactive_relu, "the links of a neuron without gradient are left untouched");
+
+		// the masked weights (the first and the last ones) don't move.
+		std::vector<netkit::neuron_value_t> mask;
+		for (size_t i = 0; i < weights.size(); ++i) {
+			mask.push_back(i == 0 || i + 1 == weights.size() ? 0 : 1);
+		}
+		std::vector<netkit::neuron_value_t> masked = weights;
+		double error = netkit::backpropagate(net, masked.data(), samples, 50, 0.5, mask.data());
+		bool kept = true;
+		for (size_t i = 0; i < weights.size(); ++i) {
+			kept &= mask[i] > 0 || std::abs(masked[i] - weights[i]) < 1e-15;
+		}
+		check(kept, "the masked weights are kept");
+		check(error < netkit::mean_squared_error(net, weights.data(), samples), "the descent lowers the error");
+	}
+
+	// a single linear output fed by the input 1: tau * dy/dt = -y + b + w * x, so with y(0) = 0 and a constant input
+	// y(t) = c * (1 - exp(-t / tau)) where c = b + w * x.
+	const double TAU = 0.5;
+	const double BIAS = 0.25;
+	const double WEIGHT = 0.5;
+	const double INPUT = 1.5;
+
+	double integration_error(netkit::neat& neat, netkit::ctrnn_integration_t integration, double time_step) {
+		neat.params.ctrnn_integration = integration;
+		neat.params.ctrnn_time_step = time_step;
+		netkit::genome genome(&neat);
+		genome.add_gene(netkit::gene(neat.innov_pool.next_innovation(), 1, 3, WEIGHT));
+		genome.set_time_constant(3, TAU);
+		genome.set_bias(3, BIAS);
+
+		netkit::ctrnn controller = genome.generate_ctrnn();
+		controller.flush();
+		controller.load_inputs({INPUT, 0});
+		const auto steps = static_cast<unsigned int>(std::lround(1.0 / time_step));
+		controller.advance(steps);
+
+		double c = BIAS + WEIGHT * INPUT;
+		double t = time_step * steps;
+		return std::abs(controller.get_outputs()[0] - c * (1 - std::exp(-t / TAU)));
+	}
+
+	void run_ctrnn_tests() {
+		std::cout << "\nCTRNN integration tests:" << std::endl;
+
+		netkit::parameters params;
+		params.output_activation_function = netkit::IDENTITY_ACTIVATION;
+		netkit::neat neat(params);
+
+		// halving the time step divides the error by 2 (first order) or by 4 (second order).
+		double euler = integration_error(neat, netkit::EULER_INTEGRATION, 0.01);
+		double euler_half = integration_error(neat, netkit::EULER_INTEGRATION, 0.005);
+		double heun = integration_error(neat, netkit::RK2_INTEGRATION, 0.01);
+		double heun_half = integration_error(neat, netkit::RK2_INTEGRATION, 0.005);
+		check(euler < 1e-2 && close_to(euler / euler_half, 2, 0.05), "Euler converges to the exact solution at order 1");
+		check(heun < 1e-4 && close_to(heun / heun_half, 4, 0.05), "Heun converges to the exact solution at order 2");
+
+		// a batch of agents gives the results of the agents alone.
+		neat.params.ctrnn_integration = netkit::RK2_INTEGRATION;
+		neat.params.ctrnn_time_step = 0.05;
+		std::vector<netkit::ctrnn> controllers;
+		for (int agent = 0; agent < 3; ++agent) {
+			netkit::genome genome(&neat);
+			genome.add_gene(netkit::gene(neat.innov_pool.next_innovation(), 1, 3, WEIGHT * agent));
+			genome.add_gene(netkit::gene(neat.innov_pool.next_innovation(), 3, 3, -0.3));
+			genome.set_time_constant(3, TAU + agent);
+			genome.set_bias(3, BIAS);
+			controllers.push_back(genome.generate_ctrnn());
+		}
+		netkit::ctrnn_batch batch(controllers[0], controllers.size());
+		for (size_t agent = 0; agent < controllers.size(); ++agent) {
+			batch.set_controller(agent, controllers[agent]);
+		}
+		batch.flush();
+		std::vector<netkit::neuron_value_t> inputs;
+		for (netkit::ctrnn& controller : controllers) {
+			controller.flush();
+			controller.load_inputs({INPUT, -INPUT});
+			controller.advance(40);
+			inputs.insert(inputs.end(), {INPUT, -INPUT});
+		}
+		batch.load_inputs(inputs.data());
+		batch.advance(40);
+		std::vector<netkit::neuron_value_t> outputs(controllers.size());
+		batch.get_outputs(outputs.data());
+		bool same_outputs = true;
+		for (size_t agent = 0; agent < controllers.size(); ++agent) {
+			same_outputs &= close_to(outputs[agent], controllers[agent].get_outputs()[0], 1e-12);
+		}
+		check(same_outputs, "a batch of agents follows the agents alone");
+	}
+
+	void run_activation_tests() {
+		std::cout << "\nActivation function tests:" << std::endl;
+
+		// across and beyond the [-16, 16] grid of the tables, a count that isn't a multiple of the blocks.
+		const size_t count = 10007;
+		std::vector<netkit::neuron_value_t> sums(count);
+		for (size_t i = 0; i < count; ++i) {
+			sums[i] = -40 + 80 * static_cast<double>(i) / static_cast<double>(count - 1);
+		}
+
+		bool accurate = true;
+		bool exact_piecewise_linear = true;
+		bool same_as_scalar = true;
+		for (int f = 0; f < netkit::NUMBER_OF_ACTIVATION_FUNCTIONS; ++f) {
+			const auto func = static_cast<netkit::activation_function_t>(f);
+			const netkit::raw_activation_func_t exact = netkit::activation_function(func, false);
+			const netkit::raw_activation_func_t table = netkit::activation_function(func, true);
+
+			for (netkit::neuron_value_t x : sums) {
+				const double error = std::abs(table(x) - exact(x));
+				if (func == netkit::RELU_ACTIVATION || func == netkit::IDENTITY_ACTIVATION
+					|| func == netkit::ABSOLUTE_ACTIVATION) {
+					exact_piecewise_linear &= error <= 1e-12 * (1 + std::abs(x));
+				} else if (func == netkit::STEP_ACTIVATION) {
+					accurate &= (x > 0 && x <= 1.0 / 128) || error <= 1e-12; // the ramp
+				} else {
+					accurate &= error < 1e-4;
+				}
+			}
+
+			for (bool lookup_table : {false, true}) {
+				const netkit::raw_activation_func_t scalar = lookup_table ? table : exact;
+				std::vector<netkit::neuron_value_t> values(count);
+				netkit::apply_activation(func, lookup_table, sums.data(), values.data(), count);
+				std::vector<netkit::neuron_value_t> in_place = sums;
+				netkit::apply_activation(func, lookup_table, in_place.data(), in_place.data(), count);
+				for (size_t i = 0; i < count; ++i) {
+					same_as_scalar &= std::equal_to<netkit::neuron_value_t>()(values[i], scalar(sums[i]))
+									  && std::equal_to<netkit::neuron_value_t>()(in_place[i], values[i]);
+				}
+			}
+		}
+		check(accurate, "the tables are within 1e-4 of the smooth functions (the sine being periodic)");
+		check(exact_piecewise_linear, "the tables of relu, identity and absolute are exact");
+		check(same_as_scalar, "apply_activation gives the scalar functions, tail and in place included");
+	}
+
+	// the incoming links of every neuron, their sources and their weights are the same.
+	bool same_links(const netkit::compiled_network& first, const netkit::compiled_network& second) {
+		if (first.number_of_neurons() != second.number_of_neurons()
+			|| first.number_of_links() != second.number_of_links()) {
+			return false;
+		}
+		for (netkit::neuron_id_t nid = 0; nid < first.number_of_neurons(); ++nid) {
+			if (first.incoming_begin(nid) != second.incoming_begin(nid)
+				|| first.incoming_end(nid) != second.incoming_end(nid)) {
+				return false;
+			}
+		}
+		for (size_t l = 0; l < first.number_of_links(); ++l) {
+			if (first.source(l) != second.source(l)
+				|| !std::equal_to<netkit::neuron_value_t>()(first.get_weights()[l], second.get_weights()[l])) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	void run_substrate_tests() {
+		std::cout << "\nSubstrate tests:" << std::endl;
+
+		// a CPPN grown at random: bias and inputs 0 to 4, output 5.
+		netkit::parameters params = netkit::substrate::cppn_parameters(netkit::parameters());
+		netkit::neat neat(params);
+		neat.rand_engine.seed(17);
+		netkit::genome cppn(&neat);
+		for (netkit::neuron_id_t from = 0; from <= 4; ++from) {
+			cppn.add_gene({neat.innov_pool.next_innovation(), from, 5, 0});
+		}
+		cppn.mutate_reset_weights();
+		for (int i = 0; i < 30; ++i) {
+			if (i % 3 == 0) {
+				cppn.mutate_add_neuron();
+			} else {
+				cppn.mutate_add_link();
+			}
+			cppn.mutate_change_activation();
+		}
+		cppn.mutate_reset_weights();
+
+		// 9 x 7 x 5 neurons: 98 candidate links, which no batch size below divides.
+		std::vector<std::vector<netkit::substrate_point>> layers(3);
+		const size_t sizes[] = {9, 7, 5};
+		for (size_t l = 0; l < layers.size(); ++l) {
+			for (size_t i = 0; i < sizes[l]; ++i) {
+				layers[l].push_back({2.0 * static_cast<double>(i) / static_cast<double>(sizes[l] - 1) - 1,
+									 static_cast<double>(l) - 1});
+			}
+		}
+		netkit::substrate sub(layers);
+
+		netkit::compiled_network reference = sub.build_unbatched(cppn, params);
+		bool same = reference.number_of_links() > 0;
+		for (size_t batch_size : {1, 5, 13, 64, 1024}) {
+			params.cppn_batch_size = batch_size;
+			same &= same_links(sub.build(cppn, params), reference);
+		}
+		check(same, "build gives the links of build_unbatched, whatever the batch size");
+
+		// a CPPN whose output is x1: the weights of the links from the inputs are the scaled x1.
+		netkit::genome identity_cppn(&neat);
+		identity_cppn.add_gene({neat.innov_pool.next_innovation(), 1, 5, 1});
+		const std::vector<double> xs = {-1, -0.6, -0.2, -0.1, 0, 0.1, 0.2, 0.6, 1, 1.5};
+		std::vector<netkit::substrate_point> inputs;
+		for (double x : xs) {
+			inputs.push_back({x, 0});
+		}
+		netkit::substrate line({inputs, {{0, 1}}});
+		params.substrate_expression_threshold = 0.2;
+		params.substrate_max_weight = 5.0;
+		netkit::compiled_network expressed = line.build(identity_cppn, params);
+
+		// ids: the bias, the inputs 1 to 10 and the output 11.
+		std::vector<double> expected_weights(xs.size() + 1, 0);
+		expected_weights[1] = -5.0; // -1
+		expected_weights[2] = -2.5; // -0.6: half way from the threshold to -1
+		expected_weights[8] = 2.5;
+		expected_weights[9] = 5.0;
+		expected_weights[10] = 5.0; // clamped to 1
+		const netkit::neuron_id_t output = static_cast<netkit::neuron_id_t>(xs.size() + 1);
+		bool scaled = expressed.incoming_end(output) - expressed.incoming_begin(output) == 5;
+		bool in_range = true;
+		for (size_t l = expressed.incoming_begin(output); l < expressed.incoming_end(output); ++l) {
+			double weight = expressed.get_weights()[l];
+			scaled &= close_to(weight, expected_weights[expressed.source(l)], 1e-12);
+			in_range &= std::abs(weight) <= params.substrate_max_weight;
+		}
+		check(scaled, "the weights are signed, 0 at the threshold and substrate_max_weight for an output of 1");
+
+		for (size_t l = 0; l < reference.number_of_links(); ++l) {
+			double weight = reference.get_weights()[l];
+			in_range &= std::abs(weight) > 0 && std::abs(weight) <= params.substrate_max_weight;
+		}
+		check(in_range, "the expressed weights are in (0, substrate_max_weight]");
+	}
+}
+
+void run_numerics_tests() {
+	std::cout << "Starting numerics tests..." << std::endl;
+
+	run_backpropagation_tests();
+	run_ctrnn_tests();
+	run_activation_tests();
+	run_substrate_tests();
+}
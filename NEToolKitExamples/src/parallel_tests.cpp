@@ -0,0 +1,340 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <netkit/neat/experiment_runner.h>
+#include <netkit/neat/neat.h>
+#include <netkit/network/activation_functions.h>
+#include <netkit/network/compiled_network.h>
+#include <netkit/network/network.h>
+#include <netkit/utils/thread_pool.h>
+
+#include "parallel_tests.h"
+#include "utils.h"
+
+namespace {
+	void run_thread_pool_tests() {
+		std::cout << "\nThread pool tests:" << std::endl;
+
+		netkit::thread_pool pool(2);
+		std::vector<int> visits(1000, 0);
+		pool.parallel_for(visits.size(), [&](size_t i) { ++visits[i]; });
+		bool each_once = true;
+		for (int v : visits) {
+			each_once &= v == 1;
+		}
+		check(each_once, "parallel_for visits every index once");
+
+		// a task blocks one of the two workers: parallel_for must only wait for its own chunks.
+		std::atomic<bool> release(false);
+		std::atomic<bool> blocker_done(false);
+		pool.submit([&]() {
+			while (!release.load()) {
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			}
+			blocker_done = true;
+		});
+		std::atomic<size_t> sum(0);
+		pool.parallel_for(100, [&](size_t i) { sum += i; });
+		check(sum == 4950 && !blocker_done, "parallel_for doesn't wait for the other tasks");
+		release = true;
+		pool.wait();
+		check(blocker_done, "wait() waits for every task");
+
+		bool rethrown = false;
+		try {
+			pool.parallel_for(100, [](size_t i) {
+				if (i == 42) {
+					throw std::runtime_error("42");
+				}
+			});
+		} catch (const std::runtime_error&) {
+			rethrown = true;
+		}
+		bool leaked = false;
+		try {
+			pool.wait();
+		} catch (...) {
+			leaked = true;
+		}
+		check(rethrown && !leaked, "the exception of a chunk is rethrown by parallel_for only");
+	}
+
+	// a recurrent network large enough to be split over the pool: random links, cycles and self-loops included.
+	netkit::network random_recurrent_network(size_t number_of_neurons, size_t number_of_links) {
+		std::mt19937 rand_engine(3);
+		netkit::network net;
+		for (int i = 0; i < 4; ++i) {
+			net.add_neuron(netkit::INPUT, netkit::neuron(0, &netkit::linear));
+		}
+		for (int i = 0; i < 2; ++i) {
+			net.add_neuron(netkit::OUTPUT, netkit::neuron(0, &netkit::hyperbolic_tangent));
+		}
+		while (net.number_of_neurons() < number_of_neurons) {
+			net.add_neuron(netkit::HIDDEN, netkit::neuron(0, &netkit::hyperbolic_tangent));
+		}
+
+		std::uniform_int_distribution<netkit::neuron_id_t> any(0, static_cast<netkit::neuron_id_t>(number_of_neurons - 1));
+		std::uniform_int_distribution<netkit::neuron_id_t> fed(5, static_cast<netkit::neuron_id_t>(number_of_neurons - 1));
+		std::uniform_real_distribution<netkit::neuron_value_t> weight(-0.5, 0.5);
+		for (size_t l = 0; l < number_of_links; ++l) {
+			net.add_link(any(rand_engine), fed(rand_engine), weight(rand_engine));
+		}
+		return net;
+	}
+
+	void run_synchronous_activation_tests() {
+		std::cout << "\nSynchronous activation tests:" << std::endl;
+
+		netkit::network net = random_recurrent_network(500, 40000);
+		netkit::compiled_network compiled(net);
+		netkit::thread_pool pool(4);
+		const std::vector<netkit::neuron_value_t> inputs = {0.5, -1, 0.25, 1};
+
+		net.flush();
+		net.load_inputs(inputs);
+		std::vector<netkit::neuron_value_t> serial;
+		compiled.flush(serial);
+		compiled.load_inputs(serial, inputs);
+		std::vector<netkit::neuron_value_t> pooled = serial;
+		std::vector<netkit::neuron_value_t> next;
+
+		bool same_as_serial = true;
+		for (int tick = 0; tick < 10; ++tick) {
+			net.activate_synchronous();
+			compiled.activate_synchronous(compiled.get_weights().data(), serial, next);
+			serial.swap(next);
+			compiled.activate_synchronous(compiled.get_weights().data(), pooled, next, pool);
+			pooled.swap(next);
+			same_as_serial &= pooled == serial;
+		}
+		check(same_as_serial, "the pooled updates are exactly the serial ones");
+
+		bool same_as_network = true;
+		for (const netkit::neuron& n : net.get_neurons()) {
+			size_t nid = static_cast<size_t>(&n - net.get_neurons().data());
+			same_as_network &= std::abs(n.get_value() - serial[nid]) < 1e-12;
+		}
+		check(same_as_network, "the compiled updates follow network::activate_synchronous");
+	}
+
+	void run_feed_forward_activation_tests() {
+		std::cout << "\nLevel-parallel feed-forward activation tests:" << std::endl;
+
+		// three fully connected layers of 200 neurons after 4 inputs: the levels have 40000 links.
+		const netkit::neuron_id_t width = 200;
+		std::mt19937 rand_engine(5);
+		std::uniform_real_distribution<netkit::neuron_value_t> weight(-0.2, 0.2);
+		std::vector<netkit::link> links;
+		std::vector<netkit::neuron_id_t> previous_layer = {0, 1, 2, 3, 4};
+		netkit::neuron_id_t next_id = 5;
+		for (int layer = 0; layer < 3; ++layer) {
+			std::vector<netkit::neuron_id_t> current_layer;
+			for (netkit::neuron_id_t i = 0; i < width; ++i) {
+				current_layer.push_back(next_id++);
+				for (netkit::neuron_id_t from : previous_layer) {
+					links.emplace_back(from, current_layer.back(), weight(rand_engine));
+				}
+			}
+			previous_layer = current_layer;
+		}
+		std::vector<netkit::activation_func_t> activations(next_id, &netkit::sigmoid);
+		for (netkit::neuron_id_t i = 5; i < next_id; i += 3) {
+			activations[i] = &netkit::hyperbolic_tangent; // several groups per level
+		}
+		netkit::compiled_network compiled(links, activations, {1, 2, 3, 4}, previous_layer);
+		netkit::thread_pool pool(4);
+
+		bool same_values = true;
+		bool same_outputs = true;
+		std::vector<netkit::neuron_value_t> serial;
+		std::vector<netkit::neuron_value_t> pooled;
+		for (netkit::neuron_value_t x : {-1.0, 0.0, 0.5}) {
+			const std::vector<netkit::neuron_value_t> inputs = {x, 1 - x, x * x, 0.25};
+			compiled.flush(serial);
+			compiled.load_inputs(serial, inputs);
+			pooled = serial;
+			compiled.activate_feed_forward(compiled.get_weights().data(), serial);
+			compiled.activate_feed_forward(compiled.get_weights().data(), pooled, pool);
+			same_values &= pooled == serial;
+
+			same_outputs &= compiled.evaluate(compiled.get_weights().data(), inputs, serial)
+							== compiled.evaluate(compiled.get_weights().data(), inputs, pooled, pool);
+		}
+		check(same_values, "the level-parallel activation gives exactly the serial values");
+		check(same_outputs, "evaluate with a pool gives the outputs of evaluate");
+	}
+
+	// keeps the results of the runs, and writes them to another sink as well.
+	class collecting_sink : public netkit::experiment_sink {
+	  public:
+		explicit collecting_sink(netkit::experiment_sink* next = nullptr)
+			: results()
+			, m_next(next) {}
+
+		void write(const netkit::experiment_result& result) override {
+			results.push_back(result);
+			if (m_next != nullptr) {
+				m_next->write(result);
+			}
+		}
+
+		std::vector<netkit::experiment_result> results;
+
+	  private:
+		netkit::experiment_sink* m_next;
+	};
+
+	// in the grid order, rather than the completion order.
+	std::vector<netkit::experiment_result> sorted_results(std::vector<netkit::experiment_result> results) {
+		std::sort(results.begin(), results.end(), [](const netkit::experiment_result& a,
+													 const netkit::experiment_result& b) {
+			return a.configuration < b.configuration || (a.configuration == b.configuration && a.run < b.run);
+		});
+		return results;
+	}
+
+	// the same outcome (the durations aside).
+	bool same_results(const std::vector<netkit::experiment_result>& first,
+					  const std::vector<netkit::experiment_result>& second) {
+		return std::equal(first.begin(), first.end(), second.begin(), second.end(),
+						  [](const netkit::experiment_result& a, const netkit::experiment_result& b) {
+			return a.configuration == b.configuration && a.run == b.run && a.seed == b.seed
+				   && a.generations == b.generations && std::equal_to<double>()(a.best_fitness, b.best_fitness)
+				   && a.best_genome_size == b.best_genome_size && a.success == b.success
+				   && a.number_of_species == b.number_of_species;
+		});
+	}
+
+	// xor, solved when every output is on the right side of 0.5.
+	bool rate_xor(netkit::neat& neat) {
+		const std::vector<std::vector<netkit::neuron_value_t>> inputs = {{0, 0}, {0, 1}, {1, 0}, {1, 1}};
+		const std::vector<netkit::neuron_value_t> expected = {0, 1, 1, 0};
+		bool solved = false;
+		for (netkit::organism& org : neat.generate_and_get_all_organisms()) {
+			netkit::network& net = org.get_network();
+			double fitness = 4;
+			bool right = true;
+			for (size_t run = 0; run < inputs.size(); ++run) {
+				net.flush();
+				net.load_inputs(inputs[run]);
+				net.activate_until_relaxation();
+				double output = net.get_outputs()[0];
+				fitness -= std::abs(output - expected[run]);
+				right &= (output > 0.5) == (expected[run] > 0.5);
+			}
+			org.set_fitness(fitness * fitness);
+			solved |= right;
+		}
+		return solved;
+	}
+
+	void run_experiment_runner_tests() {
+		std::cout << "\nExperiment runner tests:" << std::endl;
+
+		std::vector<netkit::parameters> configurations(2);
+		for (netkit::parameters& params : configurations) {
+			params.number_of_inputs = 2;
+			params.number_of_outputs = 1;
+			params.initial_population_size = 60;
+		}
+		configurations[1].mutation_probs[netkit::ADD_NEURON] = 0.1;
+
+		netkit::experiment_options options;
+		options.runs_per_configuration = 8;
+		options.max_generations = 40;
+		options.base_seed = 7;
+
+		options.number_of_threads = 1;
+		collecting_sink serial_sink;
+		std::vector<netkit::experiment_summary> serial_summaries = netkit::run_experiments(configurations, options,
+																						   rate_xor, &serial_sink);
+
+		const std::string filename = "experiment_results_check.bin";
+		std::vector<netkit::experiment_result> pooled_results;
+		std::vector<netkit::experiment_summary> pooled_summaries;
+		{
+			netkit::binary_experiment_sink binary_sink(filename);
+			collecting_sink pooled_sink(&binary_sink);
+			options.number_of_threads = 4;
+			pooled_summaries = netkit::run_experiments(configurations, options, rate_xor, &pooled_sink);
+			pooled_results = sorted_results(pooled_sink.results);
+		}
+		std::vector<netkit::experiment_result> serial_results = sorted_results(serial_sink.results);
+
+		check(serial_results.size() == configurations.size() * options.runs_per_configuration,
+			  "every run is written to the sink");
+		check(same_results(serial_results, pooled_results), "the runs don't depend on the number of threads");
+
+		std::set<uint64_t> seeds;
+		bool replayable = true;
+		for (const netkit::experiment_result& result : serial_results) {
+			seeds.insert(result.seed);
+			replayable &= result.seed == netkit::experiment_seed(options.base_seed, result.configuration, result.run);
+		}
+		check(seeds.size() == serial_results.size() && replayable, "the seeds are distinct and derived from the run");
+
+		bool exact_summaries = true;
+		bool mixed_outcomes = false;
+		for (size_t configuration = 0; configuration < configurations.size(); ++configuration) {
+			std::vector<uint64_t> generations; // of the successful runs
+			for (const netkit::experiment_result& result : serial_results) {
+				if (result.configuration == configuration && result.success != 0) {
+					generations.push_back(result.generations);
+				}
+			}
+			std::sort(generations.begin(), generations.end());
+			mixed_outcomes |= !generations.empty() && generations.size() < options.runs_per_configuration;
+
+			for (const std::vector<netkit::experiment_summary>* summaries : {&serial_summaries, &pooled_summaries}) {
+				const netkit::experiment_summary& summary = (*summaries)[configuration];
+				exact_summaries &= summary.number_of_runs == options.runs_per_configuration
+								   && summary.number_of_successes == generations.size();
+				exact_summaries &= std::abs(summary.success_rate() - static_cast<double>(generations.size())
+											/ static_cast<double>(options.runs_per_configuration)) < 1e-12;
+				for (double q : {0.0, 0.1, 0.25, 0.5, 0.75, 0.9, 1.0}) {
+					// nearest rank: the smallest value with at least q of the values below or equal.
+					uint64_t expected = 0;
+					if (!generations.empty()) {
+						size_t rank = 1;
+						while (static_cast<double>(rank) < q * static_cast<double>(generations.size())) {
+							++rank;
+						}
+						expected = generations[rank - 1];
+					}
+					exact_summaries &= summary.generations_quantile(q) == expected;
+				}
+			}
+		}
+		check(exact_summaries, "the success rates and the quantiles are the ones of the sorted runs");
+		check(mixed_outcomes, "the grid has solved and unsolved runs");
+
+		bool read_back = false;
+		try {
+			read_back = same_results(sorted_results(netkit::read_experiment_results_binary(filename)), pooled_results);
+		} catch (const std::exception& e) {
+			std::cout << "  " << e.what() << std::endl;
+		}
+		std::remove(filename.c_str());
+		check(read_back, "the binary sink is read back");
+	}
+}
+
+void run_parallel_tests() {
+	std::cout << "Starting parallel tests..." << std::endl;
+
+	run_thread_pool_tests();
+	run_synchronous_activation_tests();
+	run_feed_forward_activation_tests();
+	run_experiment_runner_tests();
+}
@@ -0,0 +1,172 @@
+#include <algorithm> // std::min
+#include <array>
+#include <cstdio> // std::remove
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <netkit/csv/deserializer.h>
+#include <netkit/csv/serializer.h>
+#include <netkit/neat/novelbank.h>
+#include <netkit/neat/novelpos.h>
+#include <netkit/utils/mapped_ring_buffer.h>
+#include <netkit/utils/ring_buffer.h>
+
+#include "ring_buffer_tests.h"
+#include "utils.h"
+
+namespace {
+	// the elements by age must be the last pushed values, in the same order.
+	template <typename buffer_t>
+	bool holds_last_values(const buffer_t& buffer, const std::vector<int>& pushed) {
+		if (buffer.size() != std::min(pushed.size(), buffer.capacity())) {
+			return false;
+		}
+		size_t first = pushed.size() - buffer.size();
+		for (size_t i = 0; i < buffer.size(); ++i) {
+			if (buffer[i] != pushed[first + i] || buffer.at_sequence(first + i) != pushed[first + i]) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// every slot must know the sequence of the element it stores.
+	template <typename buffer_t>
+	bool slots_match_sequences(const buffer_t& buffer) {
+		for (size_t slot = 0; slot < buffer.size(); ++slot) {
+			uint64_t sequence = buffer.sequence_of_slot(slot);
+			if (!buffer.holds(sequence) || &buffer.at_sequence(sequence) != buffer.data() + slot) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	void remove_mapped_files(const std::string& path) {
+		std::remove(path.c_str());
+		std::remove((path + ".idx").c_str());
+	}
+
+	void run_mapped_ring_buffer_tests() {
+		std::cout << "\nMapped ring buffer tests:" << std::endl;
+
+		const std::string path = "mapped ring;buffer.bin";
+		remove_mapped_files(path);
+
+		std::vector<int> pushed;
+		{
+			netkit::mapped_ring_buffer<int> buffer(path, 5);
+			for (int i = 0; i < 13; ++i) {
+				buffer.push_back(i * 10);
+				pushed.push_back(i * 10);
+			}
+			check(buffer.full() && holds_last_values(buffer, pushed), "wrapped around twice");
+			check(buffer.oldest_sequence() == 8 && buffer.next_sequence() == 13, "sequence numbers after the wraparound");
+			check(slots_match_sequences(buffer), "sequence of every slot");
+		}
+
+		{
+			netkit::mapped_ring_buffer<int> reopened(path, 5);
+			check(holds_last_values(reopened, pushed) && reopened.next_sequence() == 13, "reopened buffer");
+
+			reopened.push_back(130);
+			pushed.push_back(130);
+			check(holds_last_values(reopened, pushed), "pushed after the reopening");
+		}
+
+		// the existing buffer must neither be reopened nor resized with another capacity.
+		bool rejected = false;
+		try {
+			netkit::mapped_ring_buffer<int> other_capacity(path, 8);
+		} catch (const std::runtime_error&) {
+			rejected = true;
+		}
+		check(rejected && netkit::mapped_file::size_on_disk(path) == static_cast<int64_t>(5 * sizeof(int)),
+			  "another capacity is rejected without resizing the file");
+		{
+			netkit::mapped_ring_buffer<int> reopened(path, 5);
+			check(holds_last_values(reopened, pushed), "the content survives the rejected opening");
+		}
+
+		remove_mapped_files(path);
+	}
+
+	void run_mapped_novelbank_tests() {
+		std::cout << "\nMapped novelbank serialization tests:" << std::endl;
+
+		using pos_t = netkit::novelpos<2>;
+		const std::string path = "mapped novel;bank.bin";
+		const std::string other_path = "mapped novelbank restored.bin";
+		const std::string state_filename = "mapped_novelbank_state.csv";
+		remove_mapped_files(path);
+		remove_mapped_files(other_path);
+
+		{
+			netkit::mapped_ring_buffer<pos_t> archive(path, 4);
+			for (int i = 0; i < 6; ++i) {
+				archive.push_back(pos_t(std::array<double, 2>{static_cast<double>(i), 1.0}));
+			}
+			netkit::mapped_novelbank<pos_t> bank(std::move(archive), 0.5, 2);
+
+			netkit::serializer ser(state_filename);
+			ser << bank;
+		}
+
+		netkit::mapped_novelbank<pos_t> restored(netkit::mapped_ring_buffer<pos_t>(other_path, 4), 0.5, 2);
+		{
+			netkit::deserializer des(state_filename);
+			des >> restored;
+		}
+		check(restored.bank().path() == path && restored.bank().size() == 4 && restored.bank()[0][0] > 1.5
+			  && restored.bank()[0][0] < 2.5, "the archive is reopened from a path with spaces and separators");
+
+		remove_mapped_files(path);
+		bool rejected = false;
+		try {
+			netkit::deserializer des(state_filename);
+			des >> restored;
+		} catch (const std::runtime_error&) {
+			rejected = true;
+		}
+		check(rejected && netkit::mapped_file::size_on_disk(path) < 0, "restoring a deleted archive fails");
+
+		remove_mapped_files(other_path);
+		std::remove(state_filename.c_str());
+	}
+}
+
+void run_ring_buffer_tests() {
+	std::cout << "Starting ring buffer tests..." << std::endl;
+
+	netkit::ring_buffer<int> buffer(5);
+	std::vector<int> pushed;
+	bool overwritten = false;
+	for (int i = 0; i < 3; ++i) {
+		overwritten |= buffer.push_back(i * 10);
+		pushed.push_back(i * 10);
+	}
+	check(!overwritten && !buffer.full() && holds_last_values(buffer, pushed), "partially filled buffer");
+
+	for (int i = 3; i < 13; ++i) {
+		overwritten = buffer.push_back(i * 10);
+		pushed.push_back(i * 10);
+	}
+	check(overwritten && buffer.full() && holds_last_values(buffer, pushed), "wrapped around twice");
+	check(buffer.oldest_sequence() == 8 && buffer.next_sequence() == 13, "sequence numbers after the wraparound");
+	check(!buffer.holds(7) && buffer.holds(8) && buffer.holds(12) && !buffer.holds(13), "held sequences");
+	check(slots_match_sequences(buffer), "sequence of every slot");
+
+	netkit::ring_buffer<int> moved(std::move(buffer));
+	check(holds_last_values(moved, pushed), "moved buffer");
+
+	moved.clear();
+	check(moved.empty() && moved.next_sequence() == 0, "cleared buffer");
+
+	netkit::ring_buffer<int> no_capacity(0);
+	check(no_capacity.empty() && no_capacity.full(), "buffer without capacity");
+
+	run_mapped_ring_buffer_tests();
+	run_mapped_novelbank_tests();
+}
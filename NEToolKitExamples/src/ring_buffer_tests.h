@@ -0,0 +1,3 @@
+#pragma once
+
+void run_ring_buffer_tests();
@@ -1,3 +1,7 @@
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
 #include <string>
 
 #include <netkit/csv/serializer.h>
@@ -11,6 +15,7 @@
 
 void print_neat_state(netkit::neat& neat);
 void rate_population(netkit::neat& neat);
+void run_genome_format_checks(const netkit::parameters& params);
 
 void run_serialization_tests() {
 	std::cout << "Starting serialization tests..." << std::endl;
@@ -193,6 +198,168 @@ void run_serialization_tests() {
 			ser.close();
 		}
 	}
+
+	run_genome_format_checks(params);
+}
+
+namespace {
+	bool near(double a, double b) {
+		return std::abs(a - b) < 1e-9;
+	}
+
+	std::string read_file(const std::string& filename) {
+		std::ifstream file(filename);
+		std::stringstream content;
+		content << file.rdbuf();
+		return content.str();
+	}
+
+	// writes the genome, reads it back and writes it again: both files must be identical.
+	template<typename T>
+	bool round_trips(const T& original, T& restored, const std::string& filename) {
+		{
+			netkit::serializer ser(filename);
+			ser << original;
+		}
+		{
+			netkit::deserializer des(filename);
+			des >> restored;
+		}
+		std::string first = read_file(filename);
+		{
+			netkit::serializer ser(filename);
+			ser << restored;
+		}
+		return first == read_file(filename);
+	}
+}
+
+void run_genome_format_checks(const netkit::parameters& params) {
+	std::cout << "\nGenome format checks:" << std::endl;
+
+	netkit::neat neat(params);
+	const std::string filename = "serialization_check.csv";
+
+	netkit::genome genome(&neat);
+	genome.add_gene(netkit::gene(neat.innov_pool.next_innovation(), netkit::genome::BIAS_ID, 4, -15));
+	genome.add_gene(netkit::gene(neat.innov_pool.next_innovation(), 1, 4, 10));
+	genome.add_gene(netkit::gene(neat.innov_pool.next_innovation(), 2, 3, 10));
+	genome.set_fitness(12.5);
+	genome.set_ranking_score(3.25);
+	genome.set_objectives({12.5, -4});
+
+	netkit::genome restored(&neat);
+	check(round_trips(genome, restored, filename), "the genome round trips");
+	check(near(restored.get_fitness(), 3.25) && near(restored.get_raw_fitness(), 12.5),
+		  "the ranking score and the raw fitness are both restored");
+	check(restored.get_objectives() == std::vector<double>({12.5, -4}), "the objectives are restored");
+
+	{
+		// the original layout: fitness and adjusted fitness, then the genes, without any version.
+		netkit::serializer ser(filename);
+		ser.append(7.5);
+		ser.append(2.5);
+		ser.new_line();
+		ser.append(genome.get_genes().size());
+		ser.new_line();
+		for (const netkit::gene& g : genome.get_genes()) {
+			ser << g;
+		}
+	}
+	netkit::genome legacy(&neat);
+	{
+		netkit::deserializer des(filename);
+		des >> legacy;
+	}
+	check(near(legacy.get_fitness(), 7.5) && near(legacy.get_raw_fitness(), 7.5)
+		  && near(legacy.get_adjusted_fitness(), 2.5) && legacy.get_genes().size() == genome.get_genes().size()
+		  && legacy.get_objectives().empty(),
+		  "the unversioned layout is still read");
+
+	// a hidden neuron whose genes have all been removed stays known, with its neuron gene.
+	netkit::parameters orphan_params = params;
+	orphan_params.hidden_activation_functions = {netkit::SIGMOID_ACTIVATION, netkit::TANH_ACTIVATION};
+	netkit::neat orphan_neat(orphan_params);
+	const netkit::neuron_id_t hidden = 4;
+	netkit::genome orphan(&orphan_neat);
+	orphan.add_gene(netkit::gene(orphan_neat.innov_pool.next_innovation(), 1, hidden, 0.5));
+	orphan.add_gene(netkit::gene(orphan_neat.innov_pool.next_innovation(), hidden, 3, -0.5));
+	orphan.set_activation(hidden, netkit::TANH_ACTIVATION);
+	orphan.set_bias(hidden, 0.25);
+	orphan.set_time_constant(hidden, 2.5);
+	orphan.set_time_constant(3, 0.75);
+	for (int attempt = 0; attempt < 100 && !orphan.get_genes().empty(); ++attempt) {
+		orphan.mutate_remove_gene();
+	}
+	netkit::genome restored_orphan(&orphan_neat);
+	bool orphan_round_trips = false;
+	try {
+		orphan_round_trips = orphan.get_genes().empty() && round_trips(orphan, restored_orphan, filename);
+	} catch (const std::exception& e) {
+		std::cout << "  " << e.what() << std::endl;
+	}
+	check(orphan_round_trips && restored_orphan.get_activation(hidden) == netkit::TANH_ACTIVATION
+		  && near(restored_orphan.get_bias(hidden), 0.25), "a hidden neuron without genes round trips");
+	check(orphan_round_trips && near(restored_orphan.get_time_constant(hidden), 2.5)
+		  && near(restored_orphan.get_time_constant(3), 0.75), "the time constants are restored");
+
+	// a whole evolution removing genes and neurons and changing the activation functions.
+	netkit::parameters evolving_params = orphan_params;
+	evolving_params.initial_population_size = 30;
+	evolving_params.mutation_probs[netkit::ADD_NEURON] = 0.2;
+	evolving_params.mutation_probs[netkit::REMOVE_GENE] = 0.3;
+	evolving_params.mutation_probs[netkit::CHANGE_ACTIVATION] = 0.2;
+	netkit::neat evolving(evolving_params);
+	evolving.rand_engine.seed(11);
+	evolving.init();
+	for (int generation = 0; generation < 40; ++generation) {
+		for (netkit::organism& org : evolving.generate_and_get_all_organisms()) {
+			org.set_fitness(1.0 + static_cast<double>(org.get_genome().get_genes().size()));
+		}
+		evolving.update_best_genome_ever();
+		evolving.epoch();
+	}
+	netkit::neat restored_neat(evolving_params);
+	bool neat_round_trips = false;
+	try {
+		neat_round_trips = round_trips(evolving, restored_neat, filename);
+	} catch (const std::exception& e) {
+		std::cout << "  " << e.what() << std::endl;
+	}
+	check(neat_round_trips, "the NEAT state round trips after 40 generations with removals");
+
+	// a phased search stuck in a pruning phase: the fitness never improves and the pruning never ends.
+	netkit::parameters phased_params = params;
+	phased_params.initial_population_size = 30;
+	phased_params.mutation_probs[netkit::ADD_NEURON] = 0.3;
+	phased_params.phased_search = true;
+	phased_params.phased_search_complexity_threshold = 1;
+	phased_params.phased_search_fitness_stall = 2;
+	phased_params.phased_search_pruning_stall = 1000;
+	netkit::neat phased(phased_params);
+	phased.rand_engine.seed(13);
+	phased.init();
+	for (int generation = 0; generation < 60 && phased.get_search_phase() != netkit::PRUNING_PHASE; ++generation) {
+		for (netkit::organism& org : phased.generate_and_get_all_organisms()) {
+			org.set_fitness(1.0);
+		}
+		phased.update_best_genome_ever();
+		phased.epoch();
+	}
+	netkit::neat restored_phased(phased_params);
+	bool phased_round_trips = false;
+	try {
+		phased_round_trips = phased.get_search_phase() == netkit::PRUNING_PHASE
+							 && round_trips(phased, restored_phased, filename);
+	} catch (const std::exception& e) {
+		std::cout << "  " << e.what() << std::endl;
+	}
+	check(phased_round_trips && restored_phased.get_search_phase() == netkit::PRUNING_PHASE
+		  && restored_phased.get_search_phase_log().size() == phased.get_search_phase_log().size(),
+		  "a restored instance keeps its search phase and its log");
+	check(phased_round_trips && near(restored_phased.params.mutation_probs[netkit::ADD_NEURON], 0)
+		  && near(restored_phased.params.mutation_probs[netkit::REMOVE_GENE], phased_params.pruning_remove_gene_prob)
+		  && near(restored_phased.params.crossover_prob, 0), "a restored instance keeps pruning");
 }
 
 void print_neat_state(netkit::neat& neat) {
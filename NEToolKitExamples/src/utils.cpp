@@ -51,6 +51,11 @@ void wait_user() {
 	std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
 }
 
+bool check(bool condition, const std::string& description) {
+	std::cout << (condition ? "  [OK] " : "  [FAILED] ") << description << std::endl;
+	return condition;
+}
+
 void print_species_stats(const netkit::species& spec) {
 	std::cout << "<species: id = " << spec.get_id() << ", age = " << spec.get_age()
 			  << ", age of last improvement = " << spec.get_age_of_last_improvement()
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <string>
+
 #include <netkit/neat/species.h>
 
 struct exp_stats {
@@ -24,6 +26,9 @@ netkit::deserializer& operator>>(netkit::deserializer& des, xor_position& xp);
 
 void wait_user();
 
+// prints the result of a check of the test drivers and returns it.
+bool check(bool condition, const std::string& description);
+
 void print_species_stats(const netkit::species& spec);
 
 double compute_standard_deviation(unsigned int number_of_values, double average, std::function<double(size_t)> getter);
@@ -11,3 +11,12 @@ endif()
 if(NETKIT_SHARED)
     set(BUILD_SHARED_LIBS 1)
 endif()
+
+# must be the same for the library and the code using it.
+if(NETKIT_WITH_TRACING)
+    add_definitions(-DNETKIT_WITH_TRACING)
+endif()
+
+if(NETKIT_WITH_OBSERVERS)
+    add_definitions(-DNETKIT_WITH_OBSERVERS)
+endif()
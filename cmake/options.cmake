@@ -2,4 +2,6 @@ option(NETKIT_SHARED           "Build library as shared library"      1)
 option(NETKIT_WITH_WARNINGS    "Show all warnings during compilation" 0)
 option(NETKIT_WITH_SUGGESTIONS "Show suggestions during compilation"  0)
 option(NETKIT_EXAMPLES         "Build examples"                       0)
-
+option(NETKIT_BENCHMARKS       "Build benchmarks"                     0)
+option(NETKIT_WITH_TRACING     "Record trace events (Chrome trace)"   0)
+option(NETKIT_WITH_OBSERVERS   "Notify observers of epoch events"     0)